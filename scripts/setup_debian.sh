@@ -8,6 +8,6 @@ echo "[artificial] Updating apt and installing base toolchain + glm + SDL2..."
 sudo apt update
 sudo apt install -y \
   build-essential cmake ninja-build pkg-config git gdb \
-  libglm-dev libsdl2-dev
+  libglm-dev libsdl2-dev zlib1g-dev
 
 echo "[artificial] Installed dependencies via apt. You should be set."
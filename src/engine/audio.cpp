@@ -6,6 +6,7 @@
 #include <cmath>
 #include <filesystem>
 #include <system_error>
+#include <vector>
 #include <SDL_mixer.h>
 
 bool init_audio() {
@@ -79,29 +80,59 @@ void load_mod_sounds(const std::string& mods_root) {
     for (auto const& mod : std::filesystem::directory_iterator(mroot, ec)) {
         if (ec) { ec.clear(); continue; }
         if (!mod.is_directory()) continue;
+        load_sounds_for_mod(mod.path());
+    }
+}
 
-        std::string modname = mod.path().filename().string();
-        auto sp = mod.path() / "sounds";
-        if (!std::filesystem::exists(sp, ec) || !std::filesystem::is_directory(sp, ec)) {
-            continue;
-        }
+void load_sounds_for_mod(const std::filesystem::path& mod_dir) {
+    std::error_code ec;
+    std::string modname = mod_dir.filename().string();
+    auto sp = mod_dir / "sounds";
+    if (!std::filesystem::exists(sp, ec) || !std::filesystem::is_directory(sp, ec)) {
+        return;
+    }
 
-        for (auto const& f : std::filesystem::directory_iterator(sp, ec)) {
-            if (ec) { ec.clear(); continue; }
-            if (!f.is_regular_file()) continue;
-
-            auto p = f.path();
-            std::string ext = p.extension().string();
-            std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
-            if (ext == ".wav" || ext == ".ogg") {
-                std::string stem = p.stem().string();
-                std::string key = modname + ":" + stem;
-                (void)load_sound(key, p.string());
-            }
+    for (auto const& f : std::filesystem::directory_iterator(sp, ec)) {
+        if (ec) { ec.clear(); continue; }
+        if (!f.is_regular_file()) continue;
+
+        auto p = f.path();
+        std::string ext = p.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
+        if (ext == ".wav" || ext == ".ogg") {
+            std::string stem = p.stem().string();
+            std::string key = modname + ":" + stem;
+            unload_sound(key);
+            (void)load_sound(key, p.string());
         }
     }
 }
 
+void unload_sound(const std::string& key) {
+    if (!aa) return;
+    auto it = aa->chunks.find(key);
+    if (it == aa->chunks.end()) return;
+    // Never free a chunk a channel is still mixing.
+    int channels = Mix_AllocateChannels(-1);
+    for (int ch = 0; ch < channels; ++ch) {
+        if (Mix_Playing(ch) && Mix_GetChunk(ch) == it->second)
+            Mix_HaltChannel(ch);
+    }
+    Mix_FreeChunk(it->second);
+    aa->chunks.erase(it);
+}
+
+void unload_sounds_with_prefix(const std::string& prefix) {
+    if (!aa) return;
+    std::vector<std::string> keys;
+    for (const auto& kv : aa->chunks) {
+        if (kv.first.compare(0, prefix.size(), prefix) == 0)
+            keys.push_back(kv.first);
+    }
+    for (const auto& key : keys)
+        unload_sound(key);
+}
+
 void load_builtin_sounds(const std::string& root) {
     if (!aa)
         return;
@@ -3,6 +3,7 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
+#include <filesystem>
 #include <string>
 #include <unordered_map>
 
@@ -26,5 +27,14 @@ void play_sound(const std::string& key, int loops = 0, int channel = -1, int vol
 // Scan mods/*/sounds for audio assets and load into global store.
 void load_mod_sounds(const std::string& mods_root = "mods");
 
+// Load `<mod_dir>/sounds` as `<folder>:<stem>` keys, replacing existing ones.
+void load_sounds_for_mod(const std::filesystem::path& mod_dir);
+
+// Free a loaded sound, halting any channel still playing it.
+void unload_sound(const std::string& key);
+
+// Free every sound whose key starts with `prefix` (e.g. "<folder>:").
+void unload_sounds_with_prefix(const std::string& prefix);
+
 // Load built-in sounds from assets/sounds directory.
 void load_builtin_sounds(const std::string& root = "assets/sounds");
@@ -0,0 +1,164 @@
+#include "engine/collision.hpp"
+
+#include "engine/collision_kernels.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(_MSC_VER) && GUB_COLLISION_SSE2
+#include <intrin.h>
+#endif
+
+namespace {
+
+using collision_internal::KernelShape;
+using collision_internal::KernelTable;
+
+constexpr KernelTable kScalarKernels = make_kernel_table<Lane1>();
+#if GUB_COLLISION_SSE2
+constexpr KernelTable kSse2Kernels = make_kernel_table<LaneSse2>();
+#endif
+
+bool cpu_has_avx2() {
+#if !GUB_COLLISION_SSE2
+    return false;
+#elif defined(_MSC_VER)
+    int regs[4] = {};
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx = (regs[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+CollisionIsa best_isa() {
+    if (collision_internal::avx2_kernel_table() && cpu_has_avx2())
+        return CollisionIsa::Avx2;
+#if GUB_COLLISION_SSE2
+    return CollisionIsa::Sse2;
+#else
+    return CollisionIsa::Scalar;
+#endif
+}
+
+const CollisionIsa g_best_isa = best_isa();
+CollisionIsa g_isa = g_best_isa;
+
+const KernelTable& kernels() {
+    switch (g_isa) {
+    case CollisionIsa::Avx2:
+        return *collision_internal::avx2_kernel_table();
+    case CollisionIsa::Sse2:
+#if GUB_COLLISION_SSE2
+        return kSse2Kernels;
+#endif
+    case CollisionIsa::Scalar:
+        break;
+    }
+    return kScalarKernels;
+}
+
+std::size_t count_hits(const std::uint64_t* mask, std::size_t count) {
+    std::size_t hits = 0;
+    for (std::size_t w = 0; w < collision_mask_words(count); ++w)
+        hits += static_cast<std::size_t>(std::popcount(mask[w]));
+    return hits;
+}
+
+} // namespace
+
+bool aabb_overlaps(glm::vec2 a_pos, glm::vec2 a_half, glm::vec2 b_pos, glm::vec2 b_half) {
+    glm::vec2 delta = glm::abs(a_pos - b_pos);
+    return delta.x <= (a_half.x + b_half.x) && delta.y <= (a_half.y + b_half.y);
+}
+
+bool circles_overlap(glm::vec2 a_pos, float a_radius, glm::vec2 b_pos, float b_radius) {
+    glm::vec2 d = b_pos - a_pos;
+    float r = a_radius + b_radius;
+    return d.x * d.x + d.y * d.y <= r * r;
+}
+
+bool circle_overlaps_aabb(glm::vec2 center, float radius, glm::vec2 box_pos, glm::vec2 box_half) {
+    float ex = std::max(std::abs(box_pos.x - center.x) - box_half.x, 0.0f);
+    float ey = std::max(std::abs(box_pos.y - center.y) - box_half.y, 0.0f);
+    return ex * ex + ey * ey <= radius * radius;
+}
+
+std::size_t aabb_vs_aabbs(glm::vec2 pos, glm::vec2 half, const AabbColumns& boxes, std::uint64_t* mask) {
+    KernelShape shape;
+    shape.x = pos.x;
+    shape.y = pos.y;
+    shape.half_x = half.x;
+    shape.half_y = half.y;
+    kernels().aabb_vs_aabbs(shape, boxes, mask);
+    return count_hits(mask, boxes.count);
+}
+
+std::size_t circle_vs_circles(glm::vec2 center, float radius, const CircleColumns& circles, std::uint64_t* mask) {
+    KernelShape shape;
+    shape.x = center.x;
+    shape.y = center.y;
+    shape.radius = radius;
+    kernels().circle_vs_circles(shape, circles, mask);
+    return count_hits(mask, circles.count);
+}
+
+std::size_t circle_vs_aabbs(glm::vec2 center, float radius, const AabbColumns& boxes, std::uint64_t* mask) {
+    KernelShape shape;
+    shape.x = center.x;
+    shape.y = center.y;
+    shape.radius = radius;
+    kernels().circle_vs_aabbs(shape, boxes, mask);
+    return count_hits(mask, boxes.count);
+}
+
+std::size_t sweep_aabb_vs_aabbs(glm::vec2 pos, glm::vec2 half, glm::vec2 delta, const AabbColumns& boxes,
+                                float* toi, std::uint64_t* mask) {
+    KernelShape shape;
+    shape.x = pos.x;
+    shape.y = pos.y;
+    shape.half_x = half.x;
+    shape.half_y = half.y;
+    shape.delta_x = delta.x;
+    shape.delta_y = delta.y;
+    kernels().sweep_aabb_vs_aabbs(shape, boxes, toi, mask);
+    return count_hits(mask, boxes.count);
+}
+
+std::size_t sweep_circle_vs_circles(glm::vec2 center, float radius, glm::vec2 delta, const CircleColumns& circles,
+                                    float* toi, std::uint64_t* mask) {
+    KernelShape shape;
+    shape.x = center.x;
+    shape.y = center.y;
+    shape.radius = radius;
+    shape.delta_x = delta.x;
+    shape.delta_y = delta.y;
+    kernels().sweep_circle_vs_circles(shape, circles, toi, mask);
+    return count_hits(mask, circles.count);
+}
+
+CollisionIsa collision_isa() {
+    return g_isa;
+}
+
+const char* collision_isa_name(CollisionIsa isa) {
+    switch (isa) {
+    case CollisionIsa::Scalar:
+        return "scalar";
+    case CollisionIsa::Sse2:
+        return "sse2";
+    case CollisionIsa::Avx2:
+        return "avx2";
+    }
+    return "";
+}
+
+void set_collision_isa_limit(CollisionIsa limit) {
+    g_isa = std::min(limit, g_best_isa);
+}
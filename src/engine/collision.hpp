@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+// Collision tests: single-shape helpers, plus batched kernels that test one
+// shape against many stored as structure-of-arrays columns (for example
+// VidSoAPool columns).
+//
+// Batch results are bit masks: bit i of mask[i / 64] is set when item i is
+// hit, and the caller provides collision_mask_words(count) words. Every
+// batch call returns its hit count. Kernels run with AVX2 (8 lanes) or SSE2
+// (4 lanes) where the CPU has them, chosen once at runtime, and with scalar
+// code otherwise. All paths use the same arithmetic, so they agree bit for bit.
+
+// Boxes as centers and half extents.
+struct AabbColumns {
+    const float* x{nullptr};
+    const float* y{nullptr};
+    const float* half_x{nullptr};
+    const float* half_y{nullptr};
+    std::size_t count{0};
+};
+
+struct CircleColumns {
+    const float* x{nullptr};
+    const float* y{nullptr};
+    const float* radius{nullptr};
+    std::size_t count{0};
+};
+
+enum class CollisionIsa : std::uint8_t {
+    Scalar,
+    Sse2,
+    Avx2,
+};
+
+// Time of impact written for items a sweep misses.
+inline constexpr float kNoHit = std::numeric_limits<float>::infinity();
+
+inline std::size_t collision_mask_words(std::size_t count) {
+    return (count + 63) / 64;
+}
+
+inline bool mask_test(const std::uint64_t* mask, std::size_t i) {
+    return (mask[i / 64] >> (i % 64)) & 1u;
+}
+
+bool aabb_overlaps(glm::vec2 a_pos, glm::vec2 a_half, glm::vec2 b_pos, glm::vec2 b_half);
+bool circles_overlap(glm::vec2 a_pos, float a_radius, glm::vec2 b_pos, float b_radius);
+bool circle_overlaps_aabb(glm::vec2 center, float radius, glm::vec2 box_pos, glm::vec2 box_half);
+
+std::size_t aabb_vs_aabbs(glm::vec2 pos, glm::vec2 half, const AabbColumns& boxes, std::uint64_t* mask);
+std::size_t circle_vs_circles(glm::vec2 center, float radius, const CircleColumns& circles, std::uint64_t* mask);
+std::size_t circle_vs_aabbs(glm::vec2 center, float radius, const AabbColumns& boxes, std::uint64_t* mask);
+
+// Sweeps move the shape from its position by `delta`. For each hit, toi[i]
+// in [0, 1] is the fraction of `delta` travelled at first contact (0 when
+// already overlapping); misses get kNoHit. `toi` has room for count floats.
+std::size_t sweep_aabb_vs_aabbs(glm::vec2 pos, glm::vec2 half, glm::vec2 delta, const AabbColumns& boxes,
+                                float* toi, std::uint64_t* mask);
+std::size_t sweep_circle_vs_circles(glm::vec2 center, float radius, glm::vec2 delta, const CircleColumns& circles,
+                                    float* toi, std::uint64_t* mask);
+
+// The instruction set the batch kernels use.
+CollisionIsa collision_isa();
+const char* collision_isa_name(CollisionIsa isa);
+// Lowers the instruction set the kernels may use, e.g. to compare paths in
+// a benchmark. Never raises it past what the CPU supports.
+void set_collision_isa_limit(CollisionIsa limit);
@@ -0,0 +1,23 @@
+// Built with AVX2 enabled (see CMakeLists.txt); collision.cpp only picks
+// these kernels after checking the CPU supports them.
+#include "engine/collision_kernels.hpp"
+
+#if defined(__AVX2__)
+
+namespace {
+
+constexpr collision_internal::KernelTable kAvx2Kernels = make_kernel_table<LaneAvx2>();
+
+} // namespace
+
+const collision_internal::KernelTable* collision_internal::avx2_kernel_table() {
+    return &kAvx2Kernels;
+}
+
+#else
+
+const collision_internal::KernelTable* collision_internal::avx2_kernel_table() {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,269 @@
+#pragma once
+
+// Batch collision kernels, written once over a "lane" type and instantiated
+// per instruction set: collision.cpp builds the scalar and SSE2 tables,
+// collision_avx2.cpp (compiled with AVX2 enabled) builds the AVX2 one.
+//
+// Everything here has internal linkage and avoids std:: helpers, so nothing
+// compiled with AVX2 can be merged into code the other paths run.
+
+#include "engine/collision.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GUB_COLLISION_SSE2 1
+#include <immintrin.h>
+#else
+#define GUB_COLLISION_SSE2 0
+#include <cmath>
+#endif
+
+namespace collision_internal {
+
+// One shape's parameters, broadcast across lanes by each kernel.
+struct KernelShape {
+    float x{0.0f};
+    float y{0.0f};
+    float half_x{0.0f};
+    float half_y{0.0f};
+    float radius{0.0f};
+    float delta_x{0.0f};
+    float delta_y{0.0f};
+};
+
+struct KernelTable {
+    void (*aabb_vs_aabbs)(const KernelShape&, const AabbColumns&, std::uint64_t*);
+    void (*circle_vs_circles)(const KernelShape&, const CircleColumns&, std::uint64_t*);
+    void (*circle_vs_aabbs)(const KernelShape&, const AabbColumns&, std::uint64_t*);
+    void (*sweep_aabb_vs_aabbs)(const KernelShape&, const AabbColumns&, float*, std::uint64_t*);
+    void (*sweep_circle_vs_circles)(const KernelShape&, const CircleColumns&, float*, std::uint64_t*);
+};
+
+// Null when the build has no AVX2 kernels (non-x86 targets).
+const KernelTable* avx2_kernel_table();
+
+} // namespace collision_internal
+
+namespace {
+
+constexpr float kLaneInf = std::numeric_limits<float>::infinity();
+
+// Lane interface: F is a vector of floats, M a per-lane mask. Comparisons are
+// ordered (false for NaN) and min/max return the second operand unless the
+// first is strictly smaller/larger, matching the SSE/AVX instructions.
+struct Lane1 {
+    static constexpr std::size_t kWidth = 1;
+    using F = float;
+    using M = bool;
+
+    static F load(const float* p) { return *p; }
+    static void store(float* p, F v) { *p = v; }
+    static F set(float v) { return v; }
+    static F add(F a, F b) { return a + b; }
+    static F sub(F a, F b) { return a - b; }
+    static F mul(F a, F b) { return a * b; }
+    static F div(F a, F b) { return a / b; }
+    static F min(F a, F b) { return a < b ? a : b; }
+    static F max(F a, F b) { return a > b ? a : b; }
+    static F abs(F a) { return a < 0.0f ? -a : a; }
+    static F sqrt(F a) {
+#if GUB_COLLISION_SSE2
+        return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(a)));
+#else
+        return std::sqrt(a);
+#endif
+    }
+    static M le(F a, F b) { return a <= b; }
+    static M gt(F a, F b) { return a > b; }
+    static M both(M a, M b) { return a && b; }
+    static M either(M a, M b) { return a || b; }
+    static F select(M m, F a, F b) { return m ? a : b; }
+    static unsigned bits(M m) { return m ? 1u : 0u; }
+};
+
+#if GUB_COLLISION_SSE2
+struct LaneSse2 {
+    static constexpr std::size_t kWidth = 4;
+    using F = __m128;
+    using M = __m128;
+
+    static F load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, F v) { _mm_storeu_ps(p, v); }
+    static F set(float v) { return _mm_set1_ps(v); }
+    static F add(F a, F b) { return _mm_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static F div(F a, F b) { return _mm_div_ps(a, b); }
+    static F min(F a, F b) { return _mm_min_ps(a, b); }
+    static F max(F a, F b) { return _mm_max_ps(a, b); }
+    static F abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static F sqrt(F a) { return _mm_sqrt_ps(a); }
+    static M le(F a, F b) { return _mm_cmple_ps(a, b); }
+    static M gt(F a, F b) { return _mm_cmpgt_ps(a, b); }
+    static M both(M a, M b) { return _mm_and_ps(a, b); }
+    static M either(M a, M b) { return _mm_or_ps(a, b); }
+    static F select(M m, F a, F b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    static unsigned bits(M m) { return static_cast<unsigned>(_mm_movemask_ps(m)); }
+};
+#endif
+
+#if defined(__AVX2__)
+struct LaneAvx2 {
+    static constexpr std::size_t kWidth = 8;
+    using F = __m256;
+    using M = __m256;
+
+    static F load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, F v) { _mm256_storeu_ps(p, v); }
+    static F set(float v) { return _mm256_set1_ps(v); }
+    static F add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F div(F a, F b) { return _mm256_div_ps(a, b); }
+    static F min(F a, F b) { return _mm256_min_ps(a, b); }
+    static F max(F a, F b) { return _mm256_max_ps(a, b); }
+    static F abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static F sqrt(F a) { return _mm256_sqrt_ps(a); }
+    static M le(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static M gt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static M both(M a, M b) { return _mm256_and_ps(a, b); }
+    static M either(M a, M b) { return _mm256_or_ps(a, b); }
+    static F select(M m, F a, F b) { return _mm256_blendv_ps(b, a, m); }
+    static unsigned bits(M m) { return static_cast<unsigned>(_mm256_movemask_ps(m)); }
+};
+#endif
+
+// Runs `test(lane, i)` over [0, count) in groups of L::kWidth, finishing
+// each 64-item word with single lanes, and packs the returned bits.
+template <typename L, typename Test>
+void fill_mask(std::size_t count, std::uint64_t* mask, const Test& test) {
+    for (std::size_t base = 0; base < count; base += 64) {
+        std::size_t end = count - base < 64 ? count : base + 64;
+        std::uint64_t word = 0;
+        std::size_t i = base;
+        for (; i + L::kWidth <= end; i += L::kWidth)
+            word |= static_cast<std::uint64_t>(test(L{}, i)) << (i - base);
+        for (; i < end; ++i)
+            word |= static_cast<std::uint64_t>(test(Lane1{}, i)) << (i - base);
+        mask[base / 64] = word;
+    }
+}
+
+template <typename L>
+void kernel_aabb_vs_aabbs(const collision_internal::KernelShape& s, const AabbColumns& b, std::uint64_t* mask) {
+    fill_mask<L>(b.count, mask, [&](auto lane, std::size_t i) {
+        using V = decltype(lane);
+        auto dx = V::abs(V::sub(V::load(b.x + i), V::set(s.x)));
+        auto dy = V::abs(V::sub(V::load(b.y + i), V::set(s.y)));
+        auto hit_x = V::le(dx, V::add(V::load(b.half_x + i), V::set(s.half_x)));
+        auto hit_y = V::le(dy, V::add(V::load(b.half_y + i), V::set(s.half_y)));
+        return V::bits(V::both(hit_x, hit_y));
+    });
+}
+
+template <typename L>
+void kernel_circle_vs_circles(const collision_internal::KernelShape& s, const CircleColumns& c, std::uint64_t* mask) {
+    fill_mask<L>(c.count, mask, [&](auto lane, std::size_t i) {
+        using V = decltype(lane);
+        auto dx = V::sub(V::load(c.x + i), V::set(s.x));
+        auto dy = V::sub(V::load(c.y + i), V::set(s.y));
+        auto r = V::add(V::load(c.radius + i), V::set(s.radius));
+        return V::bits(V::le(V::add(V::mul(dx, dx), V::mul(dy, dy)), V::mul(r, r)));
+    });
+}
+
+// Distance from the circle's center to each box, per axis, clamped at 0.
+template <typename L>
+void kernel_circle_vs_aabbs(const collision_internal::KernelShape& s, const AabbColumns& b, std::uint64_t* mask) {
+    fill_mask<L>(b.count, mask, [&](auto lane, std::size_t i) {
+        using V = decltype(lane);
+        auto zero = V::set(0.0f);
+        auto ex = V::max(V::sub(V::abs(V::sub(V::load(b.x + i), V::set(s.x))), V::load(b.half_x + i)), zero);
+        auto ey = V::max(V::sub(V::abs(V::sub(V::load(b.y + i), V::set(s.y))), V::load(b.half_y + i)), zero);
+        auto r = V::set(s.radius);
+        return V::bits(V::le(V::add(V::mul(ex, ex), V::mul(ey, ey)), V::mul(r, r)));
+    });
+}
+
+// Slab test of the moving box's center against each box grown by the moving
+// box's half extents. An axis with no motion either always overlaps or never.
+template <typename V>
+void sweep_axis(typename V::F rel, typename V::F reach, float delta, float inv_delta, typename V::F& t_enter,
+                typename V::F& t_exit) {
+    if (delta == 0.0f) {
+        auto inside = V::le(V::abs(rel), reach);
+        t_enter = V::set(-kLaneInf);
+        t_exit = V::select(inside, V::set(kLaneInf), V::set(-kLaneInf));
+        return;
+    }
+    auto inv = V::set(inv_delta);
+    auto t0 = V::mul(V::sub(rel, reach), inv);
+    auto t1 = V::mul(V::add(rel, reach), inv);
+    t_enter = V::min(t0, t1);
+    t_exit = V::max(t0, t1);
+}
+
+template <typename L>
+void kernel_sweep_aabb_vs_aabbs(const collision_internal::KernelShape& s, const AabbColumns& b, float* toi,
+                                std::uint64_t* mask) {
+    const float inv_x = s.delta_x != 0.0f ? 1.0f / s.delta_x : 0.0f;
+    const float inv_y = s.delta_y != 0.0f ? 1.0f / s.delta_y : 0.0f;
+    fill_mask<L>(b.count, mask, [&](auto lane, std::size_t i) {
+        using V = decltype(lane);
+        typename V::F enter_x, exit_x, enter_y, exit_y;
+        sweep_axis<V>(V::sub(V::load(b.x + i), V::set(s.x)), V::add(V::load(b.half_x + i), V::set(s.half_x)),
+                      s.delta_x, inv_x, enter_x, exit_x);
+        sweep_axis<V>(V::sub(V::load(b.y + i), V::set(s.y)), V::add(V::load(b.half_y + i), V::set(s.half_y)),
+                      s.delta_y, inv_y, enter_y, exit_y);
+        auto t_enter = V::max(V::max(enter_x, enter_y), V::set(0.0f));
+        auto t_exit = V::min(V::min(exit_x, exit_y), V::set(1.0f));
+        auto hit = V::le(t_enter, t_exit);
+        V::store(toi + i, V::select(hit, t_enter, V::set(kNoHit)));
+        return V::bits(hit);
+    });
+}
+
+// |m - t*d| = R with m the target's offset from the start: a t^2 - 2 b t + c = 0.
+template <typename L>
+void kernel_sweep_circle_vs_circles(const collision_internal::KernelShape& s, const CircleColumns& c, float* toi,
+                                    std::uint64_t* mask) {
+    const float a = s.delta_x * s.delta_x + s.delta_y * s.delta_y;
+    fill_mask<L>(c.count, mask, [&](auto lane, std::size_t i) {
+        using V = decltype(lane);
+        auto mx = V::sub(V::load(c.x + i), V::set(s.x));
+        auto my = V::sub(V::load(c.y + i), V::set(s.y));
+        auto r = V::add(V::load(c.radius + i), V::set(s.radius));
+        auto cc = V::sub(V::add(V::mul(mx, mx), V::mul(my, my)), V::mul(r, r));
+        auto zero = V::set(0.0f);
+        auto overlapping = V::le(cc, zero);
+        auto result = V::select(overlapping, zero, V::set(kNoHit));
+        auto hit = overlapping;
+        if (a > 0.0f) {
+            auto bb = V::add(V::mul(mx, V::set(s.delta_x)), V::mul(my, V::set(s.delta_y)));
+            auto disc = V::sub(V::mul(bb, bb), V::mul(V::set(a), cc));
+            // Lanes with disc < 0 get NaN from sqrt and fail the comparisons.
+            auto t = V::div(V::sub(bb, V::sqrt(disc)), V::set(a));
+            auto approach = V::both(V::gt(bb, zero), V::both(V::le(zero, disc), V::le(t, V::set(1.0f))));
+            result = V::select(overlapping, zero, V::select(approach, t, V::set(kNoHit)));
+            hit = V::either(overlapping, approach);
+        }
+        V::store(toi + i, result);
+        return V::bits(hit);
+    });
+}
+
+template <typename L>
+constexpr collision_internal::KernelTable make_kernel_table() {
+    return {
+        &kernel_aabb_vs_aabbs<L>,
+        &kernel_circle_vs_circles<L>,
+        &kernel_circle_vs_aabbs<L>,
+        &kernel_sweep_aabb_vs_aabbs<L>,
+        &kernel_sweep_circle_vs_circles<L>,
+    };
+}
+
+} // namespace
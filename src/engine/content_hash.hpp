@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Streaming FNV-1a (64-bit) hash used to identify mod file contents.
+// Shared by the engine and tools/mod_server so both sides agree on the
+// hex digests published in the mod catalog.
+struct ContentHasher {
+    static constexpr std::uint64_t kOffset = 1469598103934665603ULL;
+    static constexpr std::uint64_t kPrime = 1099511628211ULL;
+
+    std::uint64_t state{kOffset};
+
+    void update(const char* data, std::size_t len) {
+        std::uint64_t h = state;
+        for (std::size_t i = 0; i < len; ++i) {
+            h ^= static_cast<unsigned char>(data[i]);
+            h *= kPrime;
+        }
+        state = h;
+    }
+
+    std::uint64_t digest() const { return state; }
+};
+
+inline std::string content_hash_hex(std::uint64_t value) {
+    static constexpr char kDigits[] = "0123456789abcdef";
+    std::string out(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        out[static_cast<std::size_t>(i)] = kDigits[value & 0xF];
+        value >>= 4;
+    }
+    return out;
+}
+
+// Stream `path` through ContentHasher and return the hex digest in `out`.
+inline bool content_hash_file(const std::filesystem::path& path, std::string& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f.good())
+        return false;
+    ContentHasher hasher;
+    char buf[64 * 1024];
+    while (f) {
+        f.read(buf, sizeof(buf));
+        std::streamsize got = f.gcount();
+        if (got > 0)
+            hasher.update(buf, static_cast<std::size_t>(got));
+    }
+    out = content_hash_hex(hasher.digest());
+    return true;
+}
@@ -317,6 +317,47 @@ void rebuild_sprite_mapping(const std::vector<SpriteDef>& new_defs) {
     defs_by_id.swap(new_defs_by_id);
 }
 
+std::vector<int> upsert_sprite_defs(const std::vector<SpriteDef>& defs) {
+    std::vector<int> touched;
+    touched.reserve(defs.size());
+    for (const auto& d : defs) {
+        auto it = gg->sprite_name_to_id.find(d.name);
+        if (it != gg->sprite_name_to_id.end()) {
+            gg->sprite_defs_by_id[static_cast<size_t>(it->second)] = d;
+            touched.push_back(it->second);
+            continue;
+        }
+        int id = static_cast<int>(gg->sprite_defs_by_id.size());
+        gg->sprite_defs_by_id.push_back(d);
+        gg->sprite_id_to_name.push_back(d.name);
+        gg->sprite_name_to_id.emplace(d.name, id);
+        touched.push_back(id);
+    }
+    return touched;
+}
+
+void release_sprite_defs(const std::string& prefix, const std::vector<std::string>& keep_sorted) {
+    std::vector<int> released;
+    for (const auto& [name, id] : gg->sprite_name_to_id) {
+        if (name.compare(0, prefix.size(), prefix) != 0)
+            continue;
+        if (std::binary_search(keep_sorted.begin(), keep_sorted.end(), name))
+            continue;
+        released.push_back(id);
+    }
+    for (int id : released) {
+        size_t idx = static_cast<size_t>(id);
+        gg->sprite_name_to_id.erase(gg->sprite_id_to_name[idx]);
+        gg->sprite_id_to_name[idx].clear();
+        gg->sprite_defs_by_id[idx] = SpriteDef{};
+        auto tex = gg->textures_by_id.find(id);
+        if (tex != gg->textures_by_id.end()) {
+            if (tex->second) SDL_DestroyTexture(tex->second);
+            gg->textures_by_id.erase(tex);
+        }
+    }
+}
+
 const SpriteDef* get_sprite_def_by_id(int id) {
     if (id < 0) return nullptr;
     size_t idx = static_cast<size_t>(id);
@@ -357,6 +398,25 @@ bool load_all_textures_in_sprite_lookup() {
     return true;
 }
 
+bool load_textures_for_sprite_ids(const std::vector<int>& ids) {
+    if (!gg->renderer) return false;
+    for (int id : ids) {
+        const auto* def = get_sprite_def_by_id(id);
+        if (!def || def->image_path.empty()) continue;
+        SDL_Texture* tex = IMG_LoadTexture(gg->renderer, def->image_path.c_str());
+        if (!tex) {
+            std::fprintf(stderr, "IMG_LoadTexture failed for %s: %s\n", def->image_path.c_str(),
+                         IMG_GetError());
+            continue;
+        }
+        auto it = gg->textures_by_id.find(id);
+        if (it != gg->textures_by_id.end() && it->second)
+            SDL_DestroyTexture(it->second);
+        gg->textures_by_id[id] = tex;
+    }
+    return true;
+}
+
 SDL_Texture* get_texture(int sprite_id) {
     auto it = gg->textures_by_id.find(sprite_id);
     return (it == gg->textures_by_id.end()) ? nullptr : it->second;
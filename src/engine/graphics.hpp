@@ -96,10 +96,17 @@ int try_get_sprite_id(const std::string& name);
 
 // Sprite definitions operations
 void rebuild_sprite_mapping(const std::vector<SpriteDef>& defs);
+// Insert or replace definitions in place; other ids are untouched. Returns the
+// ids whose textures need (re)loading.
+std::vector<int> upsert_sprite_defs(const std::vector<SpriteDef>& defs);
+// Drop sprites whose name starts with `prefix` unless listed in `keep_sorted`.
+// Their ids stay reserved as empty slots so other ids do not shift.
+void release_sprite_defs(const std::string& prefix, const std::vector<std::string>& keep_sorted);
 const SpriteDef* get_sprite_def_by_id(int id);
 const SpriteDef* try_get_sprite_def(const std::string& name);
 
 // Textures operations
 void clear_textures();
 bool load_all_textures_in_sprite_lookup();
+bool load_textures_for_sprite_ids(const std::vector<int>& ids);
 SDL_Texture* get_texture(int sprite_id);
@@ -12,6 +12,7 @@ bool g_show_players = false;
 bool g_show_binds = false;
 bool g_show_layouts = false;
 bool g_show_video = false;
+bool g_show_mods = false;
 
 struct WindowToggle {
     const char* label;
@@ -25,6 +26,7 @@ constexpr WindowToggle kWindowToggles[] = {
     {"Binds", &g_show_binds, ImGuiKey_F2, "F2"},
     {"UI Layouts", &g_show_layouts, ImGuiKey_F3, "F3"},
     {"Video/Resolution", &g_show_video, ImGuiKey_F4, "F4"},
+    {"Mods", &g_show_mods, ImGuiKey_F5, "F5"},
 };
 
 bool any_window_visible() {
@@ -95,6 +97,7 @@ void imgui_debug_render() {
     imgui_debug_render_binds_window(&g_show_binds);
     imgui_debug_render_layout_window(&g_show_layouts);
     imgui_debug_render_video_window(&g_show_video);
+    imgui_debug_render_mods_window(&g_show_mods);
 }
 
 void imgui_debug_shutdown() {
@@ -104,4 +107,5 @@ void imgui_debug_shutdown() {
     g_show_binds = false;
     g_show_layouts = false;
     g_show_video = false;
+    g_show_mods = false;
 }
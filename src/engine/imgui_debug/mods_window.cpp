@@ -0,0 +1,168 @@
+#include "engine/imgui_debug/windows.hpp"
+
+#include "engine/lua_alloc.hpp"
+#include "engine/mod_host.hpp"
+#include "engine/mod_tasks.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <imgui.h>
+
+namespace {
+
+double to_kib(std::size_t bytes) {
+    return static_cast<double>(bytes) / 1024.0;
+}
+
+double to_ms(double ns) {
+    return ns / 1e6;
+}
+
+// Mods ranked by Lua time in the last frame, the smoothed average breaking ties.
+void render_cpu_table(const std::unordered_map<std::string, ModContext>& mods) {
+    std::vector<const ModContext*> ranked;
+    ranked.reserve(mods.size());
+    for (const auto& [id, ctx] : mods)
+        ranked.push_back(&ctx);
+    std::sort(ranked.begin(), ranked.end(), [](const ModContext* a, const ModContext* b) {
+        if (a->cpu.last_frame_ns != b->cpu.last_frame_ns)
+            return a->cpu.last_frame_ns > b->cpu.last_frame_ns;
+        return a->cpu.avg_frame_ns > b->cpu.avg_frame_ns;
+    });
+    ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+    if (!ImGui::BeginTable("mod_lua_cpu", 6, flags))
+        return;
+    ImGui::TableSetupColumn("Mod");
+    ImGui::TableSetupColumn("Frame ms");
+    ImGui::TableSetupColumn("Avg ms");
+    ImGui::TableSetupColumn("Total ms");
+    ImGui::TableSetupColumn("Calls");
+    ImGui::TableSetupColumn("Aborted");
+    ImGui::TableHeadersRow();
+    for (const ModContext* ctx : ranked) {
+        const ModCpuStats& cpu = ctx->cpu;
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(ctx->id.c_str());
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", to_ms(static_cast<double>(cpu.last_frame_ns)));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", to_ms(cpu.avg_frame_ns));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f", to_ms(static_cast<double>(cpu.total_ns)));
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(cpu.calls));
+        ImGui::TableNextColumn();
+        if (cpu.aborted > 0)
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%llu", static_cast<unsigned long long>(cpu.aborted));
+        else
+            ImGui::TextDisabled("0");
+    }
+    ImGui::EndTable();
+}
+
+void render_gc_table(const std::unordered_map<std::string, ModContext>& mods) {
+    ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+    if (!ImGui::BeginTable("mod_lua_gc", 6, flags))
+        return;
+    ImGui::TableSetupColumn("Mod");
+    ImGui::TableSetupColumn("Heap KiB");
+    ImGui::TableSetupColumn("Settled KiB");
+    ImGui::TableSetupColumn("Frame ms");
+    ImGui::TableSetupColumn("Total ms");
+    ImGui::TableSetupColumn("Cycles");
+    ImGui::TableHeadersRow();
+    for (const auto& [id, ctx] : mods) {
+        const ModGcStats& gc = ctx.gc;
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(id.c_str());
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f", to_kib(gc.heap_bytes));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f", to_kib(gc.settled_bytes));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", to_ms(static_cast<double>(gc.last_frame_ns)));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f", to_ms(static_cast<double>(gc.total_ns)));
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu%s", static_cast<unsigned long long>(gc.cycles), gc.in_cycle ? " *" : "");
+    }
+    ImGui::EndTable();
+}
+
+} // namespace
+
+void imgui_debug_render_mods_window(bool* open_flag) {
+    if (!open_flag || !*open_flag)
+        return;
+    if (!ImGui::Begin("Debug: Mods", open_flag)) {
+        ImGui::End();
+        return;
+    }
+
+    int limit_mib = static_cast<int>(mod_lua_memory_limit() / (1024 * 1024));
+    if (ImGui::SliderInt("Lua memory cap (MiB, 0 = off)", &limit_mib, 0, 1024))
+        set_mod_lua_memory_limit(static_cast<std::size_t>(limit_mib) * 1024 * 1024);
+
+    // Budget in thousands of instructions per engine-to-Lua call.
+    int budget_k = static_cast<int>(mod_instruction_budget() / 1000);
+    if (ImGui::InputInt("Instruction budget (k/call, 0 = off)", &budget_k, 100, 1000))
+        set_mod_instruction_budget(static_cast<std::uint64_t>(std::max(budget_k, 0)) * 1000);
+
+    int gc_us = static_cast<int>(mod_gc_budget_us());
+    if (ImGui::SliderInt("GC budget (us/frame)", &gc_us, 0, 5000))
+        set_mod_gc_budget_us(static_cast<std::uint32_t>(gc_us));
+
+    const auto& mods = active_mod_contexts();
+    if (mods.empty()) {
+        ImGui::TextUnformatted("No active mods.");
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Text("Lua tasks: %zu", mod_task_count());
+    ImGui::SeparatorText("Lua CPU");
+    render_cpu_table(mods);
+    ImGui::SeparatorText("Lua GC (* = cycle in progress)");
+    render_gc_table(mods);
+    ImGui::SeparatorText("Lua memory");
+    ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+    if (ImGui::BeginTable("mod_lua_memory", 7, flags)) {
+        ImGui::TableSetupColumn("Mod");
+        ImGui::TableSetupColumn("Live KiB");
+        ImGui::TableSetupColumn("Peak KiB");
+        ImGui::TableSetupColumn("Pooled KiB");
+        ImGui::TableSetupColumn("Live allocs");
+        ImGui::TableSetupColumn("Total allocs");
+        ImGui::TableSetupColumn("Refused");
+        ImGui::TableHeadersRow();
+        for (const auto& [id, ctx] : mods) {
+            if (!ctx.alloc)
+                continue;
+            const LuaAllocStats& stats = ctx.alloc->stats;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(id.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", to_kib(stats.bytes));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", to_kib(stats.peak_bytes));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", to_kib(stats.pooled_bytes));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(stats.live_allocs));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(stats.total_allocs));
+            ImGui::TableNextColumn();
+            if (stats.failed_allocs > 0)
+                ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%llu",
+                                   static_cast<unsigned long long>(stats.failed_allocs));
+            else
+                ImGui::TextDisabled("0");
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
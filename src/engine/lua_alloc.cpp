@@ -0,0 +1,127 @@
+#include "engine/lua_alloc.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+std::atomic<std::size_t> g_memory_limit{kDefaultModLuaMemoryLimit};
+
+// Index of the smallest class holding `size`, or -1 for malloc-sized blocks.
+int size_class(std::size_t size) {
+    for (std::size_t c = 0; c < kLuaAllocClasses.size(); ++c) {
+        if (size <= kLuaAllocClasses[c])
+            return static_cast<int>(c);
+    }
+    return -1;
+}
+
+// Carve a fresh slab into blocks of class `c` and thread them onto its list.
+bool refill(LuaAllocator& alloc, int c) {
+    void* slab = std::malloc(kLuaAllocSlabBytes);
+    if (!slab)
+        return false;
+    alloc.slabs.push_back(slab);
+    alloc.stats.pooled_bytes += kLuaAllocSlabBytes;
+    std::size_t block = kLuaAllocClasses[static_cast<std::size_t>(c)];
+    char* base = static_cast<char*>(slab);
+    void*& head = alloc.free_lists[static_cast<std::size_t>(c)];
+    for (std::size_t off = kLuaAllocSlabBytes - kLuaAllocSlabBytes % block; off >= block; off -= block) {
+        void* p = base + off - block;
+        *static_cast<void**>(p) = head;
+        head = p;
+    }
+    return true;
+}
+
+void* take(LuaAllocator& alloc, std::size_t size) {
+    int c = size_class(size);
+    if (c < 0)
+        return std::malloc(size);
+    void*& head = alloc.free_lists[static_cast<std::size_t>(c)];
+    if (!head && !refill(alloc, c))
+        return nullptr;
+    void* p = head;
+    head = *static_cast<void**>(p);
+    return p;
+}
+
+void give_back(LuaAllocator& alloc, void* ptr, std::size_t size) {
+    int c = size_class(size);
+    if (c < 0) {
+        std::free(ptr);
+        return;
+    }
+    void*& head = alloc.free_lists[static_cast<std::size_t>(c)];
+    *static_cast<void**>(ptr) = head;
+    head = ptr;
+}
+
+} // namespace
+
+LuaAllocator::~LuaAllocator() {
+    for (void* slab : slabs)
+        std::free(slab);
+}
+
+void* lua_alloc_fn(void* ud, void* ptr, std::size_t osize, std::size_t nsize) {
+    LuaAllocator& alloc = *static_cast<LuaAllocator*>(ud);
+    LuaAllocStats& stats = alloc.stats;
+    // For a new block Lua passes the object type in `osize`; nothing is held.
+    std::size_t held = ptr ? osize : 0;
+
+    if (nsize == 0) {
+        if (ptr) {
+            give_back(alloc, ptr, held);
+            stats.bytes -= held;
+            stats.live_allocs -= 1;
+        }
+        return nullptr;
+    }
+
+    std::size_t limit = g_memory_limit.load(std::memory_order_relaxed);
+    if (limit > 0 && nsize > held && stats.bytes - held + nsize > limit) {
+        stats.failed_allocs += 1;
+        return nullptr;
+    }
+
+    void* out = nullptr;
+    if (!ptr) {
+        out = take(alloc, nsize);
+    } else if (size_class(held) >= 0 && size_class(held) == size_class(nsize)) {
+        out = ptr; // same block still fits
+    } else if (size_class(held) < 0 && size_class(nsize) < 0) {
+        out = std::realloc(ptr, nsize);
+    } else {
+        // A block's class follows from the size Lua reports, so crossing
+        // classes always moves it. Lua requires shrinks to succeed; here that
+        // only fails if malloc cannot supply a fresh 16 KiB slab.
+        out = take(alloc, nsize);
+        if (out) {
+            std::memcpy(out, ptr, std::min(held, nsize));
+            give_back(alloc, ptr, held);
+        }
+    }
+    if (!out) {
+        stats.failed_allocs += 1;
+        return nullptr;
+    }
+
+    if (!ptr) {
+        stats.live_allocs += 1;
+        stats.total_allocs += 1;
+    }
+    stats.bytes = stats.bytes - held + nsize;
+    stats.peak_bytes = std::max(stats.peak_bytes, stats.bytes);
+    return out;
+}
+
+void set_mod_lua_memory_limit(std::size_t bytes) {
+    g_memory_limit.store(bytes, std::memory_order_relaxed);
+}
+
+std::size_t mod_lua_memory_limit() {
+    return g_memory_limit.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Allocator for mod Lua states (passed to `lua_newstate`).
+//
+// Each mod gets its own LuaAllocator, so no locking is needed: a Lua state is
+// only ever driven by one thread at a time. Lua's many small objects (strings,
+// tables, closures) come from per-size-class free lists carved out of fixed
+// slabs; anything bigger goes to malloc. Every allocation is counted against
+// the mod, and a request that would take it past the shared hard cap fails,
+// which Lua reports as a normal "not enough memory" error.
+
+inline constexpr std::size_t kLuaAllocSlabBytes = 16 * 1024;
+inline constexpr std::array<std::size_t, 8> kLuaAllocClasses = {16, 32, 48, 64, 96, 128, 192, 256};
+inline constexpr std::size_t kDefaultModLuaMemoryLimit = 64ull * 1024 * 1024;
+
+struct LuaAllocStats {
+    std::size_t bytes{0};        // live bytes as Lua asked for them
+    std::size_t peak_bytes{0};
+    std::size_t pooled_bytes{0}; // slab memory reserved for small objects
+    std::uint64_t live_allocs{0};
+    std::uint64_t total_allocs{0};
+    std::uint64_t failed_allocs{0}; // refused by the cap (or malloc)
+};
+
+struct LuaAllocator {
+    LuaAllocStats stats;
+    std::array<void*, kLuaAllocClasses.size()> free_lists{};
+    std::vector<void*> slabs;
+
+    LuaAllocator() = default;
+    LuaAllocator(const LuaAllocator&) = delete;
+    LuaAllocator& operator=(const LuaAllocator&) = delete;
+    ~LuaAllocator(); // only once the Lua state using it has been closed
+};
+
+// `lua_Alloc`-compatible; `ud` is the mod's LuaAllocator.
+void* lua_alloc_fn(void* ud, void* ptr, std::size_t osize, std::size_t nsize);
+
+// Hard cap on each mod state's live bytes; 0 disables it. Applies to states
+// that already exist from their next allocation on.
+void set_mod_lua_memory_limit(std::size_t bytes);
+std::size_t mod_lua_memory_limit();
@@ -0,0 +1,24 @@
+#include "engine/lua_views.hpp"
+
+#include <cstdio>
+#include <string>
+
+#include <glm/glm.hpp>
+#include <sol/sol.hpp>
+
+void bind_lua_views(sol::state& lua) {
+    lua.new_usertype<glm::vec2>("vec2",
+        "new", sol::factories([] { return glm::vec2{0.0f, 0.0f}; },
+                              [](float x, float y) { return glm::vec2{x, y}; }),
+        "x", sol::property([](const glm::vec2& v) { return v.x; }, [](glm::vec2& v, float x) { v.x = x; }),
+        "y", sol::property([](const glm::vec2& v) { return v.y; }, [](glm::vec2& v, float y) { v.y = y; }),
+        "set", [](glm::vec2& v, float x, float y) { v = glm::vec2{x, y}; },
+        "copy", [](glm::vec2& v, const glm::vec2& from) { v = from; },
+        "length", [](const glm::vec2& v) { return glm::length(v); },
+        sol::meta_function::equal_to, [](const glm::vec2& a, const glm::vec2& b) { return a == b; },
+        sol::meta_function::to_string, [](const glm::vec2& v) {
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), "vec2(%g, %g)", static_cast<double>(v.x), static_cast<double>(v.y));
+            return std::string(buf);
+        });
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "engine/vid.hpp"
+
+#include <cstdint>
+
+namespace sol {
+class state;
+}
+
+// Allocation-free views of engine data for mod Lua states.
+//
+// A binding that returns a fresh table per query churns the mod's GC when a
+// script polls every tick. Bindings built on these helpers hand back plain
+// numbers, integer handles for pool slots, or fill a `vec2` userdata the
+// script created once:
+//
+//     local pos = vec2.new()
+//     for h in api:items() do
+//         if api:item_position(h, pos) then ... end
+//     end
+
+// A VID packed into a Lua integer: version in the high bits, slot in the low
+// 32. Pool versions are bumped on acquire, so 0 is never a live handle and
+// works as "none" and as the start value for iteration.
+using LuaHandle = std::int64_t;
+
+inline LuaHandle lua_handle_from_vid(VID vid) {
+    return static_cast<LuaHandle>((static_cast<std::uint64_t>(vid.version & 0x7fffffffu) << 32) |
+                                  (static_cast<std::uint64_t>(vid.id) & 0xffffffffu));
+}
+
+inline VID vid_from_lua_handle(LuaHandle handle) {
+    VID vid;
+    vid.id = static_cast<std::size_t>(static_cast<std::uint64_t>(handle) & 0xffffffffu);
+    vid.version = static_cast<std::uint32_t>(static_cast<std::uint64_t>(handle) >> 32);
+    return vid;
+}
+
+// Registers the `vec2` usertype (a glm::vec2): `vec2.new([x, y])`, fields
+// `x`/`y`, and in-place `set`, `copy` and `length`.
+void bind_lua_views(sol::state& lua);
@@ -6,8 +6,10 @@
 #include "engine/menu/menu_screen.hpp"
 #include "engine/menu/menu_ids.hpp"
 #include "engine/alerts.hpp"
+#include "engine/mod_catalog.hpp"
 #include "engine/mod_host.hpp"
 #include "engine/mod_install.hpp"
+#include "engine/mod_jobs.hpp"
 #include "engine/mods.hpp"
 #include "game/ui_layout_ids.hpp"
 
@@ -19,7 +21,6 @@
 
 namespace {
 
-constexpr const char* kModServerUrl = "http://127.0.0.1:8787";
 constexpr int kModsPerPage = 4;
 
 MenuCommandId g_cmd_prev_page = kMenuIdInvalid;
@@ -29,7 +30,9 @@ MenuCommandId g_cmd_uninstall = kMenuIdInvalid;
 
 struct ModsScreenState {
     bool loaded = false;
-    bool busy = false;
+    bool refresh_requested = false;
+    std::uint64_t catalog_revision = 0;
+    std::uint64_t job_cursor = 0;
     std::string status{"Loading catalog..."};
     std::string page_text{"Page 0 / 0"};
     std::string search_query;
@@ -55,6 +58,16 @@ bool path_exists(const ModCatalogEntry& entry) {
 
 void update_install_flags(ModsScreenState& state) {
     for (auto& entry : state.catalog) {
+        // The folder appears as soon as a download starts; job events own
+        // the status until the job lands.
+        if (mod_job_pending(entry.id)) {
+            entry.installing = !entry.uninstalling;
+            if (entry.status_text.empty())
+                entry.status_text = "Queued";
+            continue;
+        }
+        entry.installing = false;
+        entry.uninstalling = false;
         if (entry.required) {
             entry.installed = true;
             entry.status_text = "Core";
@@ -239,22 +252,78 @@ void rebuild_filter(ModsScreenState& state) {
     state.page_text = "Page " + std::to_string(state.page + 1) + " / " + std::to_string(max_page + 1);
 }
 
-bool ensure_catalog_loaded(ModsScreenState& state) {
-    if (state.loaded || state.busy)
-        return true;
-    state.busy = true;
-    std::string err;
-    if (!fetch_mod_catalog(kModServerUrl, state.catalog, err)) {
-        state.status = err.empty() ? "Failed to fetch catalog" : err;
-        state.busy = false;
-        return false;
+// Pulls the shared catalog snapshot; never touches the network itself.
+// The first call kicks a background refresh, later frames pick it up.
+void sync_catalog(ModsScreenState& state) {
+    if (!state.refresh_requested) {
+        request_mod_catalog_refresh();
+        state.refresh_requested = true;
+        state.job_cursor = mod_job_events_head();
+    }
+    // Swapping the catalog mid-install would drop the per-entry job state.
+    if (state.loaded && !mod_jobs_idle())
+        return;
+    if (poll_mod_catalog(state.catalog_revision, state.catalog)) {
+        update_install_flags(state);
+        rebuild_filter(state);
+        state.status = "Catalog loaded";
+        state.loaded = true;
+        return;
+    }
+    if (state.loaded)
+        return;
+    ModCatalogStatus status = mod_catalog_status();
+    if (status.refreshing)
+        state.status = "Loading catalog...";
+    else if (!status.error.empty())
+        state.status = status.error;
+}
+
+std::string progress_text(const ModJobEvent& ev) {
+    const char* verb = ev.kind == ModJobKind::Install ? "Installing" : "Removing";
+    if (ev.bytes_total == 0)
+        return std::string(verb) + "...";
+    std::uint64_t pct = std::min<std::uint64_t>(100, ev.bytes_done * 100 / ev.bytes_total);
+    return std::string(verb) + " " + std::to_string(pct) + "%";
+}
+
+// Applies install/uninstall job events to the matching catalog entries.
+void apply_job_events(ModsScreenState& state) {
+    ModJobEvent ev;
+    bool landed = false;
+    while (next_mod_job_event(state.job_cursor, ev)) {
+        int idx = find_entry_index(state, ev.mod_id);
+        if (idx < 0)
+            continue;
+        ModCatalogEntry& entry = state.catalog[static_cast<std::size_t>(idx)];
+        bool install = ev.kind == ModJobKind::Install;
+        switch (ev.stage) {
+        case ModJobStage::Queued:
+            entry.status_text = "Queued";
+            break;
+        case ModJobStage::Downloading:
+            entry.status_text = progress_text(ev);
+            break;
+        case ModJobStage::Committing:
+            entry.status_text = install ? "Installing..." : "Removing...";
+            break;
+        case ModJobStage::Done:
+            entry.status_text.clear();
+            state.status = install ? "Installed " + entry.title : "Removed " + entry.title;
+            landed = true;
+            break;
+        case ModJobStage::Failed:
+            entry.status_text = install ? "Install failed" : "Remove failed";
+            state.status = ev.message.empty() ? entry.status_text : ev.message;
+            add_alert(state.status);
+            landed = true;
+            break;
+        }
+    }
+    if (landed) {
+        update_install_flags(state);
+        recalc_page_text(state);
     }
-    update_install_flags(state);
-    rebuild_filter(state);
-    state.status = "Catalog loaded";
-    state.loaded = true;
-    state.busy = false;
-    return true;
 }
 
 bool install_recursive(ModsScreenState& state,
@@ -266,7 +335,7 @@ bool install_recursive(ModsScreenState& state,
     ModCatalogEntry& entry = state.catalog[static_cast<std::size_t>(catalog_idx)];
     if (entry.required)
         return true;
-    if (entry.installed)
+    if (entry.installed || entry.installing)
         return true;
     if (visiting.count(entry.id)) {
         err = "Dependency cycle detected";
@@ -285,12 +354,12 @@ bool install_recursive(ModsScreenState& state,
             return false;
         }
     }
-    entry.status_text = "Installing...";
-    bool ok = install_mod_from_catalog(kModServerUrl, entry, err);
-    entry.installed = ok;
-    entry.status_text = ok ? "Installed" : "Install failed";
+    // Dependencies were queued first and the job worker runs in order.
+    queue_mod_install(kModServerUrl, entry);
+    entry.installing = true;
+    entry.status_text = "Queued";
     visiting.erase(entry.id);
-    return ok;
+    return true;
 }
 
 bool uninstall_with_checks(ModsScreenState& state, int catalog_idx, std::string& err) {
@@ -309,13 +378,13 @@ bool uninstall_with_checks(ModsScreenState& state, int catalog_idx, std::string&
             return false;
         }
     }
-    entry.status_text = "Removing...";
-    if (!uninstall_mod(entry, err)) {
-        entry.status_text = "Remove failed";
+    if (entry.installing || entry.uninstalling) {
+        err = "Busy with " + entry.title;
         return false;
     }
-    entry.installed = false;
-    entry.status_text = "Not installed";
+    queue_mod_uninstall(entry);
+    entry.uninstalling = true;
+    entry.status_text = "Queued";
     return true;
 }
 
@@ -338,35 +407,22 @@ void command_next(MenuContext& ctx, std::int32_t) {
 
 void command_install(MenuContext& ctx, std::int32_t payload) {
     auto& state = ctx.state<ModsScreenState>();
-    if (state.busy)
-        return;
-    state.busy = true;
     std::string err;
     std::unordered_set<std::string> visiting;
-    if (!install_recursive(state, payload, visiting, err)) {
+    if (!install_recursive(state, payload, visiting, err))
         state.status = err.empty() ? "Install failed" : err;
-    } else {
-        state.status = "Installed mod";
-    }
-    update_install_flags(state);
-    recalc_page_text(state);
-    state.busy = false;
+    else
+        state.status = "Installing mod...";
 }
 
 void command_uninstall(MenuContext& ctx, std::int32_t payload) {
     auto& state = ctx.state<ModsScreenState>();
-    if (state.busy)
-        return;
-    state.busy = true;
     std::string err;
     if (!uninstall_with_checks(state, payload, err)) {
         state.status = err.empty() ? "Uninstall failed" : err;
         add_alert(state.status);
     } else
-        state.status = "Removed mod";
-    update_install_flags(state);
-    recalc_page_text(state);
-    state.busy = false;
+        state.status = "Removing mod...";
 }
 
 BuiltScreen build_mods_screen(MenuContext& ctx) {
@@ -376,9 +432,8 @@ BuiltScreen build_mods_screen(MenuContext& ctx) {
     widgets.clear();
     frame_actions.clear();
 
-    if (!ensure_catalog_loaded(state)) {
-        state.loaded = false;
-    }
+    sync_catalog(state);
+    apply_job_events(state);
 
     if (state.search_query != state.prev_search) {
         state.prev_search = state.search_query;
@@ -481,8 +536,9 @@ BuiltScreen build_mods_screen(MenuContext& ctx) {
         bool version_ok = version_compatible(entry);
         std::vector<std::string> dependents = installed_dependents(state, entry.id);
         bool has_dependents = !dependents.empty();
-        bool can_install = !entry.installed && version_ok;
-        bool can_uninstall = entry.installed && !entry.required;
+        bool job_running = entry.installing || entry.uninstalling;
+        bool can_install = !job_running && !entry.installed && version_ok;
+        bool can_uninstall = !job_running && entry.installed && !entry.required;
         bool interactive = can_install || can_uninstall;
         if (interactive)
             card.on_select = MenuAction::run_command(can_install ? g_cmd_install : g_cmd_uninstall,
@@ -10,6 +10,8 @@ class state;
 }
 
 struct ModContext;
+struct ModStateReader;
+struct ModStateWriter;
 
 struct ModApiDescriptor {
     std::string name;
@@ -17,8 +19,10 @@ struct ModApiDescriptor {
     std::function<void(ModContext&)> on_mod_loaded;
     std::function<void(ModContext&)> on_mod_unloaded;
     std::function<void(ModContext&)> on_mod_reloaded;
-    std::function<void(ModContext&)> save_mod_state;
-    std::function<void(ModContext&)> load_mod_state;
+    // Hot reload keeps what `save_mod_state` writes and hands it back to
+    // `load_mod_state` once the mod is active again (engine/mod_state.hpp).
+    std::function<void(ModContext&, ModStateWriter&)> save_mod_state;
+    std::function<void(ModContext&, ModStateReader&)> load_mod_state;
 };
 
 class ModApiRegistry {
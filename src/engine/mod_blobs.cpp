@@ -0,0 +1,166 @@
+#include "engine/mod_blobs.hpp"
+
+#include "engine/data.hpp"
+#include "engine/sha256.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* kBlobDirName = "mod_blobs";
+constexpr const char* kBlobTmpSuffix = ".blob.part";
+
+fs::path blob_root() {
+    return fs::path(DATA_FOLDER_PATH) / kBlobDirName;
+}
+
+constexpr std::size_t kSha256HexLen = 64;
+
+// Keys come from the server and end up in paths; accept SHA-256 hex only.
+bool hash_is_valid(const std::string& hash) {
+    if (hash.size() != kSha256HexLen)
+        return false;
+    return std::all_of(hash.begin(), hash.end(), [](char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+    });
+}
+
+bool blob_matches(const fs::path& blob, const std::string& hash, std::uint64_t size_bytes) {
+    std::error_code ec;
+    std::uintmax_t size = fs::file_size(blob, ec);
+    if (ec || (size_bytes > 0 && size != size_bytes))
+        return false;
+    std::string actual;
+    return sha256_file(blob, actual) && actual == hash;
+}
+
+bool same_file(const fs::path& a, const fs::path& b) {
+    std::error_code ec;
+    return fs::equivalent(a, b, ec) && !ec;
+}
+
+// Every link to a blob shares its inode with the store and with every other
+// mod holding the same content, so an in-place write through any of them
+// would change all of them. Installs always replace files by rename, which
+// leaves the shared inode alone; taking the write bits away stops everything
+// else (editors, scripts) from writing through a link.
+void make_read_only(const fs::path& path) {
+    std::error_code ec;
+    fs::permissions(path, fs::perms::owner_write | fs::perms::group_write | fs::perms::others_write,
+                    fs::perm_options::remove, ec);
+}
+
+// Swap `dest` for a link to `blob` without ever leaving it missing. There is
+// no copy fallback: a copy would double the disk use the store exists to
+// save, and prune_mod_blobs could not tell it is still in use.
+bool place_blob(const fs::path& blob, const fs::path& dest) {
+    fs::path tmp = dest;
+    tmp += kBlobTmpSuffix;
+    std::error_code ec;
+    fs::remove(tmp, ec);
+    ec.clear();
+    fs::create_hard_link(blob, tmp, ec);
+    if (ec)
+        return false;
+    fs::rename(tmp, dest, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+fs::path mod_blob_path(const std::string& hash) {
+    return blob_root() / hash.substr(0, 2) / hash;
+}
+
+bool has_mod_blob(const std::string& hash) {
+    std::error_code ec;
+    return hash_is_valid(hash) && fs::is_regular_file(mod_blob_path(hash), ec);
+}
+
+bool link_mod_blob(const std::string& hash, std::uint64_t size_bytes, const fs::path& dest) {
+    if (!has_mod_blob(hash))
+        return false;
+    fs::path blob = mod_blob_path(hash);
+    if (!blob_matches(blob, hash, size_bytes)) {
+        std::printf("[mods] Dropping damaged blob %s\n", hash.c_str());
+        std::error_code ec;
+        fs::remove(blob, ec);
+        return false;
+    }
+    // Blobs stored before links were made read-only may still be writable.
+    make_read_only(blob);
+    if (same_file(blob, dest))
+        return true;
+    return place_blob(blob, dest);
+}
+
+void store_mod_blob(const fs::path& file) {
+    std::string hash;
+    if (!sha256_file(file, hash))
+        return;
+    fs::path blob = mod_blob_path(hash);
+    std::error_code ec;
+    if (fs::exists(blob, ec)) {
+        if (same_file(blob, file))
+            return;
+        std::uintmax_t size = fs::file_size(file, ec);
+        if (!ec && blob_matches(blob, hash, static_cast<std::uint64_t>(size))) {
+            place_blob(blob, file);
+            return;
+        }
+        fs::remove(blob, ec);
+    }
+    ec.clear();
+    fs::create_directories(blob.parent_path(), ec);
+    ec.clear();
+    // Without hardlinks (e.g. the store and the mods root on different
+    // volumes) the file is simply not stored; installs then download as usual.
+    fs::create_hard_link(file, blob, ec);
+    if (ec)
+        return;
+    make_read_only(blob);
+}
+
+std::uint64_t prune_mod_blobs(std::uint64_t keep_bytes) {
+    struct Unlinked {
+        fs::path path;
+        std::uint64_t size;
+        fs::file_time_type time;
+    };
+    std::vector<Unlinked> unlinked;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(blob_root(), ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code file_ec;
+        if (!it->is_regular_file(file_ec))
+            continue;
+        if (fs::hard_link_count(it->path(), file_ec) > 1 || file_ec)
+            continue;
+        std::uintmax_t size = fs::file_size(it->path(), file_ec);
+        fs::file_time_type time = fs::last_write_time(it->path(), file_ec);
+        if (!file_ec)
+            unlinked.push_back({it->path(), static_cast<std::uint64_t>(size), time});
+    }
+    ec.clear();
+    // Newest first: recently used content is the likeliest to come back.
+    std::sort(unlinked.begin(), unlinked.end(),
+              [](const Unlinked& a, const Unlinked& b) { return a.time > b.time; });
+    std::uint64_t kept = 0;
+    std::uint64_t freed = 0;
+    for (const auto& blob : unlinked) {
+        if (kept + blob.size <= keep_bytes) {
+            kept += blob.size;
+            continue;
+        }
+        if (fs::remove(blob.path, ec))
+            freed += blob.size;
+    }
+    return freed;
+}
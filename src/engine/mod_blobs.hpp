@@ -0,0 +1,35 @@
+// Mod blob store.
+// Responsibility: keep one copy of every installed mod file under
+// `data/mod_blobs/<hh>/<sha256>`, keyed by the SHA-256 of its content, and
+// materialize mod folders from it with hardlinks. Where links are unsupported
+// nothing is stored and installs download as before. Blobs outlive the mods
+// that used them, so reinstalls and version switches that reuse content need
+// no download. Files from different mods end up sharing one inode, so linked
+// files are made read-only, and keys are never trusted as-is: every blob is
+// re-hashed with SHA-256 before it is linked anywhere. Safe to call from the
+// install worker.
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// `sha256` is a lowercase hex digest; anything else has no blob.
+std::filesystem::path mod_blob_path(const std::string& sha256);
+
+bool has_mod_blob(const std::string& sha256);
+
+// Place the blob for `sha256` at `dest`, replacing whatever is there. The
+// blob's SHA-256 is checked first; a damaged, tampered or wrongly sized blob
+// is deleted and false is returned so the caller downloads the file instead.
+bool link_mod_blob(const std::string& sha256, std::uint64_t size_bytes, const std::filesystem::path& dest);
+
+// Record an installed file under the SHA-256 of its own bytes by linking it
+// into the store (which makes it read-only). If the store already holds that
+// content, `file` is swapped for a link to it so duplicates across mods share
+// one copy on disk.
+void store_mod_blob(const std::filesystem::path& file);
+
+// Delete blobs no installed mod links to, oldest first, until the unlinked
+// ones fit in `keep_bytes`. Returns the number of bytes freed.
+std::uint64_t prune_mod_blobs(std::uint64_t keep_bytes);
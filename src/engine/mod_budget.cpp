@@ -0,0 +1,90 @@
+#include "engine/mod_budget.hpp"
+
+#include "engine/mod_host.hpp"
+
+#include <atomic>
+#include <chrono>
+
+#include <lua.hpp>
+#include <sol/sol.hpp>
+
+namespace {
+
+constexpr int kHookInterval = 1000; // instructions between budget checks
+
+std::atomic<std::uint64_t> g_instruction_budget{0};
+
+// Innermost scope on this thread. Activation runs mods on several threads at
+// once, each with its own chain.
+thread_local ModCallScope* t_scope = nullptr;
+
+std::uint64_t now_ns() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+// Coroutines run on their own lua_State and inherit the hook, so compare
+// main threads to know whether the hook fired inside the current scope.
+lua_State* main_thread(lua_State* L) {
+    lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_MAINTHREAD);
+    lua_State* main = lua_tothread(L, -1);
+    lua_pop(L, 1);
+    return main;
+}
+
+void count_hook(lua_State* L, lua_Debug*) {
+    ModCallScope* scope = t_scope;
+    if (!scope || main_thread(L) != scope->main)
+        return;
+    scope->instructions += kHookInterval;
+    std::uint64_t budget = g_instruction_budget.load(std::memory_order_relaxed);
+    if (budget == 0 || scope->instructions <= budget)
+        return;
+    scope->over_budget = true;
+    luaL_error(L, "mod '%s' exceeded its instruction budget (%llu per call)", scope->ctx->id.c_str(),
+               static_cast<unsigned long long>(budget));
+}
+
+} // namespace
+
+ModCallScope::ModCallScope(ModContext& mod, lua_State* coroutine) : ctx(&mod), outer(t_scope) {
+    main = ctx->lua ? ctx->lua->lua_state() : nullptr;
+    // Hooks are per Lua thread, and a coroutine only copies the one its
+    // creator had at the time, so a resumed coroutine is armed explicitly.
+    thread = coroutine != main ? coroutine : nullptr;
+    // A mod calling back into itself is already being timed by the outer scope.
+    timed = !(outer && outer->ctx == ctx);
+    start_ns = now_ns();
+    t_scope = this;
+    if (main && g_instruction_budget.load(std::memory_order_relaxed) > 0) {
+        lua_sethook(main, count_hook, LUA_MASKCOUNT, kHookInterval);
+        if (thread)
+            lua_sethook(thread, count_hook, LUA_MASKCOUNT, kHookInterval);
+    }
+}
+
+ModCallScope::~ModCallScope() {
+    t_scope = outer;
+    if (main && !(outer && outer->main == main))
+        lua_sethook(main, nullptr, 0, 0);
+    if (thread)
+        lua_sethook(thread, nullptr, 0, 0);
+    ModCpuStats& cpu = ctx->cpu;
+    cpu.calls += 1;
+    if (over_budget)
+        cpu.aborted += 1;
+    if (timed) {
+        std::uint64_t elapsed = now_ns() - start_ns;
+        cpu.frame_ns += elapsed;
+        cpu.total_ns += elapsed;
+    }
+}
+
+void set_mod_instruction_budget(std::uint64_t per_call) {
+    g_instruction_budget.store(per_call, std::memory_order_relaxed);
+}
+
+std::uint64_t mod_instruction_budget() {
+    return g_instruction_budget.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+struct ModContext;
+struct lua_State;
+
+// Per-mod CPU accounting for engine-to-Lua calls.
+//
+// Wrap every call into a mod's Lua state in a ModCallScope: it adds the
+// wall time to the mod's ModCpuStats and, when an instruction budget is set,
+// arms a count hook that aborts the call with a Lua error once it has run
+// more than the budget. Scripts see that error like any other, so a runaway
+// `on_use` fails alone instead of freezing the frame.
+
+struct ModCpuStats {
+    std::uint64_t frame_ns{0};      // this frame so far
+    std::uint64_t last_frame_ns{0}; // the previous full frame
+    double avg_frame_ns{0.0};       // smoothed over recent frames
+    std::uint64_t total_ns{0};
+    std::uint64_t calls{0};
+    std::uint64_t aborted{0}; // calls stopped by the instruction budget
+};
+
+struct ModCallScope {
+    ModContext* ctx{nullptr};
+    lua_State* main{nullptr};
+    lua_State* thread{nullptr}; // a coroutine being resumed, hooked alongside `main`
+    ModCallScope* outer{nullptr};
+    std::uint64_t start_ns{0};
+    std::uint64_t instructions{0};
+    bool timed{false};
+    bool over_budget{false};
+
+    explicit ModCallScope(ModContext& mod, lua_State* coroutine = nullptr);
+    ~ModCallScope();
+    ModCallScope(const ModCallScope&) = delete;
+    ModCallScope& operator=(const ModCallScope&) = delete;
+};
+
+// Instructions one call may run before it is aborted; 0 disables the hook.
+void set_mod_instruction_budget(std::uint64_t per_call);
+std::uint64_t mod_instruction_budget();
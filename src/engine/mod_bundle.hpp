@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Wire format for `/mods/bundle/<id>`: one zlib stream wrapping
+//
+//   "GUBB" u32 version
+//   repeat { u32 path_len, path bytes, u64 size, u64 hash, size bytes }
+//   u32 0 (terminator)
+//
+// Integers are little-endian. `hash` is the ContentHasher digest of the file
+// bytes. Shared by tools/mod_server (writer) and mod_install.cpp (reader).
+
+inline constexpr char kModBundleMagic[4] = {'G', 'U', 'B', 'B'};
+inline constexpr std::uint32_t kModBundleVersion = 1;
+inline constexpr std::uint32_t kModBundleMaxPath = 4096;
+inline constexpr std::size_t kModBundleHeaderBytes = 8;
+inline constexpr std::size_t kModBundleEntryTailBytes = 16; // size + hash
+
+inline void bundle_put_u32(std::string& out, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i)
+        out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+inline void bundle_put_u64(std::string& out, std::uint64_t v) {
+    for (int i = 0; i < 8; ++i)
+        out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+inline std::uint32_t bundle_get_u32(const char* p) {
+    std::uint32_t v = 0;
+    for (int i = 3; i >= 0; --i)
+        v = (v << 8) | static_cast<unsigned char>(p[i]);
+    return v;
+}
+
+inline std::uint64_t bundle_get_u64(const char* p) {
+    std::uint64_t v = 0;
+    for (int i = 7; i >= 0; --i)
+        v = (v << 8) | static_cast<unsigned char>(p[i]);
+    return v;
+}
+
+// Rejects absolute paths and any `..` component so bundle entries cannot
+// escape the mod folder they are unpacked into.
+inline bool bundle_path_is_safe(const std::string& path) {
+    if (path.empty() || path.front() == '/' || path.front() == '\\')
+        return false;
+    if (path.find(':') != std::string::npos || path.find('\\') != std::string::npos)
+        return false;
+    std::size_t start = 0;
+    while (start <= path.size()) {
+        std::size_t end = path.find('/', start);
+        if (end == std::string::npos)
+            end = path.size();
+        std::string part = path.substr(start, end - start);
+        if (part.empty() || part == "." || part == "..")
+            return false;
+        start = end + 1;
+    }
+    return true;
+}
@@ -0,0 +1,154 @@
+#include "engine/mod_catalog.hpp"
+
+#include "engine/data.hpp"
+#include "engine/mod_install.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// First line is the ETag the body was served with, the rest is the catalog
+// JSON. Keeping both in one file means a single rename replaces them together.
+constexpr const char* kCatalogCacheName = "mod_catalog.cache";
+
+fs::path catalog_cache_path() {
+    return fs::path(DATA_FOLDER_PATH) / kCatalogCacheName;
+}
+
+using Entries = std::vector<ModCatalogEntry>;
+
+struct CatalogCache {
+    std::mutex mutex;
+    std::shared_ptr<const Entries> entries;
+    ModCatalogStatus status;
+    std::string etag;
+    bool disk_loaded{false};
+    std::thread worker;
+};
+
+CatalogCache g_cache;
+
+std::string read_text_file(const fs::path& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f.good())
+        return {};
+    return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+void write_disk_cache(const std::string& body, const std::string& etag) {
+    std::error_code ec;
+    const fs::path path = catalog_cache_path();
+    fs::create_directories(path.parent_path(), ec);
+    fs::path tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out << etag << '\n' << body;
+        if (!out.good()) {
+            std::printf("[mods] Failed to write %s\n", tmp.string().c_str());
+            return;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec)
+        std::printf("[mods] Failed to replace %s: %s\n", path.string().c_str(), ec.message().c_str());
+}
+
+// Caller holds g_cache.mutex.
+void publish_locked(Entries entries) {
+    g_cache.entries = std::make_shared<const Entries>(std::move(entries));
+    g_cache.status.revision += 1;
+    g_cache.status.loaded = true;
+}
+
+// Runs on the worker, so the UI thread never reads or parses the file.
+// Returns the ETag to revalidate with, empty if there is no usable cache.
+std::string load_disk_cache() {
+    std::string text = read_text_file(catalog_cache_path());
+    std::size_t newline = text.find('\n');
+    if (newline == std::string::npos)
+        return {};
+    Entries entries;
+    std::string err;
+    if (!parse_mod_catalog(text.substr(newline + 1), entries, err)) {
+        std::printf("[mods] Ignoring cached catalog: %s\n", err.c_str());
+        return {};
+    }
+    std::string etag = text.substr(0, newline);
+    std::lock_guard<std::mutex> lock(g_cache.mutex);
+    g_cache.etag = etag;
+    publish_locked(std::move(entries));
+    return etag;
+}
+
+void refresh_worker(bool load_disk, std::string etag) {
+    if (load_disk)
+        etag = load_disk_cache();
+
+    ModCatalogFetch fetch;
+    std::string err;
+    bool ok = fetch_mod_catalog_if_changed(kModServerUrl, etag, fetch, err);
+    if (ok && !fetch.not_modified)
+        write_disk_cache(fetch.body, fetch.etag);
+
+    std::lock_guard<std::mutex> lock(g_cache.mutex);
+    g_cache.status.refreshing = false;
+    g_cache.status.fresh = ok;
+    g_cache.status.error = ok ? std::string() : err;
+    if (!ok || fetch.not_modified)
+        return;
+    g_cache.etag = fetch.etag;
+    publish_locked(std::move(fetch.entries));
+}
+
+} // namespace
+
+void request_mod_catalog_refresh() {
+    std::lock_guard<std::mutex> lock(g_cache.mutex);
+    if (g_cache.status.refreshing)
+        return;
+    // The previous worker has already cleared `refreshing`, so this join
+    // returns immediately.
+    if (g_cache.worker.joinable())
+        g_cache.worker.join();
+    const bool load_disk = !g_cache.disk_loaded;
+    g_cache.disk_loaded = true;
+    g_cache.status.refreshing = true;
+    g_cache.worker = std::thread(refresh_worker, load_disk, g_cache.etag);
+}
+
+ModCatalogStatus mod_catalog_status() {
+    std::lock_guard<std::mutex> lock(g_cache.mutex);
+    return g_cache.status;
+}
+
+bool poll_mod_catalog(std::uint64_t& known_revision, std::vector<ModCatalogEntry>& out) {
+    std::shared_ptr<const Entries> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(g_cache.mutex);
+        if (g_cache.status.revision == known_revision || !g_cache.entries)
+            return false;
+        snapshot = g_cache.entries;
+        known_revision = g_cache.status.revision;
+    }
+    out = *snapshot;
+    return true;
+}
+
+void shutdown_mod_catalog() {
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(g_cache.mutex);
+        worker = std::move(g_cache.worker);
+    }
+    if (worker.joinable())
+        worker.join();
+}
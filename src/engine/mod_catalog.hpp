@@ -0,0 +1,35 @@
+// Mod catalog cache.
+// Responsibility: one shared, disk-backed copy of the server catalog that UI
+// code reads without blocking; refreshes run on a worker thread and use the
+// server's ETag so unchanged catalogs cost a 304.
+#pragma once
+
+#include "engine/mods.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+inline constexpr const char* kModServerUrl = "http://127.0.0.1:8787";
+
+struct ModCatalogStatus {
+    std::uint64_t revision{0}; // bumps whenever the cached entries change
+    bool loaded{false};        // a catalog (disk or network) is available
+    bool refreshing{false};    // a background refresh is in flight
+    bool fresh{false};         // the last refresh reached the server
+    std::string error;         // last refresh error, empty on success
+};
+
+// Start a background refresh unless one is already running. The first
+// refresh loads the disk cache before going to the network, so a snapshot
+// is available without waiting for the server.
+void request_mod_catalog_refresh();
+
+ModCatalogStatus mod_catalog_status();
+
+// Copy the cached entries into `out` if they changed since `known_revision`.
+// Returns true and updates `known_revision` when a copy was made.
+bool poll_mod_catalog(std::uint64_t& known_revision, std::vector<ModCatalogEntry>& out);
+
+// Wait for the worker thread; called on shutdown.
+void shutdown_mod_catalog();
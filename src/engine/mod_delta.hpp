@@ -0,0 +1,28 @@
+#pragma once
+
+#include "engine/mod_bundle.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// Wire format for `/mods/delta/<id>/<base_hash>/<path>`: an rsync-style
+// patch that rebuilds the current file from an older version the client
+// already holds.
+//
+//   "GUBD" u32 version u64 base_size u64 base_hash u64 target_size u64 target_hash
+//   repeat { u8 op, ... }
+//     op 1 (copy):    u64 base_offset, u32 len   -- bytes taken from the base file
+//     op 2 (literal): u32 len, len bytes          -- bytes carried in the patch
+//   u8 0 (end)
+//
+// Integers are little-endian (bundle_put_*/bundle_get_*). Hashes are
+// ContentHasher digests. Shared by tools/mod_server (writer) and
+// mod_install.cpp (reader).
+
+inline constexpr char kModDeltaMagic[4] = {'G', 'U', 'B', 'D'};
+inline constexpr std::uint32_t kModDeltaVersion = 1;
+inline constexpr std::size_t kModDeltaHeaderBytes = 40;
+inline constexpr std::uint8_t kModDeltaOpEnd = 0;
+inline constexpr std::uint8_t kModDeltaOpCopy = 1;
+inline constexpr std::uint8_t kModDeltaOpLiteral = 2;
+inline constexpr std::size_t kModDeltaCopyArgBytes = 12;
@@ -0,0 +1,132 @@
+#include "engine/mod_events.hpp"
+
+#include "engine/mod_host.hpp"
+#include "engine/mod_tasks.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+#include <sol/sol.hpp>
+
+namespace {
+
+struct ModEventSubscriber {
+    std::string mod_id;
+    sol::protected_function fn;
+};
+
+ModEventQueue g_pending;
+// The batch being dispatched; events pushed meanwhile wait in g_pending.
+ModEventQueue g_dispatching;
+std::vector<std::function<void(const ModEventQueue&)>> g_sinks;
+// In subscription order. Subscriptions made while a mod activates are
+// replayed in mod order, so this is load order.
+std::vector<ModEventSubscriber> g_subscribers;
+
+// Lua indices are 1-based; out-of-range reads return zeros.
+bool in_batch(const ModEventQueue& q, std::size_t i) {
+    return i >= 1 && i <= q.size();
+}
+
+} // namespace
+
+void ModEventQueue::clear() {
+    kind.clear();
+    player.clear();
+    subject.clear();
+    x.clear();
+    y.clear();
+}
+
+const char* mod_event_name(ModEventType kind) {
+    switch (kind) {
+    case ModEventType::ItemUsed:
+        return "item_used";
+    case ModEventType::Bonk:
+        return "bonk";
+    case ModEventType::Collision:
+        return "collision";
+    }
+    return "";
+}
+
+void push_mod_event(ModEventType kind, int player, LuaHandle subject, glm::vec2 pos) {
+    g_pending.kind.push_back(kind);
+    g_pending.player.push_back(player);
+    g_pending.subject.push_back(subject);
+    g_pending.x.push_back(pos.x);
+    g_pending.y.push_back(pos.y);
+}
+
+void add_mod_event_sink(std::function<void(const ModEventQueue&)> sink) {
+    g_sinks.push_back(std::move(sink));
+}
+
+void dispatch_mod_events() {
+    if (g_pending.empty())
+        return;
+    std::swap(g_pending, g_dispatching);
+    const ModEventQueue& batch = g_dispatching;
+
+    for (const auto& sink : g_sinks)
+        sink(batch);
+
+    // Index loop: a callback may subscribe or unsubscribe, which moves entries.
+    for (std::size_t i = 0; i < g_subscribers.size(); ++i) {
+        std::string mod_id = g_subscribers[i].mod_id;
+        sol::protected_function fn = g_subscribers[i].fn;
+        ModContext* ctx = find_active_mod(mod_id);
+        if (!ctx)
+            continue;
+        sol::protected_function_result r;
+        try {
+            ModCallScope scope(*ctx);
+            r = fn(&batch);
+        } catch (const sol::error& e) {
+            std::fprintf(stderr, "[mod_events] %s handler exception: %s\n", mod_id.c_str(), e.what());
+            continue;
+        }
+        if (!r.valid()) {
+            sol::error e = r;
+            std::fprintf(stderr, "[mod_events] %s handler error: %s\n", mod_id.c_str(), e.what());
+        }
+    }
+
+    // Wake `wait_event` tasks once per kind seen this frame.
+    bool seen[static_cast<std::size_t>(ModEventType::Collision) + 1] = {};
+    for (ModEventType kind : batch.kind) {
+        auto k = static_cast<std::size_t>(kind);
+        if (!seen[k]) {
+            seen[k] = true;
+            signal_mod_tasks(mod_event_name(kind));
+        }
+    }
+    g_dispatching.clear();
+}
+
+void bind_mod_events(sol::state& lua, ModContext& ctx) {
+    lua.new_usertype<ModEventQueue>("ModEvents",
+        sol::no_constructor,
+        "count", &ModEventQueue::size,
+        "kind", [](const ModEventQueue& q, std::size_t i) {
+            return in_batch(q, i) ? static_cast<int>(q.kind[i - 1]) : 0;
+        },
+        "player", [](const ModEventQueue& q, std::size_t i) { return in_batch(q, i) ? q.player[i - 1] : -1; },
+        "subject", [](const ModEventQueue& q, std::size_t i) { return in_batch(q, i) ? q.subject[i - 1] : 0; },
+        "x", [](const ModEventQueue& q, std::size_t i) { return in_batch(q, i) ? q.x[i - 1] : 0.0f; },
+        "y", [](const ModEventQueue& q, std::size_t i) { return in_batch(q, i) ? q.y[i - 1] : 0.0f; });
+    lua.create_named_table("events",
+        "ITEM_USED", static_cast<int>(ModEventType::ItemUsed),
+        "BONK", static_cast<int>(ModEventType::Bonk),
+        "COLLISION", static_cast<int>(ModEventType::Collision));
+    lua.set_function("on_events", [&ctx](sol::protected_function fn) {
+        run_mod_command(ctx, [&ctx, fn] { g_subscribers.push_back({ctx.id, fn}); });
+    });
+}
+
+void drop_mod_event_subscriber(const std::string& mod_id) {
+    g_subscribers.erase(std::remove_if(g_subscribers.begin(), g_subscribers.end(),
+                                       [&](const ModEventSubscriber& s) { return s.mod_id == mod_id; }),
+                        g_subscribers.end());
+}
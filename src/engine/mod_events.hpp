@@ -0,0 +1,71 @@
+#pragma once
+
+#include "engine/lua_views.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace sol {
+class state;
+}
+
+struct ModContext;
+
+// Gameplay events for mods, batched per frame.
+//
+// Simulation code pushes events instead of calling into Lua on the spot.
+// After `step()` the frame's queue is dispatched once: engine-side sinks
+// first (the demo items run `on_use` from there), then one Lua call per
+// subscribed mod, in mod load order. Every mod sees the same events in the
+// same order no matter when in the step they happened.
+//
+// Lua side:
+//
+//     on_events(function(ev)
+//         for i = 1, ev:count() do
+//             if ev:kind(i) == events.BONK then ... end
+//         end
+//     end)
+//
+// `ev` is a view of the engine's buffers, valid only during the call.
+// Each kind seen in a frame also wakes tasks in `wait_event(name)` (see
+// engine/mod_tasks.hpp) with the kind's name: "item_used", "bonk", "collision".
+
+enum class ModEventType : std::uint8_t {
+    ItemUsed = 1, // subject: item handle
+    Bonk,         // subject: 0
+    Collision,    // player started touching an item; subject: item handle
+};
+
+// One column per field so a frame's events stay in a few flat arrays.
+struct ModEventQueue {
+    std::vector<ModEventType> kind;
+    std::vector<int> player;
+    std::vector<LuaHandle> subject;
+    std::vector<float> x;
+    std::vector<float> y;
+
+    std::size_t size() const { return kind.size(); }
+    bool empty() const { return kind.empty(); }
+    void clear();
+};
+
+const char* mod_event_name(ModEventType kind);
+
+void push_mod_event(ModEventType kind, int player, LuaHandle subject, glm::vec2 pos);
+
+// Engine or game code that consumes events before mods see them.
+void add_mod_event_sink(std::function<void(const ModEventQueue&)> sink);
+
+// Main thread, once per frame after simulation. Clears the queue.
+void dispatch_mod_events();
+
+// Binds `on_events` and the `events` kind constants into a mod state.
+void bind_mod_events(sol::state& lua, ModContext& ctx);
+// Releases the mod's callback; call before its state closes.
+void drop_mod_event_subscriber(const std::string& mod_id);
@@ -0,0 +1,111 @@
+#include "engine/mod_gc.hpp"
+
+#include "engine/mod_host.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include <lua.hpp>
+#include <sol/sol.hpp>
+
+namespace {
+
+// A new cycle starts once a heap has grown by half of what survived the last
+// one (at least kGcMinGrowthBytes), like Lua's default 200% pause but tighter.
+constexpr std::size_t kGcMinGrowthBytes = 64 * 1024;
+// Past this multiple of the settled size a mod steps even over budget.
+constexpr std::size_t kGcForceRatio = 4;
+constexpr int kGcForcedSteps = 8;
+
+std::atomic<std::uint32_t> g_budget_us{kDefaultModGcBudgetUs};
+
+using Clock = std::chrono::steady_clock;
+
+std::uint64_t ns_between(Clock::time_point a, Clock::time_point b) {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+}
+
+std::size_t heap_bytes(lua_State* L) {
+    return static_cast<std::size_t>(lua_gc(L, LUA_GCCOUNT)) * 1024 + static_cast<std::size_t>(lua_gc(L, LUA_GCCOUNTB));
+}
+
+bool wants_cycle(const ModGcStats& gc) {
+    std::size_t growth = std::max(gc.settled_bytes / 2, kGcMinGrowthBytes);
+    return gc.heap_bytes >= gc.settled_bytes + growth;
+}
+
+bool forced(const ModGcStats& gc) {
+    return gc.heap_bytes > std::max(gc.settled_bytes, kGcMinGrowthBytes) * kGcForceRatio;
+}
+
+// Heap size relative to what the last cycle left, so a mod churning garbage
+// outranks a merely large one.
+double pressure(const ModGcStats& gc) {
+    return static_cast<double>(gc.heap_bytes) /
+           static_cast<double>(std::max(gc.settled_bytes, kGcMinGrowthBytes));
+}
+
+} // namespace
+
+void take_over_mod_gc(lua_State* L, ModGcStats& stats) {
+    lua_gc(L, LUA_GCINC, 0, 0, 0);
+    lua_gc(L, LUA_GCCOLLECT);
+    lua_gc(L, LUA_GCSTOP);
+    stats.heap_bytes = heap_bytes(L);
+    stats.settled_bytes = stats.heap_bytes;
+    stats.in_cycle = false;
+}
+
+void step_mod_gc(const std::vector<ModContext*>& mods) {
+    std::vector<ModContext*> order;
+    order.reserve(mods.size());
+    for (ModContext* ctx : mods) {
+        ctx->gc.last_frame_ns = 0;
+        if (!ctx->lua)
+            continue;
+        ctx->gc.heap_bytes = heap_bytes(ctx->lua->lua_state());
+        if (ctx->gc.in_cycle || wants_cycle(ctx->gc))
+            order.push_back(ctx);
+    }
+    std::sort(order.begin(), order.end(),
+              [](const ModContext* a, const ModContext* b) { return pressure(a->gc) > pressure(b->gc); });
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + std::chrono::microseconds(g_budget_us.load(std::memory_order_relaxed));
+    Clock::time_point now = start;
+    for (ModContext* ctx : order) {
+        ModGcStats& gc = ctx->gc;
+        int extra = forced(gc) ? kGcForcedSteps : 0;
+        if (now >= deadline && extra == 0)
+            break; // the rest wait for the next frame
+        lua_State* L = ctx->lua->lua_state();
+        Clock::time_point mod_start = now;
+        do {
+            // A stopped collector still runs explicit steps; 0 means one basic step.
+            bool finished = lua_gc(L, LUA_GCSTEP, 0) != 0;
+            gc.steps += 1;
+            now = Clock::now();
+            if (now >= deadline)
+                extra -= 1;
+            if (finished) {
+                gc.cycles += 1;
+                gc.in_cycle = false;
+                gc.settled_bytes = heap_bytes(L);
+                break;
+            }
+            gc.in_cycle = true;
+        } while (now < deadline || extra > 0);
+        gc.heap_bytes = heap_bytes(L);
+        gc.last_frame_ns = ns_between(mod_start, now);
+        gc.total_ns += gc.last_frame_ns;
+    }
+}
+
+void set_mod_gc_budget_us(std::uint32_t us) {
+    g_budget_us.store(us, std::memory_order_relaxed);
+}
+
+std::uint32_t mod_gc_budget_us() {
+    return g_budget_us.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct ModContext;
+struct lua_State;
+
+// Engine-driven garbage collection for mod Lua states.
+//
+// Once a mod has loaded, its collector is stopped and only advanced from the
+// main loop after `render()`, so a cycle never lands inside gameplay code such
+// as an `on_use` callback. Each frame gets a shared time budget: mods whose
+// heaps grew most since their last finished cycle step first, and a mod far
+// past that point gets a few steps even when the budget is already spent. An
+// allocation that hits the memory cap still triggers Lua's own emergency
+// collection.
+
+inline constexpr std::uint32_t kDefaultModGcBudgetUs = 1000;
+
+struct ModGcStats {
+    std::size_t heap_bytes{0};    // as of the last step
+    std::size_t settled_bytes{0}; // what survived the last full cycle
+    bool in_cycle{false};
+    std::uint64_t last_frame_ns{0};
+    std::uint64_t total_ns{0};
+    std::uint64_t steps{0};
+    std::uint64_t cycles{0};
+};
+
+// Any thread: collects what loading left behind and hands the collector of a
+// freshly loaded state over to `step_mod_gc`.
+void take_over_mod_gc(lua_State* L, ModGcStats& stats);
+
+// Main thread, once per frame: advances the collectors of `mods` until the
+// frame's budget is spent.
+void step_mod_gc(const std::vector<ModContext*>& mods);
+
+// Microseconds of GC work per frame, shared by all mods.
+void set_mod_gc_budget_us(std::uint32_t us);
+std::uint32_t mod_gc_budget_us();
@@ -1,37 +1,41 @@
 #include "engine/mod_host.hpp"
 
 #include "engine/globals.hpp"
+#include "engine/lua_alloc.hpp"
+#include "engine/lua_views.hpp"
 #include "engine/mod_api_registry.hpp"
+#include "engine/mod_events.hpp"
+#include "engine/mod_script_cache.hpp"
+#include "engine/mod_state.hpp"
+#include "engine/mod_tasks.hpp"
 #include "engine/mods.hpp"
 #include "engine/graphics.hpp"
 #include "engine/audio.hpp"
 
 #include <algorithm>
 #include <cctype>
+#include <condition_variable>
+#include <cstdint>
 #include <cstdio>
+#include <exception>
 #include <filesystem>
+#include <mutex>
+#include <thread>
 #include <unordered_set>
 #include <sol/sol.hpp>
 
 namespace {
 
+constexpr std::uint64_t kScriptCacheKeepBytes = 32ull * 1024 * 1024;
+constexpr double kCpuFrameAvgWeight = 0.1;
+
 std::unordered_map<std::string, ModContext> g_active_mods;
 std::string g_required_version;
 
 void rebuild_mod_assets() {
     scan_mods_for_sprite_defs();
     load_all_textures_in_sprite_lookup();
-    load_mod_sounds();
-}
-
-ModInfo* find_mod_info_mutable(const std::string& id) {
-    if (!mm)
-        return nullptr;
-    for (auto& info : mm->mods) {
-        if (info.name == id)
-            return &info;
-    }
-    return nullptr;
+    load_mod_sounds(mm->root);
 }
 
 bool run_mod_scripts(ModContext& ctx) {
@@ -60,8 +64,18 @@ bool run_mod_scripts(ModContext& ctx) {
             c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
         if (ext != ".lua")
             continue;
-        sol::protected_function_result result =
-            ctx.lua->safe_script_file(path.string(), sol::script_pass_on_error);
+        // Compiled chunks come from the bytecode cache when the source is
+        // unchanged; only edited scripts are lexed and compiled again.
+        lua_State* L = ctx.lua->lua_state();
+        std::string load_err;
+        if (!load_mod_script(L, path, load_err)) {
+            std::fprintf(stderr, "[mod_host] %s\n", load_err.c_str());
+            continue;
+        }
+        sol::protected_function chunk(L, -1);
+        lua_pop(L, 1);
+        ModCallScope scope(ctx);
+        sol::protected_function_result result = chunk();
         if (!result.valid()) {
             sol::error err = result;
             std::fprintf(stderr, "[mod_host] %s: %s\n",
@@ -79,59 +93,185 @@ bool deactivate_internal(const std::string& id) {
         if (api->on_mod_unloaded)
             api->on_mod_unloaded(it->second);
     }
+    drop_mod_event_subscriber(id);
+    drop_mod_tasks(it->second);
     g_active_mods.erase(it);
     return true;
 }
 
-bool activate_internal(ModInfo& info) {
+// Main thread: checks whether `info` may load and reserves its context.
+// Contexts live in `g_active_mods` from here on; map nodes never move, so
+// API bindings can hold on to `ctx` while workers fill it in.
+ModContext* begin_activation(const ModInfo& info) {
     if (!info.enabled)
-        return false;
+        return nullptr;
     if (g_active_mods.count(info.name))
-        return false;
+        return nullptr;
     if (!g_required_version.empty() && !info.game_version.empty() &&
         info.game_version != g_required_version) {
         std::fprintf(stderr,
                      "[mod_host] Skipping %s: requires game_version %s (current %s)\n",
                      info.name.c_str(), info.game_version.c_str(),
                      g_required_version.c_str());
-        return false;
+        return nullptr;
     }
 
-    ModContext ctx;
+    ModContext& ctx = g_active_mods[info.name];
     ctx.id = info.name;
     ctx.title = info.title;
     ctx.path = info.path;
     ctx.requested_apis = info.apis;
-    ctx.lua = std::make_unique<sol::state>();
-    ctx.lua->open_libraries(sol::lib::base, sol::lib::math,
-                            sol::lib::string, sol::lib::table);
-
-    auto& registry = ModApiRegistry::instance();
-    for (const auto& api_name : ctx.requested_apis) {
-        if (const ModApiDescriptor* api = registry.find(api_name)) {
-            if (api->bind_lua)
-                api->bind_lua(*ctx.lua, ctx);
-            ctx.bound_apis.push_back(api);
-        } else {
-            std::fprintf(stderr,
-                         "[mod_host] Mod %s requested unknown API '%s'\n",
-                         ctx.id.c_str(), api_name.c_str());
+    ctx.recording_commands = true;
+    return &ctx;
+}
+
+// Any thread: builds the mod's Lua state and runs its scripts. Touches only
+// `ctx`; engine effects are recorded into `ctx.commands`.
+void load_mod_context(ModContext& ctx) {
+    try {
+        ctx.alloc = std::make_unique<LuaAllocator>();
+        ctx.lua = std::make_unique<sol::state>(sol::default_at_panic, lua_alloc_fn, ctx.alloc.get());
+        ctx.lua->open_libraries(sol::lib::base, sol::lib::math,
+                                sol::lib::string, sol::lib::table);
+        bind_lua_views(*ctx.lua);
+        bind_mod_events(*ctx.lua, ctx);
+        bind_mod_tasks(*ctx.lua, ctx);
+
+        auto& registry = ModApiRegistry::instance();
+        for (const auto& api_name : ctx.requested_apis) {
+            if (const ModApiDescriptor* api = registry.find(api_name)) {
+                if (api->bind_lua)
+                    api->bind_lua(*ctx.lua, ctx);
+                ctx.bound_apis.push_back(api);
+            } else {
+                std::fprintf(stderr,
+                             "[mod_host] Mod %s requested unknown API '%s'\n",
+                             ctx.id.c_str(), api_name.c_str());
+            }
         }
-    }
 
-    run_mod_scripts(ctx);
+        run_mod_scripts(ctx);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "[mod_host] Mod %s failed to load: %s\n", ctx.id.c_str(), e.what());
+    }
+    if (ctx.lua)
+        take_over_mod_gc(ctx.lua->lua_state(), ctx.gc);
+}
 
+// Main thread: applies what the scripts recorded, then the loaded hooks.
+void finish_activation(ModContext& ctx) {
+    ctx.recording_commands = false;
+    for (auto& cmd : ctx.commands)
+        cmd();
+    ctx.commands.clear();
     for (const auto* api : ctx.bound_apis) {
         if (api->on_mod_loaded)
             api->on_mod_loaded(ctx);
     }
+}
 
-    g_active_mods.emplace(ctx.id, std::move(ctx));
-    return true;
+struct ActivationJob {
+    ModContext* ctx{nullptr};
+    const ModInfo* info{nullptr};
+    std::vector<int> dependents;
+    int waiting_on{0};
+};
+
+// Loads every job's context, each only after the mods it depends on. Lua
+// states are independent, so jobs whose dependencies are done run on as
+// many threads as there are cores (the calling thread included).
+void run_activation_jobs(std::vector<ActivationJob>& jobs) {
+    int workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    workers = std::min(workers, static_cast<int>(jobs.size()));
+    if (workers <= 1) {
+        // `jobs` follows resolve_mod_order, so plain order respects deps.
+        for (auto& job : jobs)
+            load_mod_context(*job.ctx);
+        return;
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<int> ready;
+    ready.reserve(jobs.size());
+    for (int j = static_cast<int>(jobs.size()) - 1; j >= 0; --j) {
+        if (jobs[static_cast<std::size_t>(j)].waiting_on == 0)
+            ready.push_back(j);
+    }
+    int remaining = static_cast<int>(jobs.size());
+    auto work = [&] {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            cv.wait(lock, [&] { return !ready.empty() || remaining == 0; });
+            if (ready.empty())
+                return;
+            ActivationJob& job = jobs[static_cast<std::size_t>(ready.back())];
+            ready.pop_back();
+            lock.unlock();
+            load_mod_context(*job.ctx);
+            lock.lock();
+            --remaining;
+            for (int d : job.dependents) {
+                if (--jobs[static_cast<std::size_t>(d)].waiting_on == 0)
+                    ready.push_back(d);
+            }
+            cv.notify_all();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<std::size_t>(workers - 1));
+    for (int t = 1; t < workers; ++t)
+        threads.emplace_back(work);
+    work();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+// Activates `mods` (given in load order) and returns how many came up.
+int activate_mods(const std::vector<ModInfo*>& mods) {
+    std::vector<ActivationJob> jobs;
+    jobs.reserve(mods.size());
+    std::unordered_map<std::string, int> job_of;
+    for (ModInfo* info : mods) {
+        ModContext* ctx = begin_activation(*info);
+        if (!ctx)
+            continue;
+        job_of[info->name] = static_cast<int>(jobs.size());
+        ActivationJob job;
+        job.ctx = ctx;
+        job.info = info;
+        jobs.push_back(std::move(job));
+    }
+    for (std::size_t j = 0; j < jobs.size(); ++j) {
+        auto link = [&](const std::string& dep) {
+            auto it = job_of.find(dep);
+            if (it == job_of.end())
+                return;
+            jobs[static_cast<std::size_t>(it->second)].dependents.push_back(static_cast<int>(j));
+            jobs[j].waiting_on += 1;
+        };
+        for (const auto& dep : jobs[j].info->deps)
+            link(dep);
+        for (const auto& dep : jobs[j].info->optional_deps)
+            link(dep);
+    }
+
+    run_activation_jobs(jobs);
+
+    for (auto& job : jobs)
+        finish_activation(*job.ctx);
+    return static_cast<int>(jobs.size());
 }
 
 } // namespace
 
+void run_mod_command(ModContext& ctx, std::function<void()> cmd) {
+    if (ctx.recording_commands)
+        ctx.commands.push_back(std::move(cmd));
+    else
+        cmd();
+}
+
 void set_required_mod_game_version(const std::string& version) {
     g_required_version = version;
 }
@@ -143,6 +283,7 @@ const std::string& required_mod_game_version() {
 bool load_enabled_mods_via_host() {
     if (!mm)
         return false;
+    prune_mod_script_cache(kScriptCacheKeepBytes);
     std::vector<std::string> enabled;
     for (const auto& mod : mm->mods) {
         if (mod.enabled)
@@ -188,22 +329,50 @@ bool reload_mod(const std::string& id) {
     return reload_mods({id});
 }
 
-bool reload_mods(const std::vector<std::string>& ids) {
+bool reload_mods(const std::vector<std::string>& ids, bool assets_changed) {
     if (ids.empty())
         return false;
     bool changed = false;
+    // Taken before teardown and handed back once each mod is active again,
+    // so a reload does not reset what the mod was doing.
+    std::unordered_map<std::string, std::string> saved;
+    for (const auto& id : ids) {
+        auto it = g_active_mods.find(id);
+        if (it == g_active_mods.end())
+            continue;
+        std::string blob = save_mod_state_blob(it->second);
+        if (!blob.empty())
+            saved.emplace(id, std::move(blob));
+    }
     for (const auto& id : ids) {
         if (deactivate_internal(id))
             changed = true;
     }
-    if (changed)
+    if (changed && assets_changed)
         rebuild_mod_assets();
-    for (const auto& id : ids) {
-        if (auto* info = find_mod_info_mutable(id)) {
-            if (!info->enabled)
-                info->enabled = true;
-            if (activate_internal(*info))
-                changed = true;
+    // Walk `mm->mods` rather than `ids`: it holds resolve_mod_order's result,
+    // which activation relies on for dependencies.
+    std::unordered_set<std::string> wanted(ids.begin(), ids.end());
+    std::vector<ModInfo*> to_activate;
+    to_activate.reserve(wanted.size());
+    if (mm) {
+        for (auto& mod : mm->mods) {
+            if (!wanted.count(mod.name))
+                continue;
+            mod.enabled = true;
+            to_activate.push_back(&mod);
+        }
+    }
+    if (activate_mods(to_activate) > 0)
+        changed = true;
+    for (const auto& [id, blob] : saved) {
+        auto it = g_active_mods.find(id);
+        if (it == g_active_mods.end())
+            continue;
+        load_mod_state_blob(it->second, blob);
+        for (const auto* api : it->second.bound_apis) {
+            if (api->on_mod_reloaded)
+                api->on_mod_reloaded(it->second);
         }
     }
     return changed;
@@ -237,14 +406,14 @@ bool set_active_mods(const std::vector<std::string>& ids) {
     if (changed)
         rebuild_mod_assets();
 
+    std::vector<ModInfo*> to_activate;
+    to_activate.reserve(desired.size());
     for (auto& mod : mm->mods) {
-        if (!desired.count(mod.name))
-            continue;
-        if (!g_active_mods.count(mod.name)) {
-            if (activate_internal(mod))
-                changed = true;
-        }
+        if (desired.count(mod.name) && !g_active_mods.count(mod.name))
+            to_activate.push_back(&mod);
     }
+    if (activate_mods(to_activate) > 0)
+        changed = true;
 
     return changed;
 }
@@ -267,3 +436,25 @@ std::vector<std::string> get_active_mod_ids() {
 const std::unordered_map<std::string, ModContext>& active_mod_contexts() {
     return g_active_mods;
 }
+
+ModContext* find_active_mod(const std::string& id) {
+    auto it = g_active_mods.find(id);
+    return it == g_active_mods.end() ? nullptr : &it->second;
+}
+
+void roll_mod_cpu_frame() {
+    for (auto& [id, ctx] : g_active_mods) {
+        ModCpuStats& cpu = ctx.cpu;
+        cpu.last_frame_ns = cpu.frame_ns;
+        cpu.avg_frame_ns += (static_cast<double>(cpu.frame_ns) - cpu.avg_frame_ns) * kCpuFrameAvgWeight;
+        cpu.frame_ns = 0;
+    }
+}
+
+void collect_mod_garbage() {
+    std::vector<ModContext*> mods;
+    mods.reserve(g_active_mods.size());
+    for (auto& [id, ctx] : g_active_mods)
+        mods.push_back(&ctx);
+    step_mod_gc(mods);
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "engine/mod_budget.hpp"
+#include "engine/mod_gc.hpp"
+
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -10,6 +14,7 @@ class state;
 }
 
 struct ModApiDescriptor;
+struct LuaAllocator;
 
 struct ModContext {
     std::string id;
@@ -17,9 +22,21 @@ struct ModContext {
     std::string path;
     std::vector<std::string> requested_apis;
     std::vector<const ModApiDescriptor*> bound_apis;
+    // Declared before `lua` so the state is closed before its allocator goes.
+    std::unique_ptr<LuaAllocator> alloc;
     std::unique_ptr<sol::state> lua;
+    // Engine-side effects a mod asks for while its scripts run on an
+    // activation worker. They are applied on the main thread, in mod order,
+    // before `on_mod_loaded`; outside activation they run immediately.
+    std::vector<std::function<void()>> commands;
+    bool recording_commands{false};
+    ModCpuStats cpu;
+    ModGcStats gc;
 };
 
+// Used by API bindings for anything that touches engine state.
+void run_mod_command(ModContext& ctx, std::function<void()> cmd);
+
 void set_required_mod_game_version(const std::string& version);
 const std::string& required_mod_game_version();
 
@@ -29,8 +46,17 @@ void unload_all_mods_via_host();
 bool activate_mod(const std::string& id);
 bool deactivate_mod(const std::string& id);
 bool reload_mod(const std::string& id);
-bool reload_mods(const std::vector<std::string>& ids);
+// Keeps each mod's saved state across the reload (engine/mod_state.hpp).
+// Pass `assets_changed = false` when only scripts changed to skip the
+// sprite/texture/sound rebuild.
+bool reload_mods(const std::vector<std::string>& ids, bool assets_changed = true);
 bool set_active_mods(const std::vector<std::string>& ids);
 std::vector<std::string> get_active_mod_ids();
 
 const std::unordered_map<std::string, ModContext>& active_mod_contexts();
+ModContext* find_active_mod(const std::string& id);
+
+// Once per frame on the main thread: closes each mod's CPU frame total.
+void roll_mod_cpu_frame();
+// Once per frame on the main thread, after rendering: budgeted GC steps.
+void collect_mod_garbage();
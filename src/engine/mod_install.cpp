@@ -1,5 +1,9 @@
 #include "engine/mod_install.hpp"
 
+#include "engine/content_hash.hpp"
+#include "engine/mod_blobs.hpp"
+#include "engine/mod_bundle.hpp"
+#include "engine/mod_delta.hpp"
 #include "engine/mod_host.hpp"
 #include "engine/mods.hpp"
 #include "engine/graphics.hpp"
@@ -7,10 +11,14 @@
 #include "engine/globals.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <sstream>
+#include <thread>
 
 #if defined(__GNUC__)
 #pragma GCC diagnostic push
@@ -21,11 +29,23 @@
 #pragma GCC diagnostic pop
 #endif
 #include <nlohmann/json.hpp>
+#include <zlib.h>
 
 namespace {
 
 constexpr const char* kCatalogPath = "/mods/catalog";
 constexpr const char* kFilesPrefix = "/mods/files/";
+constexpr const char* kBundlePrefix = "/mods/bundle/";
+constexpr const char* kDeltaPrefix = "/mods/delta/";
+constexpr const char* kListingPrefix = "/mods/listing/";
+constexpr std::size_t kDownloadChunkBytes = 64 * 1024;
+constexpr const char* kPartSuffix = ".part";
+constexpr const char* kMetaSuffix = ".meta";
+constexpr const char* kBundlePartName = ".bundle.part";
+constexpr std::uint64_t kProgressMinStepBytes = 256 * 1024;
+constexpr std::uint64_t kUnlinkedBlobKeepBytes = 512ull * 1024 * 1024;
+constexpr int kBusyRetryLimit = 5;
+constexpr int kBusyRetryMaxSeconds = 10;
 
 struct EndpointInfo {
     std::string host;
@@ -91,13 +111,6 @@ fs::path mods_root_path() {
     return fs::path("mods");
 }
 
-fs::path local_mod_path(const ModCatalogEntry& entry) {
-    std::string folder = entry.folder.empty() ? entry.id : entry.folder;
-    if (folder.empty())
-        folder = entry.id;
-    return mods_root_path() / folder;
-}
-
 bool ensure_parent_dirs(const fs::path& path, std::string& err) {
     std::error_code ec;
     fs::path parent = path.parent_path();
@@ -112,35 +125,870 @@ bool ensure_parent_dirs(const fs::path& path, std::string& err) {
     return true;
 }
 
-void refresh_runtime(const std::vector<std::string>& previously_active) {
-    discover_mods();
-    scan_mods_for_sprite_defs();
-    load_all_textures_in_sprite_lookup();
-    load_mod_sounds();
-    set_active_mods(previously_active);
+// Sidecar stored at `<part>.meta` describing what a `.part` file is a prefix
+// of. A retry only resumes when the catalog still describes the same content.
+struct PartialMeta {
+    std::uint64_t size_bytes{0}; // 0 when unknown (bundles)
+    std::string hash;
+};
+
+fs::path partial_meta_path(const fs::path& part) {
+    fs::path meta = part;
+    meta += kMetaSuffix;
+    return meta;
 }
 
-} // namespace
+void write_partial_meta(const fs::path& part, const PartialMeta& meta) {
+    std::ofstream out(partial_meta_path(part), std::ios::trunc);
+    out << meta.size_bytes << " " << meta.hash << "\n";
+}
 
-bool fetch_mod_catalog(const std::string& server_url,
-                       std::vector<ModCatalogEntry>& out,
-                       std::string& err) {
-    EndpointInfo endpoint;
-    if (!parse_http_endpoint(server_url, endpoint, err))
+void discard_partial(const fs::path& part) {
+    std::error_code ec;
+    fs::remove(part, ec);
+    fs::remove(partial_meta_path(part), ec);
+}
+
+// Bytes of `part` that can be kept for a resumed download of `expected`.
+// Anything that does not match is discarded and 0 is returned.
+std::uint64_t resumable_bytes(const fs::path& part, const PartialMeta& expected) {
+    std::error_code ec;
+    if (!fs::exists(part, ec))
+        return 0;
+    PartialMeta stored;
+    std::ifstream in(partial_meta_path(part));
+    in >> stored.size_bytes >> stored.hash;
+    std::uintmax_t have = fs::file_size(part, ec);
+    if (expected.hash.empty() || !in || ec || stored.hash != expected.hash ||
+        stored.size_bytes != expected.size_bytes ||
+        (expected.size_bytes > 0 && have > expected.size_bytes)) {
+        in.close();
+        discard_partial(part);
+        return 0;
+    }
+    return static_cast<std::uint64_t>(have);
+}
+
+// True when a 206 response still describes the content we started with.
+bool etag_matches(const httplib::Response& response, const std::string& hash) {
+    if (hash.empty() || !response.has_header("ETag"))
+        return true;
+    return response.get_header_value("ETag") == "\"" + hash + "\"";
+}
+
+// Counts unpacked bytes for one install and forwards them to the caller's
+// callback at most every 1% (or 256 KiB), so a worker thread does not flood
+// the event queue. `mark`/`rewind` undo bytes that a restarted download will
+// write again. Once the callback returns false every further write fails.
+struct InstallProgress {
+    const ModInstallProgressFn* fn{nullptr};
+    std::uint64_t done{0};
+    std::uint64_t total{0};
+    std::uint64_t reported{0};
+    bool cancelled{false};
+
+    bool add(std::uint64_t bytes) {
+        done += bytes;
+        report(false);
+        return !cancelled;
+    }
+
+    std::uint64_t mark() const { return done; }
+    void rewind(std::uint64_t to) { done = std::min(done, to); }
+
+    void report(bool force) {
+        if (!fn || !*fn)
+            return;
+        std::uint64_t shown = total > 0 ? std::min(done, total) : done;
+        std::uint64_t step = std::max(total / 100, kProgressMinStepBytes);
+        if (!force && shown < reported + step)
+            return;
+        reported = shown;
+        if (!(*fn)(shown, total))
+            cancelled = true;
+    }
+};
+
+// Accumulates received bytes into a fixed-size buffer and flushes it to the
+// output stream whenever it fills, hashing each chunk as it passes through.
+struct ChunkedFileWriter {
+    std::ofstream out;
+    ContentHasher hasher;
+    std::array<char, kDownloadChunkBytes> buffer{};
+    std::size_t buffered{0};
+    std::uint64_t received{0};
+    InstallProgress* progress{nullptr};
+
+    // With `append`, the bytes already in `path` are hashed first so the
+    // final digest covers the whole file after a resumed download.
+    bool open(const fs::path& path, bool append = false) {
+        out.close();
+        out.clear();
+        hasher = ContentHasher{};
+        buffered = 0;
+        received = 0;
+        if (append) {
+            std::ifstream in(path, std::ios::binary);
+            while (in.good()) {
+                in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                std::streamsize got = in.gcount();
+                if (got <= 0)
+                    break;
+                hasher.update(buffer.data(), static_cast<std::size_t>(got));
+                received += static_cast<std::uint64_t>(got);
+            }
+            if (progress)
+                (void)progress->add(received);
+            out.open(path, std::ios::binary | std::ios::app);
+        } else {
+            out.open(path, std::ios::binary | std::ios::trunc);
+        }
+        return out.good();
+    }
+
+    bool write(const char* data, std::size_t len) {
+        hasher.update(data, len);
+        received += len;
+        if (progress && !progress->add(len))
+            return false;
+        while (len > 0) {
+            std::size_t take = std::min(len, buffer.size() - buffered);
+            std::copy(data, data + take, buffer.data() + buffered);
+            buffered += take;
+            data += take;
+            len -= take;
+            if (buffered == buffer.size() && !flush())
+                return false;
+        }
+        return true;
+    }
+
+    bool flush() {
+        if (buffered > 0) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffered));
+            buffered = 0;
+        }
+        return out.good();
+    }
+};
+
+// mod_server answers 503 with Retry-After while all of its transfer slots
+// are taken. Wait as asked (bounded) and say whether to try again.
+bool wait_for_busy_server(const std::string& retry_after, int& attempts, const InstallProgress& progress) {
+    if (attempts >= kBusyRetryLimit || progress.cancelled)
         return false;
-    httplib::Client client(endpoint.host, endpoint.port);
-    client.set_read_timeout(5, 0);
-    auto res = client.Get(kCatalogPath);
+    ++attempts;
+    int seconds = 1;
+    try {
+        seconds = std::stoi(retry_after);
+    } catch (...) {
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(std::clamp(seconds, 1, kBusyRetryMaxSeconds)));
+    return true;
+}
+
+// Streams one catalog file into `<dest>.part`, verifies size and hash, then
+// renames it over `dest`. The body never lives in memory as a whole. A
+// `.part` left by an interrupted attempt is resumed with a `Range` request;
+// if the server ignores the range or the content changed, it starts over.
+bool download_file(httplib::Client& client,
+                   const std::string& url,
+                   const ModFileEntry& file,
+                   const fs::path& dest,
+                   InstallProgress& progress,
+                   std::string& err,
+                   int busy_attempts = 0) {
+    fs::path tmp = dest;
+    tmp += kPartSuffix;
+    PartialMeta expected{file.size_bytes, file.hash};
+    std::uint64_t offset = resumable_bytes(tmp, expected);
+    std::uint64_t progress_mark = progress.mark();
+    ChunkedFileWriter writer;
+    writer.progress = &progress;
+    if (!writer.open(tmp, offset > 0)) {
+        err = "Failed to write " + tmp.string();
+        return false;
+    }
+    if (offset == 0 && !expected.hash.empty())
+        write_partial_meta(tmp, expected);
+
+    int status = 0;
+    std::string retry_after;
+    bool resume_rejected = false;
+    httplib::Result res;
+    bool complete = offset > 0 && offset == file.size_bytes;
+    if (!complete) {
+        httplib::Headers headers;
+        if (offset > 0)
+            headers.emplace("Range", "bytes=" + std::to_string(offset) + "-");
+        res = client.Get(
+            url, headers,
+            [&](const httplib::Response& response) {
+                status = response.status;
+                retry_after = response.get_header_value("Retry-After");
+                if (status == 206 && offset > 0) {
+                    resume_rejected = !etag_matches(response, file.hash);
+                    return !resume_rejected;
+                }
+                if (status == 416 && offset > 0) {
+                    resume_rejected = true;
+                    return false;
+                }
+                if (status == 200 && offset > 0) {
+                    offset = 0;
+                    progress.rewind(progress_mark);
+                    return writer.open(tmp);
+                }
+                return status == 200;
+            },
+            [&](const char* data, std::size_t len) { return writer.write(data, len); });
+    }
+    bool flushed = writer.flush();
+    writer.out.close();
+
+    auto fail = [&](std::string message) {
+        discard_partial(tmp);
+        err = std::move(message);
+        return false;
+    };
+    if (resume_rejected) {
+        discard_partial(tmp);
+        progress.rewind(progress_mark);
+        return download_file(client, url, file, dest, progress, err);
+    }
+    if (status == 503) {
+        // Nothing was written; any partial file stays for the retry.
+        if (wait_for_busy_server(retry_after, busy_attempts, progress))
+            return download_file(client, url, file, dest, progress, err, busy_attempts);
+        err = "Server busy, gave up on " + file.path;
+        return false;
+    }
+    if (status != 0 && status != 200 && status != 206)
+        return fail("Download failed (" + std::to_string(status) + ") for " + file.path);
+    if (!complete && !res) {
+        // Keep the partial file and its sidecar so the next attempt resumes.
+        err = "Failed to download " + file.path;
+        return false;
+    }
+    if (!flushed)
+        return fail("Failed to write " + tmp.string());
+    if (file.size_bytes > 0 && writer.received != file.size_bytes)
+        return fail("Size mismatch for " + file.path);
+    if (!file.hash.empty() && content_hash_hex(writer.hasher.digest()) != file.hash) {
+        if (offset > 0) {
+            // The saved prefix was bad; fetch the whole file once more.
+            discard_partial(tmp);
+            progress.rewind(progress_mark);
+            return download_file(client, url, file, dest, progress, err);
+        }
+        return fail("Hash mismatch for " + file.path);
+    }
+
+    std::error_code ec;
+    fs::remove(dest, ec);
+    ec.clear();
+    fs::rename(tmp, dest, ec);
+    if (ec)
+        return fail("Failed to move " + tmp.string() + " into place");
+    fs::remove(partial_meta_path(tmp), ec);
+    return true;
+}
+
+// Moves up to `want` bytes from the input into `field`; true once full.
+// Lets the streaming parsers below accept fields split across chunks.
+bool take_field(std::string& field, const char*& p, std::size_t& n, std::size_t want) {
+    std::size_t need = want - field.size();
+    std::size_t grab = std::min(need, n);
+    field.append(p, grab);
+    p += grab;
+    n -= grab;
+    return field.size() == want;
+}
+
+// Inflates a `/mods/bundle/<id>` stream as it arrives and writes each entry
+// straight to disk under `root`. Entries go through `.part` files and are
+// renamed into place once their size and hash check out.
+struct BundleUnpacker {
+    enum class Stage { Header, PathLen, Path, Tail, Body, Done };
+
+    fs::path root;
+    z_stream zs{};
+    bool zs_ready{false};
+    bool stream_end{false};
+    std::array<char, kDownloadChunkBytes> inflated{};
+    Stage stage{Stage::Header};
+    std::string field;
+    std::uint32_t path_len{0};
+    std::string path;
+    std::uint64_t remaining{0};
+    std::uint64_t expected_hash{0};
+    fs::path dest;
+    fs::path tmp;
+    ChunkedFileWriter writer;
+    std::vector<std::string> entries; // relative paths unpacked so far
+    std::string err;
+
+    BundleUnpacker(fs::path r, InstallProgress* progress) : root(std::move(r)) {
+        writer.progress = progress;
+        zs_ready = inflateInit(&zs) == Z_OK;
+        if (!zs_ready)
+            err = "Failed to initialise inflate";
+    }
+
+    ~BundleUnpacker() {
+        if (zs_ready)
+            inflateEnd(&zs);
+        if (!tmp.empty()) {
+            writer.out.close();
+            std::error_code ec;
+            fs::remove(tmp, ec);
+        }
+    }
+
+    BundleUnpacker(const BundleUnpacker&) = delete;
+    BundleUnpacker& operator=(const BundleUnpacker&) = delete;
+
+    bool fail(std::string message) {
+        if (err.empty())
+            err = std::move(message);
+        return false;
+    }
+
+    bool feed(const char* data, std::size_t len) {
+        if (!zs_ready || !err.empty())
+            return false;
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        zs.avail_in = static_cast<uInt>(len);
+        // Keep inflating while input remains or the output buffer came back
+        // full, since zlib may still hold decompressed bytes.
+        while (!stream_end) {
+            zs.next_out = reinterpret_cast<Bytef*>(inflated.data());
+            zs.avail_out = static_cast<uInt>(inflated.size());
+            int rc = inflate(&zs, Z_NO_FLUSH);
+            if (rc == Z_STREAM_END)
+                stream_end = true;
+            else if (rc != Z_OK && rc != Z_BUF_ERROR)
+                return fail("Corrupt bundle stream");
+            std::size_t produced = inflated.size() - zs.avail_out;
+            if (!consume(inflated.data(), produced))
+                return false;
+            if (produced == 0 || (zs.avail_in == 0 && zs.avail_out > 0))
+                break;
+        }
+        if (stream_end && zs.avail_in > 0)
+            return fail("Trailing data after bundle");
+        return true;
+    }
+
+    bool finish() {
+        if (!err.empty())
+            return false;
+        if (!stream_end || stage != Stage::Done)
+            return fail("Bundle ended early");
+        return true;
+    }
+
+    bool consume(const char* p, std::size_t n) {
+        while (n > 0) {
+            switch (stage) {
+            case Stage::Header:
+                if (!take_field(field, p, n, kModBundleHeaderBytes))
+                    break;
+                if (field.compare(0, 4, kModBundleMagic, 4) != 0 ||
+                    bundle_get_u32(field.data() + 4) != kModBundleVersion)
+                    return fail("Unsupported bundle format");
+                field.clear();
+                stage = Stage::PathLen;
+                break;
+            case Stage::PathLen:
+                if (!take_field(field, p, n, 4))
+                    break;
+                path_len = bundle_get_u32(field.data());
+                field.clear();
+                if (path_len == 0) {
+                    stage = Stage::Done;
+                } else if (path_len > kModBundleMaxPath) {
+                    return fail("Bundle entry path too long");
+                } else {
+                    stage = Stage::Path;
+                }
+                break;
+            case Stage::Path:
+                if (!take_field(field, p, n, path_len))
+                    break;
+                path = std::move(field);
+                field.clear();
+                if (!bundle_path_is_safe(path))
+                    return fail("Unsafe bundle path: " + path);
+                stage = Stage::Tail;
+                break;
+            case Stage::Tail:
+                if (!take_field(field, p, n, kModBundleEntryTailBytes))
+                    break;
+                remaining = bundle_get_u64(field.data());
+                expected_hash = bundle_get_u64(field.data() + 8);
+                field.clear();
+                if (!begin_entry())
+                    return false;
+                if (remaining == 0 && !end_entry())
+                    return false;
+                stage = remaining == 0 ? Stage::PathLen : Stage::Body;
+                break;
+            case Stage::Body: {
+                std::size_t grab = static_cast<std::size_t>(
+                    std::min<std::uint64_t>(remaining, n));
+                if (!writer.write(p, grab))
+                    return fail("Failed to write " + tmp.string());
+                p += grab;
+                n -= grab;
+                remaining -= grab;
+                if (remaining == 0) {
+                    if (!end_entry())
+                        return false;
+                    stage = Stage::PathLen;
+                }
+                break;
+            }
+            case Stage::Done:
+                return fail("Trailing data after bundle terminator");
+            }
+        }
+        return true;
+    }
+
+    bool begin_entry() {
+        dest = root / fs::path(path);
+        if (!ensure_parent_dirs(dest, err))
+            return false;
+        tmp = dest;
+        tmp += ".part";
+        if (!writer.open(tmp))
+            return fail("Failed to write " + tmp.string());
+        return true;
+    }
+
+    bool end_entry() {
+        bool flushed = writer.flush();
+        writer.out.close();
+        if (!flushed)
+            return fail("Failed to write " + tmp.string());
+        if (writer.hasher.digest() != expected_hash)
+            return fail("Hash mismatch for " + path);
+        std::error_code ec;
+        fs::remove(dest, ec);
+        ec.clear();
+        fs::rename(tmp, dest, ec);
+        if (ec)
+            return fail("Failed to move " + tmp.string() + " into place");
+        tmp.clear();
+        entries.push_back(path);
+        return true;
+    }
+};
+
+// Installs a whole mod from its compressed bundle in a single request.
+// `served` is false when the server has no bundle endpoint (older servers),
+// in which case the caller falls back to per-file downloads.
+//
+// The compressed bytes are also kept in `<target>/.bundle.part` so an
+// interrupted install can resume: the saved prefix is replayed through the
+// unpacker locally and only the rest is requested with a `Range` header.
+bool download_bundle(httplib::Client& client,
+                     const ModCatalogEntry& entry,
+                     const fs::path& target,
+                     bool& served,
+                     std::vector<std::string>& unpacked,
+                     InstallProgress& progress,
+                     std::string& err,
+                     int busy_attempts = 0) {
+    served = false;
+    fs::path part = target / kBundlePartName;
+    PartialMeta expected{0, entry.content_hash};
+    std::uint64_t offset = resumable_bytes(part, expected);
+    std::uint64_t progress_mark = progress.mark();
+    auto unpacker = std::make_unique<BundleUnpacker>(target, &progress);
+    if (offset > 0) {
+        std::ifstream in(part, std::ios::binary);
+        std::array<char, kDownloadChunkBytes> chunk{};
+        std::uint64_t replayed = 0;
+        while (in.good() && replayed < offset) {
+            in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            std::streamsize got = in.gcount();
+            if (got <= 0 || !unpacker->feed(chunk.data(), static_cast<std::size_t>(got)))
+                break;
+            replayed += static_cast<std::uint64_t>(got);
+        }
+        if (replayed != offset) {
+            discard_partial(part);
+            offset = 0;
+            progress.rewind(progress_mark);
+            unpacker = std::make_unique<BundleUnpacker>(target, &progress);
+        }
+    }
+    std::ofstream raw(part, std::ios::binary | (offset > 0 ? std::ios::app : std::ios::trunc));
+    if (!raw.good()) {
+        err = "Failed to write " + part.string();
+        return false;
+    }
+    if (offset == 0 && !expected.hash.empty())
+        write_partial_meta(part, expected);
+
+    int status = 0;
+    std::string retry_after;
+    bool resume_rejected = false;
+    httplib::Headers headers;
+    if (offset > 0)
+        headers.emplace("Range", "bytes=" + std::to_string(offset) + "-");
+    auto res = client.Get(
+        std::string(kBundlePrefix) + url_encode_path(entry.id), headers,
+        [&](const httplib::Response& response) {
+            status = response.status;
+            retry_after = response.get_header_value("Retry-After");
+            if (status == 206 && offset > 0) {
+                resume_rejected = !etag_matches(response, entry.content_hash);
+                return !resume_rejected;
+            }
+            if (status == 416 && offset > 0) {
+                resume_rejected = true;
+                return false;
+            }
+            if (status == 200 && offset > 0) {
+                // Server ignored the range; start the stream over.
+                raw.close();
+                raw.open(part, std::ios::binary | std::ios::trunc);
+                unpacker.reset();
+                progress.rewind(progress_mark);
+                unpacker = std::make_unique<BundleUnpacker>(target, &progress);
+                offset = 0;
+                return raw.good();
+            }
+            return status == 200;
+        },
+        [&](const char* data, std::size_t len) {
+            raw.write(data, static_cast<std::streamsize>(len));
+            return raw.good() && unpacker->feed(data, len);
+        });
+    raw.close();
+
+    if (status == 404) {
+        discard_partial(part);
+        return false;
+    }
+    served = true;
+    if (status == 503) {
+        if (wait_for_busy_server(retry_after, busy_attempts, progress))
+            return download_bundle(client, entry, target, served, unpacked, progress, err, busy_attempts);
+        err = "Server busy, gave up on bundle for " + entry.id;
+        return false;
+    }
+    if (resume_rejected) {
+        discard_partial(part);
+        unpacker.reset();
+        progress.rewind(progress_mark);
+        return download_bundle(client, entry, target, served, unpacked, progress, err);
+    }
+    if (status != 0 && status != 200 && status != 206) {
+        discard_partial(part);
+        err = "Bundle download failed (" + std::to_string(status) + ") for " + entry.id;
+        return false;
+    }
+    if (!unpacker->err.empty()) {
+        discard_partial(part);
+        err = unpacker->err;
+        return false;
+    }
     if (!res) {
-        err = "Failed to reach mod server";
+        // Keep the compressed prefix so the next attempt resumes.
+        err = "Failed to download bundle for " + entry.id;
+        return false;
+    }
+    bool ok = unpacker->finish();
+    discard_partial(part);
+    if (!ok) {
+        err = unpacker->err;
+        return false;
+    }
+    unpacked = std::move(unpacker->entries);
+    return true;
+}
+
+// Applies a `/mods/delta/...` patch as it arrives: copy ops read from the
+// installed `base` file, literal ops come from the stream, and the result is
+// written to `out_path` while being hashed.
+struct DeltaApplier {
+    enum class Stage { Header, Op, CopyArgs, LiteralLen, LiteralBody, Done };
+
+    std::ifstream base;
+    std::uint64_t base_size{0};
+    std::uint64_t base_hash{0};
+    std::uint64_t target_size{0};
+    std::uint64_t target_hash{0};
+    ChunkedFileWriter writer;
+    std::array<char, kDownloadChunkBytes> copy_buffer{};
+    Stage stage{Stage::Header};
+    std::string field;
+    std::uint64_t literal_left{0};
+    std::string err;
+
+    bool fail(std::string message) {
+        if (err.empty())
+            err = std::move(message);
+        return false;
+    }
+
+    bool copy_from_base(std::uint64_t offset, std::uint32_t len) {
+        if (offset > base_size || len > base_size - offset)
+            return fail("Delta copy out of range");
+        base.clear();
+        base.seekg(static_cast<std::streamoff>(offset));
+        std::uint64_t left = len;
+        while (left > 0) {
+            std::size_t want = static_cast<std::size_t>(
+                std::min<std::uint64_t>(left, copy_buffer.size()));
+            base.read(copy_buffer.data(), static_cast<std::streamsize>(want));
+            if (base.gcount() != static_cast<std::streamsize>(want))
+                return fail("Failed to read delta base");
+            if (!writer.write(copy_buffer.data(), want))
+                return fail("Failed to write delta output");
+            left -= want;
+        }
+        return true;
+    }
+
+    bool feed(const char* p, std::size_t n) {
+        if (!err.empty())
+            return false;
+        while (n > 0) {
+            switch (stage) {
+            case Stage::Header:
+                if (!take_field(field, p, n, kModDeltaHeaderBytes))
+                    break;
+                if (field.compare(0, 4, kModDeltaMagic, 4) != 0 ||
+                    bundle_get_u32(field.data() + 4) != kModDeltaVersion)
+                    return fail("Unsupported delta format");
+                if (bundle_get_u64(field.data() + 8) != base_size ||
+                    bundle_get_u64(field.data() + 16) != base_hash ||
+                    bundle_get_u64(field.data() + 24) != target_size ||
+                    bundle_get_u64(field.data() + 32) != target_hash)
+                    return fail("Delta does not match the installed file");
+                field.clear();
+                stage = Stage::Op;
+                break;
+            case Stage::Op: {
+                std::uint8_t op = static_cast<std::uint8_t>(*p);
+                ++p;
+                --n;
+                if (op == kModDeltaOpEnd)
+                    stage = Stage::Done;
+                else if (op == kModDeltaOpCopy)
+                    stage = Stage::CopyArgs;
+                else if (op == kModDeltaOpLiteral)
+                    stage = Stage::LiteralLen;
+                else
+                    return fail("Corrupt delta op");
+                break;
+            }
+            case Stage::CopyArgs:
+                if (!take_field(field, p, n, kModDeltaCopyArgBytes))
+                    break;
+                if (!copy_from_base(bundle_get_u64(field.data()), bundle_get_u32(field.data() + 8)))
+                    return false;
+                field.clear();
+                stage = Stage::Op;
+                break;
+            case Stage::LiteralLen:
+                if (!take_field(field, p, n, 4))
+                    break;
+                literal_left = bundle_get_u32(field.data());
+                field.clear();
+                stage = literal_left == 0 ? Stage::Op : Stage::LiteralBody;
+                break;
+            case Stage::LiteralBody: {
+                std::size_t grab = static_cast<std::size_t>(
+                    std::min<std::uint64_t>(literal_left, n));
+                if (!writer.write(p, grab))
+                    return fail("Failed to write delta output");
+                p += grab;
+                n -= grab;
+                literal_left -= grab;
+                if (literal_left == 0)
+                    stage = Stage::Op;
+                break;
+            }
+            case Stage::Done:
+                return fail("Trailing data after delta");
+            }
+            if (writer.received > target_size)
+                return fail("Delta output too large");
+        }
+        return true;
+    }
+};
+
+// Updates `dest` in place from the delta between its current contents
+// (`base_hash`) and the catalog version. Returns false if the server has no
+// useful delta or the patch fails; the caller then downloads the whole file.
+bool download_delta(httplib::Client& client,
+                    const ModCatalogEntry& entry,
+                    const ModFileEntry& file,
+                    const std::string& base_hash,
+                    const fs::path& dest,
+                    InstallProgress& progress,
+                    std::string& err) {
+    fs::path tmp = dest;
+    tmp += ".delta.part";
+    std::error_code ec;
+    auto applier = std::make_unique<DeltaApplier>();
+    applier->writer.progress = &progress;
+    applier->base.open(dest, std::ios::binary);
+    applier->base_size = static_cast<std::uint64_t>(fs::file_size(dest, ec));
+    if (!applier->base.good() || ec || !applier->writer.open(tmp)) {
+        err = "Failed to prepare delta for " + file.path;
+        return false;
+    }
+    try {
+        applier->base_hash = std::stoull(base_hash, nullptr, 16);
+        applier->target_hash = std::stoull(file.hash, nullptr, 16);
+    } catch (...) {
+        applier->writer.out.close();
+        fs::remove(tmp, ec);
+        err = "Malformed hash for " + file.path;
+        return false;
+    }
+    applier->target_size = file.size_bytes;
+
+    int status = 0;
+    std::string url = std::string(kDeltaPrefix) + url_encode_path(entry.id) + "/" + base_hash +
+                      "/" + url_encode_path(file.path);
+    auto res = client.Get(
+        url,
+        [&](const httplib::Response& response) {
+            status = response.status;
+            return status == 200;
+        },
+        [&](const char* data, std::size_t len) { return applier->feed(data, len); });
+    bool flushed = applier->writer.flush();
+    applier->writer.out.close();
+    applier->base.close();
+
+    auto fail = [&](std::string message) {
+        fs::remove(tmp, ec);
+        err = std::move(message);
+        return false;
+    };
+    if (status != 200)
+        return fail("No delta for " + file.path);
+    if (!applier->err.empty())
+        return fail(applier->err);
+    if (!res || applier->stage != DeltaApplier::Stage::Done)
+        return fail("Delta download interrupted for " + file.path);
+    if (!flushed || applier->writer.received != file.size_bytes ||
+        applier->writer.hasher.digest() != applier->target_hash)
+        return fail("Delta produced a bad file for " + file.path);
+    fs::remove(dest, ec);
+    ec.clear();
+    fs::rename(tmp, dest, ec);
+    if (ec)
+        return fail("Failed to move " + tmp.string() + " into place");
+    return true;
+}
+
+// True when `target` already holds at least one file of `entry`, or the blob
+// store does; either way the per-file path avoids downloading those bytes.
+bool has_installed_files(const fs::path& target, const ModCatalogEntry& entry) {
+    std::error_code ec;
+    for (const auto& file : entry.files) {
+        if (!file.path.empty() && fs::is_regular_file(target / file.path, ec))
+            return true;
+        if (has_mod_blob(file.sha256))
+            return true;
+    }
+    return false;
+}
+
+// Removes files under `target` that are not part of the freshly installed
+// file list, left over from an older version of the mod.
+void prune_stale_files(const fs::path& target, std::vector<std::string> keep) {
+    std::sort(keep.begin(), keep.end());
+    std::vector<fs::path> stale;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(target, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec))
+            continue;
+        std::string rel = it->path().lexically_relative(target).generic_string();
+        if (!std::binary_search(keep.begin(), keep.end(), rel))
+            stale.push_back(it->path());
+    }
+    for (const auto& path : stale)
+        fs::remove(path, ec);
+}
+
+// Reads a `files` array (catalog entries from older servers, or the
+// `/mods/listing/<id>` response) into `out`.
+void parse_file_entries(const nlohmann::json& owner, std::vector<ModFileEntry>& out) {
+    auto files_it = owner.find("files");
+    if (files_it == owner.end() || !files_it->is_array())
+        return;
+    for (auto& f : *files_it) {
+        if (!f.is_object())
+            continue;
+        ModFileEntry fe;
+        fe.path = f.value("path", "");
+        fe.size_bytes = f.value("size_bytes", static_cast<std::uint64_t>(0));
+        fe.hash = f.value("hash", "");
+        fe.sha256 = f.value("sha256", "");
+        if (!fe.path.empty())
+            out.push_back(std::move(fe));
+    }
+}
+
+// The catalog no longer carries per-file listings; fetch them for one mod.
+bool fetch_file_listing(httplib::Client& client, ModCatalogEntry& entry, std::string& err) {
+    auto res = client.Get(std::string(kListingPrefix) + url_encode_path(entry.id));
+    if (!res) {
+        err = "Failed to fetch file list for " + entry.id;
         return false;
     }
     if (res->status != 200) {
-        err = "Catalog request failed with status " + std::to_string(res->status);
+        err = "File list request failed with status " + std::to_string(res->status);
         return false;
     }
     try {
         nlohmann::json root = nlohmann::json::parse(res->body);
+        entry.files.clear();
+        parse_file_entries(root, entry.files);
+        entry.content_hash = root.value("content_hash", entry.content_hash);
+        entry.total_bytes = root.value("size_bytes", entry.total_bytes);
+    } catch (const std::exception& e) {
+        err = e.what();
+        return false;
+    }
+    return true;
+}
+
+// Rediscovers mods without touching anyone's enabled state: `discover_mods`
+// re-reads flags from the config, so they are reset to what is running now
+// and the `set_active_mods` that follows does not rebuild every asset.
+void rediscover_keeping_active(const std::vector<std::string>& active) {
+    discover_mods();
+    for (auto& mod : mm->mods)
+        mod.enabled = std::find(active.begin(), active.end(), mod.name) != active.end();
+}
+
+} // namespace
+
+fs::path mod_install_path(const ModCatalogEntry& entry) {
+    std::string folder = entry.folder.empty() ? entry.id : entry.folder;
+    if (folder.empty())
+        folder = entry.id;
+    return mods_root_path() / folder;
+}
+
+bool parse_mod_catalog(const std::string& body,
+                       std::vector<ModCatalogEntry>& out,
+                       std::string& err) {
+    try {
+        nlohmann::json root = nlohmann::json::parse(body);
         auto mods_it = root.find("mods");
         if (mods_it == root.end() || !mods_it->is_array()) {
             err = "Malformed catalog response";
@@ -161,6 +1009,7 @@ bool fetch_mod_catalog(const std::string& server_url,
             cat.required = entry.value("required", false);
             cat.game_version = entry.value("game_version", "");
             cat.total_bytes = entry.value("size_bytes", static_cast<std::uint64_t>(0));
+            cat.content_hash = entry.value("content_hash", "");
             if (entry.contains("dependencies") && entry["dependencies"].is_array()) {
                 for (auto& dep : entry["dependencies"]) {
                     if (dep.is_string())
@@ -173,17 +1022,7 @@ bool fetch_mod_catalog(const std::string& server_url,
                         cat.apis.push_back(api.get<std::string>());
                 }
             }
-            if (entry.contains("files") && entry["files"].is_array()) {
-                for (auto& f : entry["files"]) {
-                    if (!f.is_object())
-                        continue;
-                    ModFileEntry fe;
-                    fe.path = f.value("path", "");
-                    fe.size_bytes = f.value("size_bytes", static_cast<std::uint64_t>(0));
-                    if (!fe.path.empty())
-                        cat.files.push_back(std::move(fe));
-                }
-            }
+            parse_file_entries(entry, cat.files);
             if (!cat.id.empty())
                 out.push_back(std::move(cat));
         }
@@ -194,81 +1033,169 @@ bool fetch_mod_catalog(const std::string& server_url,
     }
 }
 
-bool install_mod_from_catalog(const std::string& server_url,
-                              const ModCatalogEntry& entry,
-                              std::string& err) {
+bool fetch_mod_catalog_if_changed(const std::string& server_url,
+                                  const std::string& etag,
+                                  ModCatalogFetch& out,
+                                  std::string& err) {
     EndpointInfo endpoint;
     if (!parse_http_endpoint(server_url, endpoint, err))
         return false;
-    if (entry.id.empty()) {
+    httplib::Client client(endpoint.host, endpoint.port);
+    client.set_read_timeout(5, 0);
+    httplib::Headers headers;
+    if (!etag.empty())
+        headers.emplace("If-None-Match", etag);
+    auto res = client.Get(kCatalogPath, headers);
+    if (!res) {
+        err = "Failed to reach mod server";
+        return false;
+    }
+    out.not_modified = res->status == 304 && !etag.empty();
+    if (out.not_modified) {
+        out.etag = etag;
+        return true;
+    }
+    if (res->status != 200) {
+        err = "Catalog request failed with status " + std::to_string(res->status);
+        return false;
+    }
+    if (!parse_mod_catalog(res->body, out.entries, err))
+        return false;
+    out.etag = res->get_header_value("ETag");
+    out.body = std::move(res->body);
+    return true;
+}
+
+bool download_mod_from_catalog(const std::string& server_url,
+                               const ModCatalogEntry& catalog_entry,
+                               const fs::path& target,
+                               const ModInstallProgressFn& on_progress,
+                               std::string& err) {
+    EndpointInfo endpoint;
+    if (!parse_http_endpoint(server_url, endpoint, err))
+        return false;
+    if (catalog_entry.id.empty()) {
         err = "Catalog entry missing id";
         return false;
     }
     httplib::Client client(endpoint.host, endpoint.port);
-    client.set_read_timeout(5, 0);
+    client.set_read_timeout(30, 0);
+    ModCatalogEntry entry = catalog_entry;
+    if (entry.files.empty() && !fetch_file_listing(client, entry, err))
+        return false;
 
-    fs::path target = local_mod_path(entry);
+    InstallProgress progress;
+    progress.fn = &on_progress;
+    progress.total = entry.total_bytes;
+    if (progress.total == 0) {
+        for (const auto& file : entry.files)
+            progress.total += file.size_bytes;
+    }
+    progress.report(true);
+    if (progress.cancelled) {
+        err = "Install cancelled";
+        return false;
+    }
+
+    // The existing folder is kept so partial downloads from an interrupted
+    // install can be resumed; stale files are pruned once the install lands.
     std::error_code ec;
-    if (fs::exists(target, ec))
-        fs::remove_all(target, ec);
-    ec.clear();
     if (!fs::create_directories(target, ec) && ec) {
         err = "Failed to create mod directory: " + target.string();
         return false;
     }
 
-    auto active = get_active_mod_ids();
-
-    for (const auto& file : entry.files) {
-        if (file.path.empty())
-            continue;
-        fs::path dest = target / file.path;
-        if (!ensure_parent_dirs(dest, err))
-            return false;
-        std::string url = std::string(kFilesPrefix) + entry.id + "/" + url_encode_path(file.path);
-        auto res = client.Get(url.c_str());
-        if (!res) {
-            err = "Failed to download " + file.path;
-            return false;
-        }
-        if (res->status != 200) {
-            err = "Download failed (" + std::to_string(res->status) + ") for " + file.path;
-            return false;
-        }
-        std::ofstream out(dest, std::ios::binary);
-        if (!out.good()) {
-            err = "Failed to write " + dest.string();
+    // Fresh installs (or resumed bundle installs) take the whole bundle.
+    // Updates over an existing install go file by file so unchanged files are
+    // skipped, files already in the blob store are linked without a download,
+    // and changed ones can be patched from the local copy.
+    bool served = false;
+    std::vector<std::string> installed;
+    bool updating = has_installed_files(target, entry) && !fs::exists(target / kBundlePartName, ec);
+    if (updating || !download_bundle(client, entry, target, served, installed, progress, err)) {
+        if (served)
             return false;
+        progress.rewind(0);
+        for (const auto& file : entry.files) {
+            if (file.path.empty())
+                continue;
+            fs::path dest = target / file.path;
+            if (!ensure_parent_dirs(dest, err))
+                return false;
+            std::string local_hash;
+            std::uint64_t progress_mark = progress.mark();
+            if (!file.hash.empty() && fs::is_regular_file(dest, ec) &&
+                content_hash_file(dest, local_hash)) {
+                if (local_hash == file.hash) {
+                    (void)progress.add(file.size_bytes);
+                    installed.push_back(file.path);
+                    continue;
+                }
+            }
+            if (link_mod_blob(file.sha256, file.size_bytes, dest)) {
+                (void)progress.add(file.size_bytes);
+                installed.push_back(file.path);
+                continue;
+            }
+            if (!local_hash.empty()) {
+                std::string delta_err;
+                if (download_delta(client, entry, file, local_hash, dest, progress, delta_err)) {
+                    installed.push_back(file.path);
+                    continue;
+                }
+                progress.rewind(progress_mark);
+            }
+            std::string url = std::string(kFilesPrefix) + entry.id + "/" + url_encode_path(file.path);
+            if (!download_file(client, url, file, dest, progress, err))
+                return false;
+            installed.push_back(file.path);
         }
-        out << res->body;
     }
-
-    refresh_runtime(active);
+    prune_stale_files(target, std::move(installed));
+    for (const auto& file : entry.files) {
+        if (!file.path.empty())
+            store_mod_blob(target / file.path);
+    }
+    progress.report(true);
     return true;
 }
 
-bool uninstall_mod(const ModCatalogEntry& entry, std::string& err) {
+void commit_mod_install(const ModCatalogEntry& entry) {
+    if (!mm)
+        return;
+    auto active = get_active_mod_ids();
+    rediscover_keeping_active(active);
+    load_textures_for_sprite_ids(sync_mod_sprite_defs(entry.id));
+    load_sounds_for_mod(mod_install_path(entry));
+    set_active_mods(active);
+}
+
+bool remove_mod_files(const ModCatalogEntry& entry, const fs::path& root, std::string& err) {
     if (entry.id.empty()) {
         err = "Missing mod id";
         return false;
     }
-    fs::path root = local_mod_path(entry);
     std::error_code ec;
     if (!fs::exists(root, ec)) {
         err = "Mod not installed: " + root.string();
         return false;
     }
-
-    auto active = get_active_mod_ids();
-    active.erase(std::remove(active.begin(), active.end(), entry.id), active.end());
-    deactivate_mod(entry.id);
-
     fs::remove_all(root, ec);
     if (ec) {
         err = "Failed to remove " + root.string();
         return false;
     }
-
-    refresh_runtime(active);
+    // Blobs only this mod used stay around for a reinstall, within a budget.
+    prune_mod_blobs(kUnlinkedBlobKeepBytes);
     return true;
 }
+
+void commit_mod_uninstall(const ModCatalogEntry& entry) {
+    if (!mm)
+        return;
+    auto active = get_active_mod_ids();
+    rediscover_keeping_active(active);
+    sync_mod_sprite_defs(entry.id);
+    unload_sounds_with_prefix(mod_install_path(entry).filename().string() + ":");
+    set_active_mods(active);
+}
@@ -2,15 +2,56 @@
 
 #include "engine/mods.hpp"
 
+#include <cstdint>
+#include <filesystem>
+#include <functional>
 #include <string>
 #include <vector>
 
-bool fetch_mod_catalog(const std::string& server_url,
+struct ModCatalogFetch {
+    bool not_modified{false}; // server answered 304 for the ETag we sent
+    std::string etag;
+    std::string body;         // raw catalog JSON, kept for the disk cache
+    std::vector<ModCatalogEntry> entries;
+};
+
+// Called from whichever thread runs the download with bytes written so far
+// and the mod's total size (0 when the server did not publish one). Return
+// false to abort the install.
+using ModInstallProgressFn = std::function<bool(std::uint64_t done, std::uint64_t total)>;
+
+bool parse_mod_catalog(const std::string& body,
                        std::vector<ModCatalogEntry>& out,
                        std::string& err);
 
-bool install_mod_from_catalog(const std::string& server_url,
-                              const ModCatalogEntry& entry,
-                              std::string& err);
+// Conditional catalog GET: sends `If-None-Match: etag` when `etag` is set.
+// Safe to call from a worker thread.
+bool fetch_mod_catalog_if_changed(const std::string& server_url,
+                                  const std::string& etag,
+                                  ModCatalogFetch& out,
+                                  std::string& err);
+
+// The folder `entry` installs into under the current mods root. Reads the
+// mods runtime, so call it on the main thread and hand the result to the
+// worker-side functions below.
+std::filesystem::path mod_install_path(const ModCatalogEntry& entry);
+
+// Network and disk half of an install: fetches the mod into `target` (from
+// mod_install_path). Touches no runtime state, so it may run on a worker
+// thread.
+bool download_mod_from_catalog(const std::string& server_url,
+                               const ModCatalogEntry& entry,
+                               const std::filesystem::path& target,
+                               const ModInstallProgressFn& on_progress,
+                               std::string& err);
+
+// Main-thread half of an install: rediscovers mods and loads only this mod's
+// sprites and sounds. Active mods stay active; nothing else is rebuilt.
+void commit_mod_install(const ModCatalogEntry& entry);
+
+// Deletes the mod folder `root` (from mod_install_path). Worker-safe;
+// deactivate the mod first.
+bool remove_mod_files(const ModCatalogEntry& entry, const std::filesystem::path& root, std::string& err);
 
-bool uninstall_mod(const ModCatalogEntry& entry, std::string& err);
+// Main-thread half of an uninstall: drops the mod's sprites and sounds.
+void commit_mod_uninstall(const ModCatalogEntry& entry);
@@ -0,0 +1,222 @@
+#include "engine/mod_jobs.hpp"
+
+#include "engine/mod_host.hpp"
+#include "engine/mod_install.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kEventRingSize = 256;
+
+struct ModJob {
+    std::uint64_t id{0};
+    ModJobKind kind{ModJobKind::Install};
+    std::string server_url;
+    ModCatalogEntry entry;
+    std::filesystem::path target; // mod folder, resolved on the main thread
+    bool ok{false};
+    std::string err;
+};
+
+// `queued` feeds the worker, `finished` waits for the main-thread commit.
+// `events` is a ring indexed by sequence number; `event_head` is the next
+// sequence to be written. `outcomes` keeps each committed job's final event.
+struct ModJobs {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<ModJob> queued;
+    std::vector<ModJob> finished;
+    std::vector<std::string> pending_ids; // one per queued/running/finished job
+    std::vector<ModJobEvent> events;
+    std::uint64_t event_head{0};
+    std::unordered_map<std::uint64_t, ModJobEvent> outcomes;
+    std::uint64_t next_job_id{1};
+    bool stopping{false};
+    std::thread worker;
+};
+
+ModJobs g_jobs;
+
+// Caller holds g_jobs.mutex.
+void push_event_locked(const ModJob& job,
+                       ModJobStage stage,
+                       std::uint64_t done = 0,
+                       std::uint64_t total = 0,
+                       const std::string& message = {}) {
+    if (g_jobs.events.empty())
+        g_jobs.events.resize(kEventRingSize);
+    ModJobEvent& ev = g_jobs.events[g_jobs.event_head % kEventRingSize];
+    ev.job_id = job.id;
+    ev.kind = job.kind;
+    ev.stage = stage;
+    ev.mod_id = job.entry.id;
+    ev.bytes_done = done;
+    ev.bytes_total = total;
+    ev.message = message;
+    g_jobs.event_head += 1;
+    if (stage == ModJobStage::Done || stage == ModJobStage::Failed)
+        g_jobs.outcomes[job.id] = ev;
+}
+
+void push_event(const ModJob& job,
+                ModJobStage stage,
+                std::uint64_t done = 0,
+                std::uint64_t total = 0,
+                const std::string& message = {}) {
+    std::lock_guard<std::mutex> lock(g_jobs.mutex);
+    push_event_locked(job, stage, done, total, message);
+}
+
+void run_job(ModJob& job) {
+    push_event(job, ModJobStage::Downloading);
+    if (job.kind == ModJobKind::Uninstall) {
+        job.ok = remove_mod_files(job.entry, job.target, job.err);
+        return;
+    }
+    auto on_progress = [&job](std::uint64_t done, std::uint64_t total) {
+        std::lock_guard<std::mutex> lock(g_jobs.mutex);
+        push_event_locked(job, ModJobStage::Downloading, done, total);
+        return !g_jobs.stopping;
+    };
+    job.ok = download_mod_from_catalog(job.server_url, job.entry, job.target, on_progress, job.err);
+}
+
+void worker_loop() {
+    for (;;) {
+        ModJob job;
+        {
+            std::unique_lock<std::mutex> lock(g_jobs.mutex);
+            g_jobs.wake.wait(lock, [] { return g_jobs.stopping || !g_jobs.queued.empty(); });
+            if (g_jobs.stopping)
+                return;
+            job = std::move(g_jobs.queued.front());
+            g_jobs.queued.pop_front();
+        }
+        run_job(job);
+        std::lock_guard<std::mutex> lock(g_jobs.mutex);
+        g_jobs.finished.push_back(std::move(job));
+    }
+}
+
+// Main thread: the target folder is resolved here because the worker must
+// not read the mods runtime.
+std::uint64_t enqueue(ModJobKind kind, const std::string& server_url, const ModCatalogEntry& entry) {
+    std::filesystem::path target = mod_install_path(entry);
+    std::lock_guard<std::mutex> lock(g_jobs.mutex);
+    if (!g_jobs.worker.joinable()) {
+        g_jobs.stopping = false;
+        g_jobs.worker = std::thread(worker_loop);
+    }
+    ModJob job;
+    job.id = g_jobs.next_job_id++;
+    job.kind = kind;
+    job.server_url = server_url;
+    job.entry = entry;
+    job.target = std::move(target);
+    push_event_locked(job, ModJobStage::Queued);
+    g_jobs.pending_ids.push_back(entry.id);
+    g_jobs.queued.push_back(std::move(job));
+    g_jobs.wake.notify_one();
+    return g_jobs.next_job_id - 1;
+}
+
+} // namespace
+
+std::uint64_t queue_mod_install(const std::string& server_url, const ModCatalogEntry& entry) {
+    return enqueue(ModJobKind::Install, server_url, entry);
+}
+
+std::uint64_t queue_mod_uninstall(const ModCatalogEntry& entry) {
+    // Scripts must stop before their files disappear.
+    deactivate_mod(entry.id);
+    return enqueue(ModJobKind::Uninstall, std::string(), entry);
+}
+
+void pump_mod_jobs() {
+    std::vector<ModJob> done;
+    {
+        std::lock_guard<std::mutex> lock(g_jobs.mutex);
+        if (g_jobs.finished.empty())
+            return;
+        done.swap(g_jobs.finished);
+    }
+    for (auto& job : done) {
+        if (job.ok) {
+            push_event(job, ModJobStage::Committing);
+            if (job.kind == ModJobKind::Install)
+                commit_mod_install(job.entry);
+            else
+                commit_mod_uninstall(job.entry);
+            push_event(job, ModJobStage::Done);
+        } else {
+            std::printf("[mods] %s of %s failed: %s\n",
+                        job.kind == ModJobKind::Install ? "Install" : "Uninstall",
+                        job.entry.id.c_str(), job.err.c_str());
+            push_event(job, ModJobStage::Failed, 0, 0, job.err);
+        }
+        std::lock_guard<std::mutex> lock(g_jobs.mutex);
+        auto it = std::find(g_jobs.pending_ids.begin(), g_jobs.pending_ids.end(), job.entry.id);
+        if (it != g_jobs.pending_ids.end())
+            g_jobs.pending_ids.erase(it);
+    }
+}
+
+bool next_mod_job_event(std::uint64_t& cursor, ModJobEvent& out) {
+    std::lock_guard<std::mutex> lock(g_jobs.mutex);
+    if (cursor >= g_jobs.event_head)
+        return false;
+    if (g_jobs.event_head - cursor > kEventRingSize)
+        cursor = g_jobs.event_head - kEventRingSize;
+    out = g_jobs.events[cursor % kEventRingSize];
+    cursor += 1;
+    return true;
+}
+
+std::uint64_t mod_job_events_head() {
+    std::lock_guard<std::mutex> lock(g_jobs.mutex);
+    return g_jobs.event_head;
+}
+
+bool mod_job_outcome(std::uint64_t job_id, ModJobEvent& out) {
+    std::lock_guard<std::mutex> lock(g_jobs.mutex);
+    auto it = g_jobs.outcomes.find(job_id);
+    if (it == g_jobs.outcomes.end())
+        return false;
+    out = it->second;
+    return true;
+}
+
+bool mod_job_pending(const std::string& mod_id) {
+    std::lock_guard<std::mutex> lock(g_jobs.mutex);
+    return std::find(g_jobs.pending_ids.begin(), g_jobs.pending_ids.end(), mod_id) !=
+           g_jobs.pending_ids.end();
+}
+
+bool mod_jobs_idle() {
+    std::lock_guard<std::mutex> lock(g_jobs.mutex);
+    return g_jobs.pending_ids.empty();
+}
+
+void shutdown_mod_jobs() {
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(g_jobs.mutex);
+        g_jobs.stopping = true;
+        g_jobs.queued.clear();
+        g_jobs.finished.clear();
+        g_jobs.pending_ids.clear();
+        worker = std::move(g_jobs.worker);
+    }
+    g_jobs.wake.notify_all();
+    if (worker.joinable())
+        worker.join();
+}
@@ -0,0 +1,64 @@
+// Mod install jobs.
+// Responsibility: run mod downloads and removals on a worker thread so the
+// UI keeps drawing, publish typed progress events that any screen can poll,
+// and apply finished jobs to the runtime with a cheap main-thread commit.
+#pragma once
+
+#include "engine/mods.hpp"
+
+#include <cstdint>
+#include <string>
+
+enum class ModJobKind {
+    Install,
+    Uninstall
+};
+
+enum class ModJobStage {
+    Queued,
+    Downloading, // also used for the folder removal of an uninstall
+    Committing,
+    Done,
+    Failed
+};
+
+struct ModJobEvent {
+    std::uint64_t job_id{0};
+    ModJobKind kind{ModJobKind::Install};
+    ModJobStage stage{ModJobStage::Queued};
+    std::string mod_id;
+    std::uint64_t bytes_done{0};
+    std::uint64_t bytes_total{0}; // 0 when unknown
+    std::string message;          // error text for Failed
+};
+
+// Jobs run one at a time in queue order, so queueing dependencies before the
+// mods that need them installs them first. Returns the job id.
+std::uint64_t queue_mod_install(const std::string& server_url, const ModCatalogEntry& entry);
+
+// Deactivates the mod right away (main thread), then removes its folder on
+// the worker. Returns the job id.
+std::uint64_t queue_mod_uninstall(const ModCatalogEntry& entry);
+
+// Main thread, once per frame: commits finished jobs to the runtime.
+void pump_mod_jobs();
+
+// Events are kept in a small ring. Each reader owns a cursor; start it at
+// `mod_job_events_head()` to see only new events. Returns false when the
+// reader is caught up. A reader that falls too far behind skips ahead.
+bool next_mod_job_event(std::uint64_t& cursor, ModJobEvent& out);
+std::uint64_t mod_job_events_head();
+
+// The Done or Failed event of a committed job. A burst of progress events
+// can push a job's final event out of the ring before a slow reader gets to
+// it; outcomes are kept per job instead, so code that must not miss a
+// failure checks here. Returns false while the job is still in flight.
+bool mod_job_outcome(std::uint64_t job_id, ModJobEvent& out);
+
+// True while a job for `mod_id` is queued, running or awaiting commit.
+bool mod_job_pending(const std::string& mod_id);
+bool mod_jobs_idle();
+
+// Drops queued jobs, aborts the running download (partial files are kept
+// for the next attempt) and joins the worker; called on shutdown.
+void shutdown_mod_jobs();
@@ -0,0 +1,196 @@
+#include "engine/mod_script_cache.hpp"
+
+#include "engine/data.hpp"
+#include "engine/sha256.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <lua.hpp>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* kCacheDirName = "lua_cache";
+constexpr const char* kCacheSuffix = ".luac";
+constexpr const char* kCacheTmpSuffix = ".luac.part";
+
+// Each entry is this magic, the SHA-256 of the bytecode that follows, then
+// the bytecode. Lua runs bytecode unverified, so a truncated or bit-rotted
+// entry must never reach luaL_loadbufferx. This only catches corruption:
+// anyone who can rewrite an entry can recompute its header too.
+constexpr char kEntryMagic[8] = {'G', 'U', 'B', 'L', 'U', 'A', 'C', '1'};
+constexpr std::size_t kEntryHeaderBytes = sizeof(kEntryMagic) + Sha256Hasher::Digest{}.size();
+
+// Mods activate on several threads at once; each load runs on one of them.
+std::atomic<std::uint64_t> g_hits{0};
+std::atomic<std::uint64_t> g_misses{0};
+
+// Bytecode depends on the Lua release and on integer, number and pointer
+// widths, so each build gets its own directory.
+fs::path cache_dir() {
+#ifdef LUA_VERSION_RELEASE_NUM
+    long release = LUA_VERSION_RELEASE_NUM;
+#else
+    long release = LUA_VERSION_NUM;
+#endif
+    std::string tag = std::to_string(release) + "-i" + std::to_string(sizeof(lua_Integer) * 8) + "-n" +
+                      std::to_string(sizeof(lua_Number) * 8) + "-p" + std::to_string(sizeof(void*) * 8);
+    return fs::path(DATA_FOLDER_PATH) / kCacheDirName / tag;
+}
+
+bool read_file(const fs::path& path, std::string& out) {
+    std::error_code ec;
+    std::uintmax_t size = fs::file_size(path, ec);
+    std::ifstream in(path, std::ios::binary);
+    if (ec || !in)
+        return false;
+    out.resize(static_cast<std::size_t>(size));
+    in.read(out.data(), static_cast<std::streamsize>(out.size()));
+    out.resize(static_cast<std::size_t>(in.gcount()));
+    return !in.bad();
+}
+
+Sha256Hasher::Digest bytecode_digest(const char* data, std::size_t size) {
+    Sha256Hasher hasher;
+    hasher.update(data, size);
+    return hasher.digest();
+}
+
+// Checks the header of a cache entry; on success `payload`/`payload_size`
+// span the verified bytecode.
+bool unwrap_entry(const std::string& entry, const char*& payload, std::size_t& payload_size) {
+    if (entry.size() <= kEntryHeaderBytes || std::memcmp(entry.data(), kEntryMagic, sizeof(kEntryMagic)) != 0)
+        return false;
+    payload = entry.data() + kEntryHeaderBytes;
+    payload_size = entry.size() - kEntryHeaderBytes;
+    Sha256Hasher::Digest digest = bytecode_digest(payload, payload_size);
+    return std::memcmp(entry.data() + sizeof(kEntryMagic), digest.data(), digest.size()) == 0;
+}
+
+int append_chunk(lua_State*, const void* data, std::size_t size, void* ud) {
+    static_cast<std::string*>(ud)->append(static_cast<const char*>(data), size);
+    return 0;
+}
+
+// Written beside the final name and renamed over it, so a crash mid-write
+// never leaves a truncated entry for the next run to trip over.
+void store_bytecode(const fs::path& path, const std::string& bytecode) {
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    fs::path tmp = path;
+    tmp.replace_extension(kCacheTmpSuffix);
+    Sha256Hasher::Digest digest = bytecode_digest(bytecode.data(), bytecode.size());
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(kEntryMagic, sizeof(kEntryMagic));
+        out.write(reinterpret_cast<const char*>(digest.data()), static_cast<std::streamsize>(digest.size()));
+        out.write(bytecode.data(), static_cast<std::streamsize>(bytecode.size()));
+        if (!out.good()) {
+            out.close();
+            fs::remove(tmp, ec);
+            return;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec)
+        fs::remove(tmp, ec);
+}
+
+} // namespace
+
+bool load_mod_script(lua_State* L, const fs::path& source, std::string& err) {
+    std::string text;
+    if (!read_file(source, text)) {
+        err = "failed to read " + source.string();
+        return false;
+    }
+    // "@path" makes Lua report errors against the file name; it is baked into
+    // the bytecode's debug info, so it is part of the key too. The key is a
+    // SHA-256 because a mod that could craft a collision with another mod's
+    // script would get its bytecode run in that script's place. A path holds
+    // no NUL, so the separator keeps (name, source) pairs apart.
+    std::string chunkname = "@" + source.string();
+    Sha256Hasher hasher;
+    hasher.update(chunkname.data(), chunkname.size());
+    hasher.update("", 1);
+    hasher.update(text.data(), text.size());
+    fs::path cached = cache_dir() / (sha256_hex(hasher.digest()) + kCacheSuffix);
+
+    std::string bytecode;
+    if (read_file(cached, bytecode) && !bytecode.empty()) {
+        const char* payload = nullptr;
+        std::size_t payload_size = 0;
+        if (unwrap_entry(bytecode, payload, payload_size)) {
+            if (luaL_loadbufferx(L, payload, payload_size, chunkname.c_str(), "b") == LUA_OK) {
+                g_hits.fetch_add(1, std::memory_order_relaxed);
+                // Pruning goes oldest-first by write time; keep live entries young.
+                std::error_code ec;
+                fs::last_write_time(cached, fs::file_time_type::clock::now(), ec);
+                return true;
+            }
+            lua_pop(L, 1);
+        }
+        std::printf("[mods] Dropping damaged bytecode cache entry %s\n", cached.string().c_str());
+        std::error_code ec;
+        fs::remove(cached, ec);
+    }
+
+    g_misses.fetch_add(1, std::memory_order_relaxed);
+    if (luaL_loadbufferx(L, text.data(), text.size(), chunkname.c_str(), "t") != LUA_OK) {
+        const char* msg = lua_tostring(L, -1);
+        err = msg ? msg : "compile error";
+        lua_pop(L, 1);
+        return false;
+    }
+    // Keep debug info (strip = 0) so runtime errors still carry line numbers.
+    bytecode.clear();
+    if (lua_dump(L, append_chunk, &bytecode, 0) == 0 && !bytecode.empty())
+        store_bytecode(cached, bytecode);
+    return true;
+}
+
+ModScriptCacheStats mod_script_cache_stats() {
+    ModScriptCacheStats stats;
+    stats.hits = g_hits.load(std::memory_order_relaxed);
+    stats.misses = g_misses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::uint64_t prune_mod_script_cache(std::uint64_t keep_bytes) {
+    struct Entry {
+        fs::path path;
+        std::uint64_t size;
+        fs::file_time_type time;
+    };
+    std::vector<Entry> entries;
+    std::error_code ec;
+    fs::path root = fs::path(DATA_FOLDER_PATH) / kCacheDirName;
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code file_ec;
+        if (!it->is_regular_file(file_ec))
+            continue;
+        std::uintmax_t size = fs::file_size(it->path(), file_ec);
+        fs::file_time_type time = fs::last_write_time(it->path(), file_ec);
+        if (!file_ec)
+            entries.push_back({it->path(), static_cast<std::uint64_t>(size), time});
+    }
+    ec.clear();
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time > b.time; });
+    std::uint64_t kept = 0;
+    std::uint64_t freed = 0;
+    for (const auto& entry : entries) {
+        if (kept + entry.size <= keep_bytes) {
+            kept += entry.size;
+            continue;
+        }
+        if (fs::remove(entry.path, ec))
+            freed += entry.size;
+    }
+    return freed;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+struct lua_State;
+
+// Compiled mod scripts, cached on disk as Lua bytecode.
+//
+// Entries live under `data/lua_cache/<lua build>/` keyed by the SHA-256 of
+// the source and its chunk name, so an unchanged script is never lexed or
+// compiled again (across hot reloads and across runs), and an edited one
+// simply misses. The directory name carries the Lua release and word sizes,
+// because bytecode is only loadable by the build that wrote it. Lua does not
+// verify bytecode, so each entry carries a SHA-256 of its payload and one
+// that fails the check is deleted and recompiled. That check detects
+// corruption only; it is no defense against someone who can write to the
+// cache directory, since they can recompute the header as well.
+
+struct ModScriptCacheStats {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+};
+
+// Pushes the compiled chunk for `source` onto the Lua stack. On failure
+// nothing is pushed and `err` holds the compile or read error.
+bool load_mod_script(lua_State* L, const std::filesystem::path& source, std::string& err);
+
+// Safe to call while mods activate on worker threads.
+ModScriptCacheStats mod_script_cache_stats();
+
+// Drops the oldest entries until the cache is at most `keep_bytes`.
+// Returns the bytes freed.
+std::uint64_t prune_mod_script_cache(std::uint64_t keep_bytes);
@@ -0,0 +1,366 @@
+#include "engine/mod_state.hpp"
+
+#include "engine/mod_api_registry.hpp"
+#include "engine/mod_bundle.hpp"
+#include "engine/mod_host.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+#include <lua.hpp>
+#include <sol/sol.hpp>
+
+namespace {
+
+constexpr const char* kLuaSection = "lua";
+constexpr int kMaxTableDepth = 32;
+
+// Encoded Lua values: a tag byte, then the payload.
+constexpr std::uint8_t kTagNil = 0;
+constexpr std::uint8_t kTagFalse = 1;
+constexpr std::uint8_t kTagTrue = 2;
+constexpr std::uint8_t kTagInteger = 3; // u64
+constexpr std::uint8_t kTagNumber = 4;  // f64
+constexpr std::uint8_t kTagString = 5;  // u32 len, bytes
+constexpr std::uint8_t kTagTable = 6;   // u32 count, count key/value pairs
+
+void put_section(std::string& out, const std::string& name, const std::string& bytes) {
+    bundle_put_u32(out, static_cast<std::uint32_t>(name.size()));
+    out += name;
+    bundle_put_u32(out, static_cast<std::uint32_t>(bytes.size()));
+    out += bytes;
+}
+
+// Appends the value at `idx`; false (nothing usable written) for functions,
+// userdata, threads, tables nested too deep, and tables already written.
+// `visited` is the stack index of a table keyed by every table encoded so
+// far. The format has no references; without it `t.a = t; t.b = t` would
+// expand to ~2^32 nodes before the depth cap, and shared subtables repeat.
+bool encode_lua_value(lua_State* L, int idx, ModStateWriter& w, int depth, int visited) {
+    switch (lua_type(L, idx)) {
+    case LUA_TNIL:
+        w.put_u8(kTagNil);
+        return true;
+    case LUA_TBOOLEAN:
+        w.put_u8(lua_toboolean(L, idx) ? kTagTrue : kTagFalse);
+        return true;
+    case LUA_TNUMBER:
+        if (lua_isinteger(L, idx)) {
+            w.put_u8(kTagInteger);
+            w.put_u64(static_cast<std::uint64_t>(lua_tointeger(L, idx)));
+        } else {
+            w.put_u8(kTagNumber);
+            w.put_f64(static_cast<double>(lua_tonumber(L, idx)));
+        }
+        return true;
+    case LUA_TSTRING: {
+        std::size_t len = 0;
+        const char* s = lua_tolstring(L, idx, &len);
+        w.put_u8(kTagString);
+        w.put_u32(static_cast<std::uint32_t>(len));
+        w.bytes.append(s, len);
+        return true;
+    }
+    case LUA_TTABLE: {
+        if (depth >= kMaxTableDepth || !lua_checkstack(L, 3))
+            return false;
+        idx = lua_absindex(L, idx);
+        lua_pushvalue(L, idx);
+        bool seen = lua_rawget(L, visited) != LUA_TNIL;
+        lua_pop(L, 1);
+        if (seen)
+            return false;
+        lua_pushvalue(L, idx);
+        lua_pushboolean(L, 1);
+        lua_rawset(L, visited);
+        w.put_u8(kTagTable);
+        std::size_t count_at = w.bytes.size();
+        w.put_u32(0);
+        std::uint32_t count = 0;
+        lua_pushnil(L);
+        while (lua_next(L, idx) != 0) {
+            // Pairs with a key or value that cannot be encoded are dropped.
+            std::size_t mark = w.bytes.size();
+            if (encode_lua_value(L, -2, w, depth + 1, visited) && encode_lua_value(L, -1, w, depth + 1, visited))
+                count += 1;
+            else
+                w.bytes.resize(mark);
+            lua_pop(L, 1);
+        }
+        std::string patch;
+        bundle_put_u32(patch, count);
+        w.bytes.replace(count_at, 4, patch);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool valid_table_key(lua_State* L, int idx) {
+    if (lua_isnil(L, idx))
+        return false;
+    if (lua_type(L, idx) == LUA_TNUMBER && !lua_isinteger(L, idx))
+        return !std::isnan(static_cast<double>(lua_tonumber(L, idx)));
+    return true;
+}
+
+// Pushes exactly one value on success and nothing on failure.
+bool decode_lua_value(lua_State* L, ModStateReader& r, int depth) {
+    if (!lua_checkstack(L, 3))
+        return false;
+    std::uint8_t tag = r.get_u8();
+    if (!r.ok)
+        return false;
+    switch (tag) {
+    case kTagNil:
+        lua_pushnil(L);
+        return true;
+    case kTagFalse:
+    case kTagTrue:
+        lua_pushboolean(L, tag == kTagTrue);
+        return true;
+    case kTagInteger: {
+        auto v = static_cast<lua_Integer>(r.get_u64());
+        if (!r.ok)
+            return false;
+        lua_pushinteger(L, v);
+        return true;
+    }
+    case kTagNumber: {
+        double v = r.get_f64();
+        if (!r.ok)
+            return false;
+        lua_pushnumber(L, static_cast<lua_Number>(v));
+        return true;
+    }
+    case kTagString: {
+        std::uint32_t len = r.get_u32();
+        if (!r.ok || len > r.size - r.pos)
+            return false;
+        lua_pushlstring(L, r.data + r.pos, len);
+        r.pos += len;
+        return true;
+    }
+    case kTagTable: {
+        std::uint32_t count = r.get_u32();
+        if (!r.ok || depth >= kMaxTableDepth)
+            return false;
+        lua_createtable(L, 0, static_cast<int>(std::min<std::uint32_t>(count, 1024)));
+        for (std::uint32_t i = 0; i < count; ++i) {
+            if (!decode_lua_value(L, r, depth + 1)) {
+                lua_pop(L, 1);
+                return false;
+            }
+            if (!decode_lua_value(L, r, depth + 1)) {
+                lua_pop(L, 2);
+                return false;
+            }
+            if (valid_table_key(L, -2))
+                lua_rawset(L, -3);
+            else
+                lua_pop(L, 2);
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void save_script_state(ModContext& ctx, std::string& out) {
+    sol::protected_function save = (*ctx.lua)["save_state"];
+    if (!save.valid())
+        return;
+    sol::protected_function_result result;
+    {
+        ModCallScope scope(ctx);
+        result = save();
+    }
+    if (!result.valid()) {
+        sol::error err = result;
+        std::fprintf(stderr, "[mod_state] %s save_state: %s\n", ctx.id.c_str(), err.what());
+        return;
+    }
+    if (result.get_type() != sol::type::table)
+        return;
+    lua_State* L = ctx.lua->lua_state();
+    sol::object table = result;
+    lua_newtable(L); // visited
+    table.push(L);
+    ModStateWriter w;
+    encode_lua_value(L, -1, w, 0, lua_absindex(L, -2));
+    lua_pop(L, 2);
+    put_section(out, kLuaSection, w.bytes);
+}
+
+void load_script_state(ModContext& ctx, ModStateReader& r) {
+    sol::protected_function load = (*ctx.lua)["load_state"];
+    if (!load.valid())
+        return;
+    lua_State* L = ctx.lua->lua_state();
+    if (!decode_lua_value(L, r, 0)) {
+        std::fprintf(stderr, "[mod_state] %s: saved script state is damaged\n", ctx.id.c_str());
+        return;
+    }
+    sol::object table(L, -1);
+    lua_pop(L, 1);
+    sol::protected_function_result result;
+    {
+        ModCallScope scope(ctx);
+        result = load(table);
+    }
+    if (!result.valid()) {
+        sol::error err = result;
+        std::fprintf(stderr, "[mod_state] %s load_state: %s\n", ctx.id.c_str(), err.what());
+    }
+}
+
+} // namespace
+
+void ModStateWriter::put_u8(std::uint8_t v) {
+    bytes.push_back(static_cast<char>(v));
+}
+
+void ModStateWriter::put_u32(std::uint32_t v) {
+    bundle_put_u32(bytes, v);
+}
+
+void ModStateWriter::put_u64(std::uint64_t v) {
+    bundle_put_u64(bytes, v);
+}
+
+void ModStateWriter::put_f32(float v) {
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &v, sizeof(bits));
+    put_u32(bits);
+}
+
+void ModStateWriter::put_f64(double v) {
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &v, sizeof(bits));
+    put_u64(bits);
+}
+
+void ModStateWriter::put_str(const std::string& s) {
+    put_u32(static_cast<std::uint32_t>(s.size()));
+    bytes += s;
+}
+
+std::uint8_t ModStateReader::get_u8() {
+    if (!ok || size - pos < 1) {
+        ok = false;
+        return 0;
+    }
+    return static_cast<std::uint8_t>(data[pos++]);
+}
+
+std::uint32_t ModStateReader::get_u32() {
+    if (!ok || size - pos < 4) {
+        ok = false;
+        return 0;
+    }
+    std::uint32_t v = bundle_get_u32(data + pos);
+    pos += 4;
+    return v;
+}
+
+std::uint64_t ModStateReader::get_u64() {
+    if (!ok || size - pos < 8) {
+        ok = false;
+        return 0;
+    }
+    std::uint64_t v = bundle_get_u64(data + pos);
+    pos += 8;
+    return v;
+}
+
+float ModStateReader::get_f32() {
+    std::uint32_t bits = get_u32();
+    float v = 0.0f;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+double ModStateReader::get_f64() {
+    std::uint64_t bits = get_u64();
+    double v = 0.0;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+std::string ModStateReader::get_str() {
+    std::uint32_t len = get_u32();
+    if (!ok || size - pos < len) {
+        ok = false;
+        return {};
+    }
+    std::string s(data + pos, len);
+    pos += len;
+    return s;
+}
+
+std::string save_mod_state_blob(ModContext& ctx) {
+    if (!ctx.lua)
+        return {};
+    std::string out(kModStateMagic, sizeof(kModStateMagic));
+    bundle_put_u32(out, kModStateVersion);
+    std::size_t header = out.size();
+    try {
+        for (const auto* api : ctx.bound_apis) {
+            if (!api->save_mod_state)
+                continue;
+            ModStateWriter w;
+            api->save_mod_state(ctx, w);
+            if (!w.bytes.empty())
+                put_section(out, api->name, w.bytes);
+        }
+        save_script_state(ctx, out);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "[mod_state] %s: saving state failed: %s\n", ctx.id.c_str(), e.what());
+        return {};
+    }
+    if (out.size() == header)
+        return {};
+    bundle_put_u32(out, 0);
+    return out;
+}
+
+void load_mod_state_blob(ModContext& ctx, const std::string& blob) {
+    if (blob.empty() || !ctx.lua)
+        return;
+    ModStateReader r(blob.data(), blob.size());
+    if (blob.size() < sizeof(kModStateMagic) + 4 ||
+        std::memcmp(blob.data(), kModStateMagic, sizeof(kModStateMagic)) != 0)
+        return;
+    r.pos = sizeof(kModStateMagic);
+    if (r.get_u32() != kModStateVersion)
+        return;
+    try {
+        for (;;) {
+            std::string name = r.get_str();
+            if (!r.ok || name.empty())
+                break;
+            std::uint32_t len = r.get_u32();
+            if (!r.ok || len > r.size - r.pos)
+                break;
+            // Each section gets its own reader, so a loader that misreads
+            // cannot run into the next one.
+            ModStateReader section(r.data + r.pos, len);
+            r.pos += len;
+            if (name == kLuaSection) {
+                load_script_state(ctx, section);
+                continue;
+            }
+            for (const auto* api : ctx.bound_apis) {
+                if (api->name == name && api->load_mod_state)
+                    api->load_mod_state(ctx, section);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "[mod_state] %s: restoring state failed: %s\n", ctx.id.c_str(), e.what());
+    }
+}
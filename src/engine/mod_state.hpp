@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct ModContext;
+
+// Mod state carried across a hot reload.
+//
+// Before a reloading mod's Lua state is torn down, every API bound to it
+// writes what it wants to keep through `save_mod_state`, and a `save_state()`
+// global defined by the mod's scripts may return a table (booleans, numbers,
+// strings and nested tables) that is encoded too. Once the mod is active
+// again the blob goes back through each API's `load_mod_state` and the
+// script's `load_state(t)`. Layout:
+//
+//   "GUBS" u32 version
+//   repeat { u32 name_len, name, u32 len, len bytes }  -- one section per API, "lua" for scripts
+//   u32 0 (terminator)
+//
+// Integers are little-endian (bundle_put_*/bundle_get_*).
+
+inline constexpr char kModStateMagic[4] = {'G', 'U', 'B', 'S'};
+inline constexpr std::uint32_t kModStateVersion = 1;
+
+struct ModStateWriter {
+    std::string bytes;
+
+    void put_u8(std::uint8_t v);
+    void put_u32(std::uint32_t v);
+    void put_u64(std::uint64_t v);
+    void put_f32(float v);
+    void put_f64(double v);
+    void put_str(const std::string& s);
+};
+
+// Reads past the end yield zeros and clear `ok`, so a loader can read a
+// whole record and check once.
+struct ModStateReader {
+    const char* data{nullptr};
+    std::size_t size{0};
+    std::size_t pos{0};
+    bool ok{true};
+
+    ModStateReader(const char* bytes, std::size_t len) : data(bytes), size(len) {}
+
+    bool at_end() const { return pos >= size; }
+    std::uint8_t get_u8();
+    std::uint32_t get_u32();
+    std::uint64_t get_u64();
+    float get_f32();
+    double get_f64();
+    std::string get_str();
+};
+
+// Main thread. Empty when nothing was saved.
+std::string save_mod_state_blob(ModContext& ctx);
+// Main thread, after the mod's activation has finished.
+void load_mod_state_blob(ModContext& ctx, const std::string& blob);
@@ -0,0 +1,197 @@
+#include "engine/mod_tasks.hpp"
+
+#include "engine/mod_host.hpp"
+#include "engine/timing_wheel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+#include <lua.hpp>
+#include <sol/sol.hpp>
+
+namespace {
+
+// What a task yielded for; `wait*` push it ahead of their argument.
+constexpr lua_Integer kWaitSteps = 1;
+constexpr lua_Integer kWaitEvent = 2;
+// Longest sleep: about 580 years at 60 Hz, so `wait(math.huge)` means forever.
+constexpr lua_Integer kMaxWaitSteps = lua_Integer{1} << 40;
+
+struct ModTask {
+    std::uint32_t generation{0};
+    bool live{false};
+    ModContext* ctx{nullptr};
+    sol::thread thread; // anchors the coroutine
+};
+
+std::vector<ModTask> g_tasks;
+std::vector<std::uint32_t> g_free_tasks;
+std::size_t g_task_count = 0;
+TimingWheel g_wheel;
+std::unordered_map<std::string, std::vector<std::uint64_t>> g_event_waiters;
+std::vector<std::uint64_t> g_due;
+// Read by `wait` on whichever thread runs the script.
+std::atomic<float> g_step_seconds{1.0f / 60.0f};
+
+std::uint64_t task_id(std::uint32_t index, std::uint32_t generation) {
+    return (static_cast<std::uint64_t>(generation) << 32) | index;
+}
+
+ModTask* find_task(std::uint64_t id) {
+    auto index = static_cast<std::size_t>(id & 0xffffffffu);
+    if (index >= g_tasks.size())
+        return nullptr;
+    ModTask& task = g_tasks[index];
+    if (!task.live || task.generation != static_cast<std::uint32_t>(id >> 32))
+        return nullptr;
+    return &task;
+}
+
+void free_task(std::uint64_t id) {
+    auto index = static_cast<std::uint32_t>(id & 0xffffffffu);
+    ModTask& task = g_tasks[index];
+    task.live = false;
+    task.generation += 1;
+    task.ctx = nullptr;
+    task.thread = sol::thread();
+    g_free_tasks.push_back(index);
+    g_task_count -= 1;
+}
+
+void add_task(ModContext& ctx, const sol::thread& thread) {
+    std::uint32_t index = 0;
+    if (!g_free_tasks.empty()) {
+        index = g_free_tasks.back();
+        g_free_tasks.pop_back();
+    } else {
+        index = static_cast<std::uint32_t>(g_tasks.size());
+        g_tasks.emplace_back();
+    }
+    ModTask& task = g_tasks[index];
+    task.live = true;
+    task.ctx = &ctx;
+    task.thread = thread;
+    g_task_count += 1;
+    g_wheel.schedule(g_wheel.now() + 1, task_id(index, task.generation));
+}
+
+int wait_steps_fn(lua_State* L) {
+    lua_Integer steps = luaL_checkinteger(L, 1);
+    lua_pushinteger(L, kWaitSteps);
+    lua_pushinteger(L, std::clamp<lua_Integer>(steps, 1, kMaxWaitSteps));
+    return lua_yield(L, 2);
+}
+
+int wait_fn(lua_State* L) {
+    lua_Number seconds = luaL_checknumber(L, 1);
+    luaL_argcheck(L, !std::isnan(seconds), 1, "wait time is NaN");
+    lua_Number step = static_cast<lua_Number>(g_step_seconds.load(std::memory_order_relaxed));
+    lua_pushinteger(L, kWaitSteps);
+    // The epsilon keeps float noise from rounding e.g. 0.5s up to 31 steps at 60 Hz.
+    // Clamped before the cast, which is undefined for infinities and huge values.
+    lua_Number steps = std::ceil(seconds / step - 1e-6);
+    steps = std::clamp<lua_Number>(steps, 1, static_cast<lua_Number>(kMaxWaitSteps));
+    lua_pushinteger(L, static_cast<lua_Integer>(steps));
+    return lua_yield(L, 2);
+}
+
+int wait_event_fn(lua_State* L) {
+    luaL_checkstring(L, 1);
+    lua_pushinteger(L, kWaitEvent);
+    lua_pushvalue(L, 1);
+    return lua_yield(L, 2);
+}
+
+void resume_task(std::uint64_t id) {
+    ModTask* task = find_task(id);
+    if (!task)
+        return; // finished or dropped since it was scheduled
+    // The task may spawn others, which can move `g_tasks`; keep locals.
+    ModContext& ctx = *task->ctx;
+    lua_State* co = task->thread.thread_state();
+    int nres = 0;
+    int status = LUA_OK;
+    {
+        ModCallScope scope(ctx, co);
+        status = lua_resume(co, ctx.lua->lua_state(), 0, &nres);
+    }
+    if (status == LUA_YIELD) {
+        lua_Integer kind = nres == 2 ? lua_tointeger(co, -2) : 0;
+        if (kind == kWaitSteps) {
+            // Clamped again: a bare coroutine.yield can pass any count.
+            lua_Integer steps = std::clamp<lua_Integer>(lua_tointeger(co, -1), 1, kMaxWaitSteps);
+            g_wheel.schedule(g_wheel.now() + static_cast<std::uint64_t>(steps), id);
+        } else if (kind == kWaitEvent) {
+            g_event_waiters[lua_tostring(co, -1)].push_back(id);
+        } else {
+            g_wheel.schedule(g_wheel.now() + 1, id); // any other yield: next step
+        }
+        lua_pop(co, nres);
+        return;
+    }
+    if (status != LUA_OK) {
+        const char* msg = lua_tostring(co, -1);
+        std::fprintf(stderr, "[mod_tasks] %s task failed: %s\n", ctx.id.c_str(), msg ? msg : "(no message)");
+    }
+    if (find_task(id))
+        free_task(id);
+}
+
+} // namespace
+
+void bind_mod_tasks(sol::state& lua, ModContext& ctx) {
+    // Plain C functions so they can return `lua_yield` directly.
+    lua_State* L = lua.lua_state();
+    lua_register(L, "wait", wait_fn);
+    lua_register(L, "wait_steps", wait_steps_fn);
+    lua_register(L, "wait_event", wait_event_fn);
+    lua.set_function("spawn", [&ctx](sol::this_state state, sol::function fn) {
+        sol::thread thread = sol::thread::create(state);
+        fn.push(thread.thread_state());
+        run_mod_command(ctx, [&ctx, thread] { add_task(ctx, thread); });
+    });
+    lua.set_function("signal", [&ctx](const std::string& name) {
+        run_mod_command(ctx, [name] { signal_mod_tasks(name); });
+    });
+}
+
+void tick_mod_tasks(float step_seconds) {
+    g_step_seconds.store(step_seconds, std::memory_order_relaxed);
+    g_due.clear();
+    g_wheel.advance(g_due);
+    for (std::uint64_t id : g_due)
+        resume_task(id);
+}
+
+void signal_mod_tasks(const std::string& name) {
+    auto it = g_event_waiters.find(name);
+    if (it == g_event_waiters.end())
+        return;
+    for (std::uint64_t id : it->second)
+        g_wheel.schedule(g_wheel.now() + 1, id);
+    g_event_waiters.erase(it);
+}
+
+void drop_mod_tasks(const ModContext& ctx) {
+    for (std::size_t i = 0; i < g_tasks.size(); ++i) {
+        if (g_tasks[i].live && g_tasks[i].ctx == &ctx)
+            free_task(task_id(static_cast<std::uint32_t>(i), g_tasks[i].generation));
+    }
+    // Timers for dropped tasks go stale and are skipped when they fire;
+    // event waiters may never fire, so prune those now.
+    for (auto it = g_event_waiters.begin(); it != g_event_waiters.end();) {
+        auto& ids = it->second;
+        ids.erase(std::remove_if(ids.begin(), ids.end(), [](std::uint64_t id) { return !find_task(id); }), ids.end());
+        it = ids.empty() ? g_event_waiters.erase(it) : std::next(it);
+    }
+}
+
+std::size_t mod_task_count() {
+    return g_task_count;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace sol {
+class state;
+}
+
+struct ModContext;
+
+// Lua coroutine tasks for mods, driven by the fixed step.
+//
+//     spawn(function()
+//         while true do
+//             wait(2.0)              -- seconds, rounded up to whole steps
+//             wait_steps(1)
+//             wait_event("bonk")     -- until signal("bonk") or the engine event
+//         end
+//     end)
+//
+// Sleeping tasks sit in a timing wheel and event waiters in per-name lists,
+// so a tick only resumes the tasks that are due on it. A resume counts as a
+// call into the mod (CPU accounting, instruction budget); a task that errors
+// is logged and dropped.
+
+// Binds `spawn`, `wait`, `wait_steps`, `wait_event` and `signal`.
+void bind_mod_tasks(sol::state& lua, ModContext& ctx);
+
+// Main thread, once per fixed step.
+void tick_mod_tasks(float step_seconds);
+
+// Wakes every task waiting on `name`; they resume on the next tick.
+void signal_mod_tasks(const std::string& name);
+
+// Drops the mod's tasks; call before its state closes.
+void drop_mod_tasks(const ModContext& ctx);
+
+std::size_t mod_task_count();
@@ -293,6 +293,94 @@ static bool is_image_ext(const std::string& ext) {
            ext == ".webp" || ext == ".tga";
 }
 
+// Manifest pass for one mod: parse `.sprite` files under `<mod>/graphics`.
+static void collect_manifest_sprite_defs(const ModInfo& m,
+                                         std::unordered_map<std::string, SpriteDef>& defs_by_name) {
+    std::error_code ec;
+    fs::path gdir = fs::path(m.path) / "graphics";
+    if (!fs::exists(gdir, ec) || !fs::is_directory(gdir, ec))
+        return;
+    for (auto const& entry : fs::recursive_directory_iterator(gdir, ec)) {
+        if (ec) {
+            ec.clear();
+            continue;
+        }
+        if (!entry.is_regular_file())
+            continue;
+        auto p = entry.path();
+        std::string ext = p.extension().string();
+        for (auto& c : ext)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        if (!is_manifest_ext(ext))
+            continue;
+        SpriteDef def{};
+        std::string err;
+        if (parse_sprite_manifest_file(p.string(), def, err)) {
+            // Namespace the sprite name if missing a prefix
+            if (def.name.find(':') == std::string::npos) {
+                def.name = m.name + ":" + def.name;
+            }
+            // Resolve image path relative to mod root if not absolute
+            if (!def.image_path.empty() && !fs::path(def.image_path).is_absolute()) {
+                def.image_path = (fs::path(m.path) / "graphics" / def.image_path)
+                                     .lexically_normal()
+                                     .string();
+            }
+            // Keep first definition for a name; later mods can override if desired (could
+            // be policy)
+            if (defs_by_name.find(def.name) == defs_by_name.end())
+                defs_by_name.emplace(def.name, std::move(def));
+        } else {
+            std::printf("[mods] Sprite manifest parse failed: %s (%s)\n",
+                        p.string().c_str(), err.c_str());
+        }
+    }
+}
+
+// Image pass for one mod: images without manifests become default
+// single-frame sprites.
+static void collect_image_sprite_defs(const ModInfo& m,
+                                      std::unordered_map<std::string, SpriteDef>& defs_by_name) {
+    std::error_code ec;
+    fs::path gdir = fs::path(m.path) / "graphics";
+    if (!fs::exists(gdir, ec) || !fs::is_directory(gdir, ec))
+        return;
+    for (auto const& entry : fs::recursive_directory_iterator(gdir, ec)) {
+        if (ec) {
+            ec.clear();
+            continue;
+        }
+        if (!entry.is_regular_file())
+            continue;
+        auto p = entry.path();
+        std::string ext = p.extension().string();
+        for (auto& c : ext)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        if (!is_image_ext(ext))
+            continue;
+        std::string stem = p.stem().string();
+        std::string nsname = m.name + ":" + stem;
+        if (defs_by_name.find(nsname) != defs_by_name.end())
+            continue; // manifest already defined
+        SpriteDef d = make_default_sprite_from_image(nsname, p.string());
+        defs_by_name.emplace(nsname, std::move(d));
+    }
+}
+
+static std::vector<SpriteDef> sorted_sprite_defs(std::unordered_map<std::string, SpriteDef>& defs_by_name) {
+    std::vector<std::pair<std::string, SpriteDef>> sorted;
+    sorted.reserve(defs_by_name.size());
+    for (auto& kv : defs_by_name)
+        sorted.emplace_back(kv.first, std::move(kv.second));
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::vector<SpriteDef> defs;
+    defs.reserve(sorted.size());
+    for (auto& kv : sorted)
+        defs.push_back(std::move(kv.second));
+    return defs;
+}
+
 /// Rebuild the full sprite store from all mods.
 ///
 /// Scans each `<mod.path>/graphics` recursively. Prefers manifests
@@ -313,99 +401,43 @@ static bool is_image_ext(const std::string& ext) {
 /// change. IDs may change if the name set changes.
 bool scan_mods_for_sprite_defs() {
     auto mod_infos = mm->mods;
-    
+
     // First pass: collect manifests per name (prefer manifests over bare images)
     std::unordered_map<std::string, SpriteDef> defs_by_name;
-    std::unordered_map<std::string, std::string>
-        name_to_modroot; // for resolving relative image paths
-    std::error_code ec;
-    for (auto const& m : mod_infos) {
-        fs::path gdir = fs::path(m.path) / "graphics";
-        if (!fs::exists(gdir, ec) || !fs::is_directory(gdir, ec))
-            continue;
-        for (auto const& entry : fs::recursive_directory_iterator(gdir, ec)) {
-            if (ec) {
-                ec.clear();
-                continue;
-            }
-            if (!entry.is_regular_file())
-                continue;
-            auto p = entry.path();
-            std::string ext = p.extension().string();
-            for (auto& c : ext)
-                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-            if (is_manifest_ext(ext)) {
-                SpriteDef def{};
-                std::string err;
-                if (parse_sprite_manifest_file(p.string(), def, err)) {
-                    // Namespace the sprite name if missing a prefix
-                    if (def.name.find(':') == std::string::npos) {
-                        def.name = m.name + ":" + def.name;
-                    }
-                    // Resolve image path relative to mod root if not absolute
-                    if (!def.image_path.empty() && !fs::path(def.image_path).is_absolute()) {
-                        def.image_path = (fs::path(m.path) / "graphics" / def.image_path)
-                                             .lexically_normal()
-                                             .string();
-                    }
-                    // Keep first definition for a name; later mods can override if desired (could
-                    // be policy)
-                    if (defs_by_name.find(def.name) == defs_by_name.end()) {
-                        defs_by_name.emplace(def.name, std::move(def));
-                        name_to_modroot[defs_by_name.find(def.name)->first] = m.path;
-                    }
-                } else {
-                    std::printf("[mods] Sprite manifest parse failed: %s (%s)\n",
-                                p.string().c_str(), err.c_str());
-                }
-            }
-        }
-    }
+    for (auto const& m : mod_infos)
+        collect_manifest_sprite_defs(m, defs_by_name);
     // Second pass: images without manifests become default single-frame sprites
-    for (auto const& m : mod_infos) {
-        fs::path gdir = fs::path(m.path) / "graphics";
-        if (!fs::exists(gdir, ec) || !fs::is_directory(gdir, ec))
-            continue;
-        for (auto const& entry : fs::recursive_directory_iterator(gdir, ec)) {
-            if (ec) {
-                ec.clear();
-                continue;
-            }
-            if (!entry.is_regular_file())
-                continue;
-            auto p = entry.path();
-            std::string ext = p.extension().string();
-            for (auto& c : ext)
-                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-            if (!is_image_ext(ext))
-                continue;
-            std::string stem = p.stem().string();
-            std::string nsname = m.name + ":" + stem;
-            if (defs_by_name.find(nsname) != defs_by_name.end())
-                continue; // manifest already defined
-            SpriteDef d = make_default_sprite_from_image(nsname, p.string());
-            defs_by_name.emplace(nsname, std::move(d));
-            name_to_modroot[nsname] = m.path;
-        }
-    }
+    for (auto const& m : mod_infos)
+        collect_image_sprite_defs(m, defs_by_name);
 
     // Deterministic ordering: sort by name before rebuilding
-    std::vector<std::pair<std::string, SpriteDef>> sorted;
-    sorted.reserve(defs_by_name.size());
-    for (auto& kv : defs_by_name)
-        sorted.emplace_back(kv.first, std::move(kv.second));
-    std::sort(sorted.begin(), sorted.end(),
-              [](const auto& a, const auto& b) { return a.first < b.first; });
-    std::vector<SpriteDef> defs;
-    defs.reserve(sorted.size());
-    for (auto& kv : sorted)
-        defs.push_back(std::move(kv.second));
- 
+    std::vector<SpriteDef> defs = sorted_sprite_defs(defs_by_name);
     rebuild_sprite_mapping(defs);
     std::printf("[mods] Sprite store built with %zu entries\n", defs.size());
     return true;
 }
 
+std::vector<int> sync_mod_sprite_defs(const std::string& mod_name) {
+    const ModInfo* info = nullptr;
+    for (auto const& m : mm->mods) {
+        if (m.name == mod_name) {
+            info = &m;
+            break;
+        }
+    }
+    std::unordered_map<std::string, SpriteDef> defs_by_name;
+    if (info) {
+        collect_manifest_sprite_defs(*info, defs_by_name);
+        collect_image_sprite_defs(*info, defs_by_name);
+    }
+    std::vector<SpriteDef> defs = sorted_sprite_defs(defs_by_name);
+    std::vector<std::string> keep;
+    keep.reserve(defs.size());
+    for (auto const& d : defs)
+        keep.push_back(d.name);
+    release_sprite_defs(mod_name + ":", keep);
+    return upsert_sprite_defs(defs);
+}
 
 bool poll_fs_mods_hot_reload() {
     if (!mm || !es)
@@ -441,9 +473,16 @@ bool poll_fs_mods_hot_reload() {
     if (touched_mods.empty())
         return false;
 
+    // Manifests count as assets: they can change what the rebuild picks up.
+    bool assets_changed = !changed_assets.empty() ||
+                          std::any_of(changed_scripts.begin(), changed_scripts.end(), [](const std::string& path) {
+                              return path.find("/scripts/") == std::string::npos;
+                          });
+
     std::vector<std::string> reload_ids(touched_mods.begin(), touched_mods.end());
-    std::printf("[mods] Reloading %zu mod(s) due to changes.\n", reload_ids.size());
-    if (reload_mods(reload_ids)) {
+    std::printf("[mods] Reloading %zu mod(s) due to %s changes.\n", reload_ids.size(),
+                assets_changed ? "asset" : "script");
+    if (reload_mods(reload_ids, assets_changed)) {
         es->alerts.push_back({"Mods reloaded", 0.0f, 1.5f, false});
         return true;
     }
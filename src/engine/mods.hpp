@@ -11,6 +11,8 @@
 struct ModFileEntry {
     std::string path;
     std::uint64_t size_bytes{0};
+    std::string hash;   // content_hash_hex digest; empty if the server did not publish one
+    std::string sha256; // hex SHA-256 keying the blob store; empty from older servers
 };
 
 struct ModCatalogEntry {
@@ -26,6 +28,7 @@ struct ModCatalogEntry {
     std::vector<std::string> apis;
     std::vector<ModFileEntry> files;
     std::uint64_t total_bytes{0};
+    std::string content_hash; // server digest of the whole mod; keys bundle resumes
     bool required{false};
     bool installed{false};
     bool installing{false};
@@ -99,5 +102,11 @@ bool cheap_scan_mods_to_update_sprite_name_registry();
 // Returns true if store was rebuilt.
 bool scan_mods_for_sprite_defs();
 
+// Bring one mod's sprites in line with its `graphics/` folder without a full
+// rescan: stale names are released, others are added or replaced in place so
+// no other sprite id moves. Returns the ids whose textures need loading.
+// A mod that is no longer discovered simply has all its sprites released.
+std::vector<int> sync_mod_sprite_defs(const std::string& mod_name);
+
 // Destroy global ModManager and release memory.
 void cleanup_mods_manager();
@@ -21,7 +21,10 @@
 #include "top_level_game_settings.hpp"
 #include "sdl_shim.hpp"
 #include "render.hpp"
+#include "engine/mod_catalog.hpp"
+#include "engine/mod_events.hpp"
 #include "engine/mod_host.hpp"
+#include "engine/mod_jobs.hpp"
 #include "game/mod_api/register_game_mod_apis.hpp"
 #include "engine/input_system.hpp"
 #include "engine/mode_registry.hpp"
@@ -99,7 +102,7 @@ bool do_the_gubsy(){
     discover_mods();
     scan_mods_for_sprite_defs();
     load_all_textures_in_sprite_lookup();
-    load_mod_sounds();
+    load_mod_sounds(kModsRuntimeRoot);
 
     load_enabled_mods_via_host();
     finalize_game_mod_apis();
@@ -131,10 +134,14 @@ bool do_the_gubsy(){
         bool mods_changed = poll_fs_mods_hot_reload();
         if (mods_changed)
             finalize_game_mod_apis();
+        pump_mod_jobs();
 
         step();
+        dispatch_mod_events();
 
         render();
+        collect_mod_garbage();
+        roll_mod_cpu_frame();
 
         accum_sec += dt;
         frame_counter += 1;
@@ -154,7 +161,9 @@ bool stop_doing_the_gubsy(){
     layout_editor_shutdown();
     imgui_debug_shutdown();
     shutdown_imgui_layer();
+    shutdown_mod_jobs();
     unload_all_mods_via_host();
+    shutdown_mod_catalog();
     cleanup_audio();
     cleanup_engine_state();
     cleanup_graphics();
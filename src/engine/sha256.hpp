@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Streaming SHA-256 (FIPS 180-4). content_hash.hpp's FNV digest is fine for
+// spotting changed files, but anyone can craft FNV collisions, so anything
+// that trusts content across mods (the blob store) keys it with this.
+// Shared by the engine and tools/mod_server, which publishes the digests.
+class Sha256Hasher {
+  public:
+    using Digest = std::array<std::uint8_t, 32>;
+
+    void update(const char* data, std::size_t len) {
+        total_bytes_ += len;
+        while (len > 0) {
+            std::size_t take = std::min(len, block_.size() - block_len_);
+            for (std::size_t i = 0; i < take; ++i)
+                block_[block_len_ + i] = static_cast<std::uint8_t>(data[i]);
+            block_len_ += take;
+            data += take;
+            len -= take;
+            if (block_len_ == block_.size()) {
+                compress();
+                block_len_ = 0;
+            }
+        }
+    }
+
+    // Finishes a copy, so the hasher itself can keep taking input.
+    Digest digest() const {
+        Sha256Hasher h = *this;
+        const std::uint64_t bits = total_bytes_ * 8;
+        h.block_[h.block_len_++] = 0x80;
+        if (h.block_len_ > 56) {
+            while (h.block_len_ < 64)
+                h.block_[h.block_len_++] = 0;
+            h.compress();
+            h.block_len_ = 0;
+        }
+        while (h.block_len_ < 56)
+            h.block_[h.block_len_++] = 0;
+        for (int i = 7; i >= 0; --i)
+            h.block_[h.block_len_++] = static_cast<std::uint8_t>(bits >> (i * 8));
+        h.compress();
+        Digest out{};
+        for (std::size_t i = 0; i < 8; ++i) {
+            for (std::size_t b = 0; b < 4; ++b)
+                out[i * 4 + b] = static_cast<std::uint8_t>(h.state_[i] >> (24 - b * 8));
+        }
+        return out;
+    }
+
+  private:
+    static constexpr std::array<std::uint32_t, 64> kRound = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+    static std::uint32_t rotr(std::uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+    void compress() {
+        std::array<std::uint32_t, 64> w{};
+        for (std::size_t i = 0; i < 16; ++i) {
+            w[i] = static_cast<std::uint32_t>(block_[i * 4]) << 24 | static_cast<std::uint32_t>(block_[i * 4 + 1]) << 16 |
+                   static_cast<std::uint32_t>(block_[i * 4 + 2]) << 8 | static_cast<std::uint32_t>(block_[i * 4 + 3]);
+        }
+        for (std::size_t i = 16; i < 64; ++i) {
+            std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        std::array<std::uint32_t, 8> v = state_;
+        for (std::size_t i = 0; i < 64; ++i) {
+            std::uint32_t s1 = rotr(v[4], 6) ^ rotr(v[4], 11) ^ rotr(v[4], 25);
+            std::uint32_t ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+            std::uint32_t t1 = v[7] + s1 + ch + kRound[i] + w[i];
+            std::uint32_t s0 = rotr(v[0], 2) ^ rotr(v[0], 13) ^ rotr(v[0], 22);
+            std::uint32_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+            std::uint32_t t2 = s0 + maj;
+            v[7] = v[6];
+            v[6] = v[5];
+            v[5] = v[4];
+            v[4] = v[3] + t1;
+            v[3] = v[2];
+            v[2] = v[1];
+            v[1] = v[0];
+            v[0] = t1 + t2;
+        }
+        for (std::size_t i = 0; i < 8; ++i)
+            state_[i] += v[i];
+    }
+
+    std::array<std::uint32_t, 8> state_{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    std::array<std::uint8_t, 64> block_{};
+    std::size_t block_len_{0};
+    std::uint64_t total_bytes_{0};
+};
+
+inline std::string sha256_hex(const Sha256Hasher::Digest& digest) {
+    static constexpr char kDigits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(digest.size() * 2);
+    for (std::uint8_t byte : digest) {
+        out.push_back(kDigits[byte >> 4]);
+        out.push_back(kDigits[byte & 0xF]);
+    }
+    return out;
+}
+
+// Stream `path` through Sha256Hasher and return the hex digest in `out`.
+inline bool sha256_file(const std::filesystem::path& path, std::string& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f.good())
+        return false;
+    Sha256Hasher hasher;
+    char buf[64 * 1024];
+    while (f) {
+        f.read(buf, sizeof(buf));
+        std::streamsize got = f.gcount();
+        if (got > 0)
+            hasher.update(buf, static_cast<std::size_t>(got));
+    }
+    if (f.bad())
+        return false;
+    out = sha256_hex(hasher.digest());
+    return true;
+}
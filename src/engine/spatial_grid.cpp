@@ -0,0 +1,195 @@
+#include "engine/spatial_grid.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Cell coordinates are clamped so far-off or garbage positions still map
+// to a valid cell instead of overflowing.
+constexpr float kMaxCellCoord = 1073741824.0f; // 2^30
+
+// Keeps `out[0, n)` sorted nearest-first and at most k long.
+void offer_hit(SpatialHit* out, std::size_t& n, std::size_t k, const SpatialHit& hit) {
+    if (n == k && hit.dist2 >= out[k - 1].dist2)
+        return;
+    std::size_t i = n < k ? n++ : k - 1;
+    while (i > 0 && out[i - 1].dist2 > hit.dist2) {
+        out[i] = out[i - 1];
+        --i;
+    }
+    out[i] = hit;
+}
+
+} // namespace
+
+SpatialGrid::SpatialGrid(float cell_size) {
+    reset(cell_size);
+}
+
+void SpatialGrid::reset(float cell_size) {
+    clear();
+    cell_size_ = cell_size > 0.0f ? cell_size : 1.0f;
+    inv_cell_size_ = 1.0f / cell_size_;
+}
+
+void SpatialGrid::clear() {
+    items_.clear();
+    index_of_.clear();
+    cells_.clear();
+    max_radius_ = 0.0f;
+}
+
+std::int32_t SpatialGrid::cell_coord(float v) const {
+    float c = std::floor(v * inv_cell_size_);
+    if (!(c == c))
+        return 0;
+    return static_cast<std::int32_t>(std::clamp(c, -kMaxCellCoord, kMaxCellCoord));
+}
+
+std::uint64_t SpatialGrid::cell_key(std::int32_t cx, std::int32_t cy) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32) | static_cast<std::uint32_t>(cy);
+}
+
+SpatialGrid::CellRange SpatialGrid::cells_covering(glm::vec2 lo, glm::vec2 hi) const {
+    glm::vec2 a = glm::min(lo, hi);
+    glm::vec2 b = glm::max(lo, hi);
+    return {cell_coord(a.x), cell_coord(a.y), cell_coord(b.x), cell_coord(b.y)};
+}
+
+const std::vector<std::uint32_t>* SpatialGrid::bucket(std::int32_t cx, std::int32_t cy) const {
+    auto it = cells_.find(cell_key(cx, cy));
+    return it == cells_.end() || it->second.empty() ? nullptr : &it->second;
+}
+
+std::uint32_t SpatialGrid::find_index(VID vid) const {
+    if (vid.id >= index_of_.size())
+        return kNone;
+    std::uint32_t index = index_of_[vid.id];
+    if (index == kNone || items_[index].vid.version != vid.version)
+        return kNone;
+    return index;
+}
+
+void SpatialGrid::link(std::uint32_t index) {
+    Item& item = items_[index];
+    item.cell = cell_key(cell_coord(item.pos.x), cell_coord(item.pos.y));
+    auto& list = cells_[item.cell];
+    item.bucket_index = static_cast<std::uint32_t>(list.size());
+    list.push_back(index);
+}
+
+void SpatialGrid::unlink(std::uint32_t index) {
+    Item& item = items_[index];
+    auto& list = cells_[item.cell];
+    std::uint32_t moved = list.back();
+    list[item.bucket_index] = moved;
+    items_[moved].bucket_index = item.bucket_index;
+    list.pop_back();
+}
+
+void SpatialGrid::insert(VID vid, glm::vec2 pos, float radius) {
+    if (vid.id >= index_of_.size())
+        index_of_.resize(vid.id + 1, kNone);
+    radius = std::max(radius, 0.0f);
+    max_radius_ = std::max(max_radius_, radius);
+    std::uint32_t index = index_of_[vid.id];
+    if (index != kNone) {
+        // Same slot, possibly a newer version: reuse the item.
+        items_[index].vid = vid;
+        items_[index].radius = radius;
+        move(vid, pos);
+        return;
+    }
+    index = static_cast<std::uint32_t>(items_.size());
+    items_.push_back(Item{vid, pos, radius, 0, 0});
+    index_of_[vid.id] = index;
+    link(index);
+}
+
+void SpatialGrid::move(VID vid, glm::vec2 pos) {
+    std::uint32_t index = find_index(vid);
+    if (index == kNone)
+        return;
+    Item& item = items_[index];
+    item.pos = pos;
+    if (cell_key(cell_coord(pos.x), cell_coord(pos.y)) == item.cell)
+        return;
+    unlink(index);
+    link(index);
+}
+
+void SpatialGrid::set_radius(VID vid, float radius) {
+    std::uint32_t index = find_index(vid);
+    if (index == kNone)
+        return;
+    items_[index].radius = std::max(radius, 0.0f);
+    max_radius_ = std::max(max_radius_, items_[index].radius);
+}
+
+void SpatialGrid::remove(VID vid) {
+    std::uint32_t index = find_index(vid);
+    if (index == kNone)
+        return;
+    unlink(index);
+    index_of_[vid.id] = kNone;
+    auto last = static_cast<std::uint32_t>(items_.size() - 1);
+    if (index != last) {
+        // The last item takes the hole; repoint its cell list entry.
+        items_[index] = items_[last];
+        index_of_[items_[index].vid.id] = index;
+        cells_[items_[index].cell][items_[index].bucket_index] = index;
+    }
+    items_.pop_back();
+}
+
+bool SpatialGrid::contains(VID vid) const {
+    return find_index(vid) != kNone;
+}
+
+// Walks square rings of cells outward from p's cell. Once k hits are held and
+// the k-th is no farther than the inner edge of the next ring, nothing
+// farther out can beat it. Sparse grids, where the rings would visit more
+// cells than there are items, fall back to scanning every item.
+std::size_t SpatialGrid::query_nearest(glm::vec2 p, std::size_t k, SpatialHit* out, float max_dist) const {
+    if (k == 0 || items_.empty() || !(max_dist >= 0.0f))
+        return 0;
+    const float max_dist2 = max_dist * max_dist;
+    std::size_t n = 0;
+    auto consider = [&](const Item& item) {
+        glm::vec2 d = item.pos - p;
+        float dist2 = d.x * d.x + d.y * d.y;
+        if (dist2 <= max_dist2)
+            offer_hit(out, n, k, SpatialHit{item.vid, dist2});
+    };
+
+    const std::int32_t pcx = cell_coord(p.x);
+    const std::int32_t pcy = cell_coord(p.y);
+    const std::uint64_t cell_budget = 2 * static_cast<std::uint64_t>(items_.size()) + 8;
+    std::uint64_t cells_visited = 0;
+    for (std::int32_t ring = 0;; ++ring) {
+        std::uint64_t ring_cells = ring == 0 ? 1 : 8 * static_cast<std::uint64_t>(ring);
+        if (cells_visited + ring_cells > cell_budget || ring > static_cast<std::int32_t>(kMaxCellCoord)) {
+            n = 0;
+            for (const Item& item : items_)
+                consider(item);
+            return n;
+        }
+        cells_visited += ring_cells;
+        for (std::int32_t dy = -ring; dy <= ring; ++dy) {
+            // Interior rows only need the ring's left and right cells.
+            const bool edge_row = dy == -ring || dy == ring;
+            const std::int32_t step = edge_row || ring == 0 ? 1 : 2 * ring;
+            for (std::int32_t dx = -ring; dx <= ring; dx += step) {
+                if (const auto* list = bucket(pcx + dx, pcy + dy)) {
+                    for (std::uint32_t index : *list)
+                        consider(items_[index]);
+                }
+            }
+        }
+        const float reach = static_cast<float>(ring) * cell_size_;
+        if (reach * reach > max_dist2)
+            return n;
+        if (n == k && out[k - 1].dist2 <= reach * reach)
+            return n;
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "engine/vid.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Uniform-grid spatial index over circles, keyed by VID.
+//
+// Each item lives in the one cell holding its center. Queries widen their
+// cell range by the largest radius ever inserted, so an item is found from
+// any cell its circle reaches. Pick a cell size around the typical query
+// radius; items much larger than a cell still work, they just widen every
+// query.
+//
+// Queries never allocate. Hits go to a callback as (VID, center, radius):
+//
+//     grid.query_radius(player.pos, player_radius, [&](VID vid, glm::vec2 pos, float r) {
+//         ...
+//     });
+//
+// `move()` is O(1) and only touches the cell lists when the item crosses a
+// cell boundary. Empty cell lists keep their storage, so steady movement
+// over a bounded area stops allocating too.
+struct SpatialHit {
+    VID vid{};
+    float dist2{0.0f}; // squared distance between centers
+};
+
+class SpatialGrid {
+  public:
+    explicit SpatialGrid(float cell_size = 1.0f);
+
+    // Drops every item; also sets the cell size.
+    void reset(float cell_size);
+    void clear();
+
+    // Inserts, or replaces the item with the same slot id.
+    void insert(VID vid, glm::vec2 pos, float radius = 0.0f);
+    void move(VID vid, glm::vec2 pos);
+    void set_radius(VID vid, float radius);
+    void remove(VID vid);
+
+    bool contains(VID vid) const;
+    std::size_t size() const { return items_.size(); }
+    float cell_size() const { return cell_size_; }
+
+    // Items whose circle overlaps the circle (center, radius).
+    template <typename Fn>
+    void query_radius(glm::vec2 center, float radius, Fn&& fn) const;
+
+    // Items whose circle overlaps the box [lo, hi].
+    template <typename Fn>
+    void query_aabb(glm::vec2 lo, glm::vec2 hi, Fn&& fn) const;
+
+    // Up to `k` items nearest to `p` by center distance, at most `max_dist`
+    // away, written nearest-first to `out` (room for k). Returns the count.
+    std::size_t query_nearest(glm::vec2 p, std::size_t k, SpatialHit* out,
+                              float max_dist = std::numeric_limits<float>::infinity()) const;
+
+  private:
+    static constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+
+    struct Item {
+        VID vid{};
+        glm::vec2 pos{0.0f};
+        float radius{0.0f};
+        std::uint64_t cell{0};
+        std::uint32_t bucket_index{0}; // position in its cell's list
+    };
+
+    struct CellRange {
+        std::int32_t x0, y0, x1, y1;
+        std::uint64_t count() const {
+            return static_cast<std::uint64_t>(x1 - x0 + 1) * static_cast<std::uint64_t>(y1 - y0 + 1);
+        }
+    };
+
+    std::int32_t cell_coord(float v) const;
+    static std::uint64_t cell_key(std::int32_t cx, std::int32_t cy);
+    CellRange cells_covering(glm::vec2 lo, glm::vec2 hi) const;
+    const std::vector<std::uint32_t>* bucket(std::int32_t cx, std::int32_t cy) const;
+    std::uint32_t find_index(VID vid) const;
+    void link(std::uint32_t index);
+    void unlink(std::uint32_t index);
+
+    // Visits every item whose cell is in `range`, or every item when that
+    // is cheaper than the cell walk.
+    template <typename Fn>
+    void for_each_candidate(const CellRange& range, Fn&& fn) const;
+
+    float cell_size_{1.0f};
+    float inv_cell_size_{1.0f};
+    float max_radius_{0.0f};
+    std::vector<Item> items_;
+    std::vector<std::uint32_t> index_of_; // VID id -> items_ index, kNone if absent
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> cells_;
+};
+
+template <typename Fn>
+void SpatialGrid::for_each_candidate(const CellRange& range, Fn&& fn) const {
+    if (items_.empty())
+        return;
+    if (range.count() > items_.size()) {
+        for (const Item& item : items_)
+            fn(item);
+        return;
+    }
+    for (std::int32_t cy = range.y0; cy <= range.y1; ++cy) {
+        for (std::int32_t cx = range.x0; cx <= range.x1; ++cx) {
+            if (const auto* list = bucket(cx, cy)) {
+                for (std::uint32_t index : *list)
+                    fn(items_[index]);
+            }
+        }
+    }
+}
+
+template <typename Fn>
+void SpatialGrid::query_radius(glm::vec2 center, float radius, Fn&& fn) const {
+    glm::vec2 reach(radius + max_radius_);
+    for_each_candidate(cells_covering(center - reach, center + reach), [&](const Item& item) {
+        glm::vec2 d = item.pos - center;
+        float r = radius + item.radius;
+        if (d.x * d.x + d.y * d.y <= r * r)
+            fn(item.vid, item.pos, item.radius);
+    });
+}
+
+template <typename Fn>
+void SpatialGrid::query_aabb(glm::vec2 lo, glm::vec2 hi, Fn&& fn) const {
+    glm::vec2 reach(max_radius_);
+    for_each_candidate(cells_covering(lo - reach, hi + reach), [&](const Item& item) {
+        glm::vec2 d = item.pos - glm::clamp(item.pos, lo, hi);
+        if (d.x * d.x + d.y * d.y <= item.radius * item.radius)
+            fn(item.vid, item.pos, item.radius);
+    });
+}
@@ -2,6 +2,7 @@
 
 #include "engine/alerts.hpp"
 #include "engine/mode_registry.hpp"
+#include "engine/mod_tasks.hpp"
 #include "globals.hpp"
 #include "engine/input_system.hpp"
 
@@ -22,6 +23,7 @@ void step() {
                 mode->step_fn();
             }
         }
+        tick_mod_tasks(fixed_dt);
 
         es->frame += 1;
     }
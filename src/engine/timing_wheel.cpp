@@ -0,0 +1,59 @@
+#include "engine/timing_wheel.hpp"
+
+#include <utility>
+
+namespace {
+
+constexpr std::uint64_t kSlotMask = TimingWheel::kSlots - 1;
+constexpr std::uint64_t kNearSpan = TimingWheel::kSlots;
+constexpr std::uint64_t kFarSpan = kNearSpan * TimingWheel::kSlots;
+
+} // namespace
+
+// `t.due >= now_`: the current tick's slot is only still pending while a
+// cascade runs inside `advance`.
+void TimingWheel::place(const Timer& t) {
+    std::uint64_t delta = t.due - now_;
+    if (delta < kNearSpan)
+        near_[t.due & kSlotMask].push_back(t);
+    else if (delta < kFarSpan)
+        far_[(t.due >> TimingWheel::kSlotBits) & kSlotMask].push_back(t);
+    else
+        overflow_.push_back(t);
+}
+
+void TimingWheel::schedule(std::uint64_t due, std::uint64_t id) {
+    // Overdue timers fire on the next tick.
+    place({due > now_ ? due : now_ + 1, id});
+    size_ += 1;
+}
+
+void TimingWheel::advance(std::vector<std::uint64_t>& out) {
+    now_ += 1;
+    if ((now_ & (kFarSpan - 1)) == 0) {
+        scratch_.swap(overflow_);
+        for (const Timer& t : scratch_)
+            place(t);
+        scratch_.clear();
+    }
+    if ((now_ & kSlotMask) == 0) {
+        scratch_.swap(far_[(now_ >> kSlotBits) & kSlotMask]);
+        for (const Timer& t : scratch_)
+            place(t);
+        scratch_.clear();
+    }
+    std::vector<Timer>& slot = near_[now_ & kSlotMask];
+    for (const Timer& t : slot)
+        out.push_back(t.id);
+    size_ -= slot.size();
+    slot.clear();
+}
+
+void TimingWheel::clear() {
+    for (auto& slot : near_)
+        slot.clear();
+    for (auto& slot : far_)
+        slot.clear();
+    overflow_.clear();
+    size_ = 0;
+}
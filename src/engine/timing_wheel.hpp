@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Two-level hierarchical timing wheel over integer ticks.
+//
+// Timers due within 256 ticks sit in the near wheel, one slot per tick.
+// Those due within 65536 ticks sit in the far wheel, one slot per 256
+// ticks, and are moved down when their block comes up. Anything later waits
+// in an overflow list that is looked at once every 65536 ticks. Advancing
+// one tick touches only the slot for that tick (plus, every 256 ticks, one
+// far slot), so sleeping timers cost nothing until they are nearly due.
+class TimingWheel {
+  public:
+    static constexpr std::size_t kSlotBits = 8;
+    static constexpr std::size_t kSlots = std::size_t{1} << kSlotBits;
+
+    struct Timer {
+        std::uint64_t due{0};
+        std::uint64_t id{0};
+    };
+
+    std::uint64_t now() const { return now_; }
+    std::size_t size() const { return size_; }
+
+    // Timers due at or before `now()` fire on the next advance.
+    void schedule(std::uint64_t due, std::uint64_t id);
+
+    // Moves to the next tick and appends the ids due on it to `out`.
+    void advance(std::vector<std::uint64_t>& out);
+
+    void clear();
+
+  private:
+    void place(const Timer& t);
+
+    std::uint64_t now_{0};
+    std::size_t size_{0};
+    std::array<std::vector<Timer>, kSlots> near_{};
+    std::array<std::vector<Timer>, kSlots> far_{};
+    std::vector<Timer> overflow_;
+    std::vector<Timer> scratch_;
+};
@@ -2,89 +2,221 @@
 
 #include "engine/vid.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <memory>
 #include <vector>
 
-// Generic pool with stable VID handles. Provides contiguous storage with bounded
-// capacity. Each slot keeps its VID (id == slot index, version increments on reuse).
-template <typename T>
+// Generic pool with stable VID handles. Each slot keeps its VID (id == slot
+// index, version increments on reuse).
+//
+// Storage grows on demand in fixed chunks of ChunkSize entries. Chunks are
+// never moved or reallocated, so an Entry pointer stays valid for as long as
+// the entry is active. `init(n)` only pre-allocates; acquire() grows past it.
+//
+// Free slots form an intrusive list threaded through `Entry::link`, so acquire
+// and release are O(1). Active slots are also listed in a dense array
+// (swap-removed on release), and `active()` walks only that, so iteration
+// costs the live count, not the capacity. Iteration order is not slot order.
+template <typename T, std::size_t ChunkSize = 64>
 class VidPool {
+    static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of two");
+
   public:
+    static constexpr std::size_t kNoSlot = std::numeric_limits<std::size_t>::max();
+    // Lua handles pack the slot id into 32 bits (see engine/lua_views.hpp).
+    static constexpr std::size_t kMaxSlots = std::numeric_limits<std::uint32_t>::max();
+
     struct Entry {
         VID vid{};
         bool active{false};
+        // Pool bookkeeping: the slot's index in the dense active array while
+        // active, the next free slot otherwise.
+        std::size_t link{kNoSlot};
         T value{};
     };
 
+    // Range over active entries, for range-for. Releasing during the walk
+    // moves entries; walk the indices from `active_slots()` backwards instead.
+    template <typename E>
+    class ActiveRange {
+      public:
+        class iterator {
+          public:
+            iterator(const VidPool* pool, const std::size_t* at) : pool_(pool), at_(at) {}
+            E& operator*() const { return pool_->slot_ref(*at_); }
+            E* operator->() const { return &pool_->slot_ref(*at_); }
+            iterator& operator++() {
+                ++at_;
+                return *this;
+            }
+            bool operator==(const iterator& other) const { return at_ == other.at_; }
+            bool operator!=(const iterator& other) const { return at_ != other.at_; }
+
+          private:
+            const VidPool* pool_;
+            const std::size_t* at_;
+        };
+
+        explicit ActiveRange(const VidPool* pool) : pool_(pool) {}
+        iterator begin() const { return {pool_, pool_->active_.data()}; }
+        iterator end() const { return {pool_, pool_->active_.data() + pool_->active_.size()}; }
+        std::size_t size() const { return pool_->active_.size(); }
+
+      private:
+        const VidPool* pool_;
+    };
+
     VidPool() = default;
     explicit VidPool(std::size_t capacity) {
         init(capacity);
     }
 
+    // Drops every entry and pre-allocates room for `capacity` of them.
     void init(std::size_t capacity) {
-        entries_.clear();
-        entries_.resize(capacity);
-        for (std::size_t i = 0; i < entries_.size(); ++i) {
-            entries_[i].vid.id = i;
-            entries_[i].active = false;
-            entries_[i].vid.version = 0;
-            entries_[i].value = T{};
+        chunks_.clear();
+        active_.clear();
+        free_head_ = kNoSlot;
+        retired_version_ = 0;
+        reserve(capacity);
+    }
+
+    // Grows (never shrinks) the allocation to hold at least `capacity` entries.
+    void reserve(std::size_t capacity) {
+        std::size_t before = this->capacity();
+        while (this->capacity() < std::min(capacity, kMaxSlots)) {
+            if (!grow())
+                break;
         }
+        if (this->capacity() != before)
+            rebuild_free_list();
+        active_.reserve(capacity);
     }
 
-    std::size_t capacity() const { return entries_.size(); }
+    std::size_t capacity() const { return chunks_.size() * ChunkSize; }
+    std::size_t size() const { return active_.size(); }
 
+    // Null only once kMaxSlots entries are live.
     Entry* acquire() {
-        for (auto& entry : entries_) {
-            if (!entry.active) {
-                entry.active = true;
-                entry.vid.version += 1;
-                entry.value = T{};
-                return &entry;
-            }
-        }
-        return nullptr;
+        if (free_head_ == kNoSlot && !grow())
+            return nullptr;
+        Entry& entry = slot_ref(free_head_);
+        free_head_ = entry.link;
+        entry.active = true;
+        entry.vid.version += 1;
+        entry.value = T{};
+        entry.link = active_.size();
+        active_.push_back(entry.vid.id);
+        return &entry;
     }
 
     void release(VID vid) {
-        if (Entry* slot = find_entry(vid)) {
-            slot->active = false;
-            slot->vid.version += 1;
-        }
+        Entry* slot = find_entry(vid);
+        if (!slot)
+            return;
+        std::size_t last = active_.back();
+        active_[slot->link] = last;
+        slot_ref(last).link = slot->link;
+        active_.pop_back();
+        slot->active = false;
+        slot->vid.version += 1;
+        slot->link = free_head_;
+        free_head_ = slot->vid.id;
     }
 
     void clear() {
-        for (auto& entry : entries_) {
-            if (entry.active) {
-                entry.active = false;
-                entry.vid.version += 1;
-            }
-            entry.value = T{};
+        for (std::size_t id : active_) {
+            Entry& entry = slot_ref(id);
+            entry.active = false;
+            entry.vid.version += 1;
         }
+        for (std::size_t id = 0; id < capacity(); ++id)
+            slot_ref(id).value = T{};
+        active_.clear();
+        rebuild_free_list();
+    }
+
+    // Frees trailing chunks with no active entries and re-sorts the free list
+    // so low slots are reused first, which keeps future trims effective.
+    // Active entries never move, so handles and pointers stay valid. O(capacity);
+    // meant for mode transitions, not per frame.
+    void shrink_to_fit() {
+        std::size_t keep = 0;
+        for (std::size_t id : active_)
+            keep = std::max(keep, id / ChunkSize + 1);
+        for (std::size_t c = keep; c < chunks_.size(); ++c) {
+            // Slots handed out again later must out-version any stale handle.
+            for (std::size_t i = 0; i < ChunkSize; ++i)
+                retired_version_ = std::max(retired_version_, chunks_[c][i].vid.version);
+        }
+        chunks_.resize(keep);
+        chunks_.shrink_to_fit();
+        active_.shrink_to_fit();
+        rebuild_free_list();
     }
 
     Entry* find_entry(VID vid) {
-        if (vid.id >= entries_.size())
+        if (vid.id >= capacity())
             return nullptr;
-        Entry& e = entries_[vid.id];
+        Entry& e = slot_ref(vid.id);
         if (!e.active || e.vid.version != vid.version)
             return nullptr;
         return &e;
     }
 
     const Entry* find_entry(VID vid) const {
-        if (vid.id >= entries_.size())
+        if (vid.id >= capacity())
             return nullptr;
-        const Entry& e = entries_[vid.id];
+        const Entry& e = slot_ref(vid.id);
         if (!e.active || e.vid.version != vid.version)
             return nullptr;
         return &e;
     }
 
-    std::vector<Entry>& entries() { return entries_; }
-    const std::vector<Entry>& entries() const { return entries_; }
+    ActiveRange<Entry> active() { return ActiveRange<Entry>(this); }
+    ActiveRange<const Entry> active() const { return ActiveRange<const Entry>(this); }
+    // Slot indices of active entries, densely packed.
+    const std::vector<std::size_t>& active_slots() const { return active_; }
+
+    // Any slot below capacity(), active or not.
+    Entry& slot(std::size_t id) { return slot_ref(id); }
+    const Entry& slot(std::size_t id) const { return slot_ref(id); }
 
   private:
-    std::vector<Entry> entries_;
+    Entry& slot_ref(std::size_t id) const { return chunks_[id / ChunkSize][id % ChunkSize]; }
+
+    bool grow() {
+        std::size_t base = capacity();
+        if (kMaxSlots - base < ChunkSize)
+            return false;
+        auto chunk = std::make_unique<Entry[]>(ChunkSize);
+        // Ascending onto the free list, ahead of anything already there.
+        for (std::size_t i = ChunkSize; i-- > 0;) {
+            chunk[i].vid.id = base + i;
+            chunk[i].vid.version = retired_version_;
+            chunk[i].link = free_head_;
+            free_head_ = base + i;
+        }
+        chunks_.push_back(std::move(chunk));
+        return true;
+    }
+
+    // Ascending, so a fresh or cleared pool hands out slots 0, 1, 2, ...
+    void rebuild_free_list() {
+        free_head_ = kNoSlot;
+        for (std::size_t id = capacity(); id-- > 0;) {
+            Entry& entry = slot_ref(id);
+            if (entry.active)
+                continue;
+            entry.link = free_head_;
+            free_head_ = id;
+        }
+    }
+
+    std::vector<std::unique_ptr<Entry[]>> chunks_;
+    std::vector<std::size_t> active_;
+    std::size_t free_head_{kNoSlot};
+    std::uint32_t retired_version_{0};
 };
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "engine/vid.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Structure-of-arrays counterpart to VidPool. Each field type gets its own
+// contiguous column, 64-byte aligned, and live rows are packed at the front
+// (release swaps the last row into the hole). `column<I>()` is therefore a
+// span of exactly the live values, ready for a tight or vectorized loop:
+//
+//     VidSoAPool<glm::vec2, glm::vec2, float> bodies{4096}; // pos, vel, timer
+//     auto pos = bodies.column<0>();
+//     auto vel = bodies.column<1>();
+//     for (std::size_t i = 0; i < pos.size(); ++i)
+//         pos[i] += vel[i] * dt;
+//
+// Handles are the same VIDs VidPool hands out: id is a stable slot index,
+// version increments on every acquire and release. Rows move on release, so
+// keep VIDs, not row indices, across frames. Capacity is fixed at init();
+// columns are padded to a multiple of kColumnPad elements so kernels may run
+// whole vector widths past the last row without leaving the allocation.
+template <typename... Fields>
+class VidSoAPool {
+    static_assert(sizeof...(Fields) > 0, "VidSoAPool needs at least one column");
+    static_assert((std::is_default_constructible_v<Fields> && ...), "columns must be default constructible");
+
+  public:
+    static constexpr std::size_t kNoSlot = std::numeric_limits<std::size_t>::max();
+    static constexpr std::size_t kColumnAlign = 64;
+    static constexpr std::size_t kColumnPad = 16;
+
+    template <std::size_t I>
+    using Field = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    VidSoAPool() = default;
+    explicit VidSoAPool(std::size_t capacity) {
+        init(capacity);
+    }
+
+    void init(std::size_t capacity) {
+        slots_.assign(capacity, Slot{});
+        rows_.assign(capacity, 0);
+        size_ = 0;
+        std::size_t padded = (capacity + kColumnPad - 1) / kColumnPad * kColumnPad;
+        std::apply([&](auto&... cols) { (cols.allocate(padded), ...); }, columns_);
+        free_head_ = kNoSlot;
+        for (std::size_t i = capacity; i-- > 0;) {
+            slots_[i].link = free_head_;
+            free_head_ = i;
+        }
+    }
+
+    std::size_t capacity() const { return slots_.size(); }
+    std::size_t size() const { return size_; }
+
+    // Appends a row of default values. Invalid VID (version 0) when full.
+    VID acquire() {
+        if (free_head_ == kNoSlot)
+            return VID{};
+        std::size_t id = free_head_;
+        Slot& slot = slots_[id];
+        free_head_ = slot.link;
+        slot.active = true;
+        slot.version += 1;
+        slot.link = size_;
+        rows_[size_] = id;
+        std::apply([&](auto&... cols) { ((cols.data[size_] = {}), ...); }, columns_);
+        size_ += 1;
+        return VID{id, slot.version};
+    }
+
+    void release(VID vid) {
+        std::size_t row = find_row(vid);
+        if (row == kNoSlot)
+            return;
+        std::size_t last = size_ - 1;
+        if (row != last) {
+            std::apply([&](auto&... cols) { ((cols.data[row] = std::move(cols.data[last])), ...); }, columns_);
+            rows_[row] = rows_[last];
+            slots_[rows_[row]].link = row;
+        }
+        size_ = last;
+        Slot& slot = slots_[vid.id];
+        slot.active = false;
+        slot.version += 1;
+        slot.link = free_head_;
+        free_head_ = vid.id;
+    }
+
+    void clear() {
+        while (size_ > 0)
+            release(vid_at(size_ - 1));
+    }
+
+    // Row of a live VID, or kNoSlot if the handle is stale.
+    std::size_t find_row(VID vid) const {
+        if (vid.id >= slots_.size())
+            return kNoSlot;
+        const Slot& slot = slots_[vid.id];
+        if (!slot.active || slot.version != vid.version)
+            return kNoSlot;
+        return slot.link;
+    }
+
+    bool contains(VID vid) const { return find_row(vid) != kNoSlot; }
+
+    VID vid_at(std::size_t row) const {
+        std::size_t id = rows_[row];
+        return VID{id, slots_[id].version};
+    }
+
+    // Live values of one column, row order.
+    template <std::size_t I>
+    std::span<Field<I>> column() {
+        return {std::get<I>(columns_).data, size_};
+    }
+
+    template <std::size_t I>
+    std::span<const Field<I>> column() const {
+        return {std::get<I>(columns_).data, size_};
+    }
+
+    template <std::size_t I>
+    Field<I>* get(VID vid) {
+        std::size_t row = find_row(vid);
+        return row == kNoSlot ? nullptr : &std::get<I>(columns_).data[row];
+    }
+
+    template <std::size_t I>
+    const Field<I>* get(VID vid) const {
+        std::size_t row = find_row(vid);
+        return row == kNoSlot ? nullptr : &std::get<I>(columns_).data[row];
+    }
+
+  private:
+    struct Slot {
+        std::uint32_t version{0};
+        bool active{false};
+        // Row while active, next free slot otherwise.
+        std::size_t link{kNoSlot};
+    };
+
+    template <typename T>
+    struct Column {
+        T* data{nullptr};
+        std::size_t count{0};
+
+        Column() = default;
+        Column(const Column&) = delete;
+        Column& operator=(const Column&) = delete;
+        Column(Column&& other) noexcept : data(std::exchange(other.data, nullptr)), count(std::exchange(other.count, 0)) {}
+        Column& operator=(Column&& other) noexcept {
+            if (this != &other) {
+                release();
+                data = std::exchange(other.data, nullptr);
+                count = std::exchange(other.count, 0);
+            }
+            return *this;
+        }
+        ~Column() { release(); }
+
+        void allocate(std::size_t n) {
+            release();
+            if (n == 0)
+                return;
+            void* raw = ::operator new(n * sizeof(T), std::align_val_t{kColumnAlign});
+            data = static_cast<T*>(raw);
+            std::uninitialized_value_construct_n(data, n);
+            count = n;
+        }
+
+        void release() {
+            if (!data)
+                return;
+            std::destroy_n(data, count);
+            ::operator delete(data, std::align_val_t{kColumnAlign});
+            data = nullptr;
+            count = 0;
+        }
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<std::size_t> rows_; // row -> slot id
+    std::size_t size_{0};
+    std::size_t free_head_{kNoSlot};
+    std::tuple<Column<Fields>...> columns_;
+};
@@ -1,6 +1,7 @@
 #include "game/mod_api/demo_content_internal.hpp"
 
 #include "engine/globals.hpp"
+#include "engine/mod_state.hpp"
 #include "game/state.hpp"
 
 #include <algorithm>
@@ -24,6 +25,18 @@ std::vector<DemoContentEntry> g_entries;
 DemoPlayer g_default_player{};
 BonkTarget g_default_bonk{};
 bool g_defaults_captured = false;
+// Overrides only reset the session when they change.
+bool g_overrides_dirty = true;
+
+// Live player/bonk state saved by a reloading mod, put back after the
+// overrides are reapplied.
+struct RestoredSession {
+    glm::vec2 player_pos{0.0f, 0.0f};
+    glm::vec2 bonk_pos{0.0f, 0.0f};
+    bool bonk_enabled{true};
+};
+bool g_has_restore = false;
+RestoredSession g_restore{};
 
 void ensure_defaults_captured() {
     if (g_defaults_captured || !ss)
@@ -82,20 +95,63 @@ void register_override(const std::string& mod_id, const sol::table& tbl) {
         entry.bonk = read_bonk(*bonk_tbl, g_default_bonk);
     }
     g_entries.push_back(std::move(entry));
+    g_overrides_dirty = true;
 }
 
 void remove_override(const std::string& mod_id) {
-    g_entries.erase(std::remove_if(g_entries.begin(), g_entries.end(),
-                                   [&](const DemoContentEntry& entry) {
-                                       return entry.mod_id == mod_id;
-                                   }),
-                    g_entries.end());
+    auto it = std::remove_if(g_entries.begin(), g_entries.end(),
+                             [&](const DemoContentEntry& entry) {
+                                 return entry.mod_id == mod_id;
+                             });
+    if (it != g_entries.end())
+        g_overrides_dirty = true;
+    g_entries.erase(it, g_entries.end());
+}
+
+void save_session(ModStateWriter& w) {
+    if (!ss || ss->players.empty())
+        return;
+    w.put_f32(ss->players[0].pos.x);
+    w.put_f32(ss->players[0].pos.y);
+    w.put_f32(ss->bonk.pos.x);
+    w.put_f32(ss->bonk.pos.y);
+    w.put_u8(ss->bonk.enabled ? 1 : 0);
+}
+
+void load_session(ModStateReader& r) {
+    RestoredSession restore;
+    restore.player_pos.x = r.get_f32();
+    restore.player_pos.y = r.get_f32();
+    restore.bonk_pos.x = r.get_f32();
+    restore.bonk_pos.y = r.get_f32();
+    restore.bonk_enabled = r.get_u8() != 0;
+    if (!r.ok)
+        return;
+    g_restore = restore;
+    g_has_restore = true;
+}
+
+// A restore belongs to the finalize of the reload that saved it, so it is
+// consumed here on every call: applied when there is a session, dropped
+// otherwise, and never left for a later, unrelated finalize.
+void apply_pending_restore() {
+    if (!g_has_restore)
+        return;
+    g_has_restore = false;
+    if (!ss || ss->players.empty())
+        return;
+    ss->players[0].pos = g_restore.player_pos;
+    ss->bonk.pos = g_restore.bonk_pos;
+    ss->bonk.enabled = g_restore.bonk_enabled;
 }
 
 void apply_overrides() {
     ensure_defaults_captured();
-    if (!ss)
+    if (!ss || !g_overrides_dirty) {
+        apply_pending_restore();
         return;
+    }
+    g_overrides_dirty = false;
 
     DemoPlayer player = g_default_player;
     BonkTarget bonk = g_default_bonk;
@@ -111,6 +167,7 @@ void apply_overrides() {
     else
         ss->players[0] = player;
     ss->bonk = bonk;
+    apply_pending_restore();
 
     if (g_entries.empty())
         std::fprintf(stderr, "[demo] no demo content overrides; using defaults\n");
@@ -3,11 +3,18 @@
 #include "engine/audio.hpp"
 #include "engine/graphics.hpp"
 #include "engine/globals.hpp"
+#include "engine/lua_views.hpp"
+#include "engine/mod_events.hpp"
+#include "engine/mod_host.hpp"
+#include "engine/mod_state.hpp"
+#include "engine/spatial_grid.hpp"
 #include "game/mod_api/demo_items_internal.hpp"
 #include "state.hpp"
 
 #include <cstdio>
+#include <optional>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -18,7 +25,8 @@
 
 namespace {
 
-constexpr std::size_t kMaxDemoItemInstances = 32;
+// Around a pad's diameter plus a player's reach.
+constexpr float kDemoItemCellSize = 2.0f;
 
 struct DemoItemRecord {
     DemoItemDef def;
@@ -28,10 +36,20 @@ struct DemoItemRecord {
 
 std::vector<DemoItemRecord> g_records;
 std::vector<DemoItemDef> g_public_defs;
-DemoItemPool g_item_pool{kMaxDemoItemInstances};
+DemoItemPool g_item_pool; // grows a chunk at a time as pads spawn
+// Live instances by position, for proximity checks in play.
+SpatialGrid g_item_grid{kDemoItemCellSize};
 std::unordered_map<std::string, std::size_t> g_lookup;
 bool g_demo_items_active = false;
 
+// Where a pad stood, kept across `finalize_items` (and, via the mod state
+// blob, across its mod's reload). Dropped if the def has moved since.
+struct KeptItem {
+    glm::vec2 position{0.0f, 0.0f};
+    glm::vec2 def_position{0.0f, 0.0f};
+};
+std::unordered_map<std::string, KeptItem> g_restored_items;
+
 DemoPlayer* ensure_primary_player() {
     if (!ss)
         return nullptr;
@@ -40,32 +58,47 @@ DemoPlayer* ensure_primary_player() {
     return &ss->players[0];
 }
 
+// One per mod state. Writes go through the mod's command buffer so a
+// script calling `api` at top level, while it activates on a worker, never
+// touches game state off the main thread.
 struct DemoApi {
+    ModContext* ctx{nullptr};
+
     void alert(const std::string& text) const {
-        Alert al;
-        al.text = text;
-        al.ttl = 1.4f;
-        add_alert(al.text);
+        run_mod_command(*ctx, [text] {
+            Alert al;
+            al.text = text;
+            al.ttl = 1.4f;
+            add_alert(al.text);
+        });
     }
     void set_player_position(float x, float y) const {
-        if (DemoPlayer* player = ensure_primary_player())
-            player->pos = glm::vec2{x, y};
+        run_mod_command(*ctx, [x, y] {
+            if (DemoPlayer* player = ensure_primary_player())
+                player->pos = glm::vec2{x, y};
+        });
     }
     void play_sound(const std::string& key) const {
         if (!key.empty())
-            ::play_sound(key);
+            run_mod_command(*ctx, [key] { ::play_sound(key); });
     }
     void set_bonk_enabled(bool enabled) const {
-        ss->bonk.enabled = enabled;
+        run_mod_command(*ctx, [enabled] { ss->bonk.enabled = enabled; });
     }
     void set_bonk_position(float x, float y) const {
-        ss->bonk.pos = glm::vec2{x, y};
+        run_mod_command(*ctx, [x, y] { ss->bonk.pos = glm::vec2{x, y}; });
     }
     bool set_item_position(const std::string& def_id, float x, float y) const;
     sol::object get_item_position(const std::string& def_id, sol::this_state state) const;
-};
 
-DemoApi g_api{};
+    // Handle-based queries; none of these allocate on the Lua side.
+    std::tuple<lua_CFunction, sol::lua_nil_t, LuaHandle> items() const;
+    std::size_t item_count() const;
+    LuaHandle find_item(const std::string& def_id) const;
+    sol::optional<std::string> item_def(LuaHandle handle) const;
+    bool item_position(LuaHandle handle, glm::vec2& out) const;
+    bool move_item(LuaHandle handle, float x, float y) const;
+};
 
 DemoItemRecord* find_record_by_id(const std::string& id) {
     auto it = g_lookup.find(id);
@@ -78,11 +111,17 @@ DemoItemRecord* find_record_by_id(const std::string& id) {
 
 void clear_instances() {
     g_item_pool.clear();
+    g_item_grid.clear();
+}
+
+void move_instance(DemoItemPool::Entry& entry, glm::vec2 pos) {
+    entry.value.position = pos;
+    g_item_grid.move(entry.vid, pos);
 }
 
 DemoItemPool::Entry* find_instance_by_def_index(std::size_t def_index) {
-    for (auto& entry : g_item_pool.entries()) {
-        if (entry.active && entry.value.def_index == static_cast<int>(def_index))
+    for (auto& entry : g_item_pool.active()) {
+        if (entry.value.def_index == static_cast<int>(def_index))
             return &entry;
     }
     return nullptr;
@@ -96,11 +135,13 @@ DemoItemPool::Entry* find_instance_by_def_id(const std::string& def_id) {
 }
 
 bool DemoApi::set_item_position(const std::string& def_id, float x, float y) const {
-    if (auto* entry = find_instance_by_def_id(def_id)) {
-        entry->value.position = glm::vec2{x, y};
-        return true;
-    }
-    return false;
+    if (!find_instance_by_def_id(def_id))
+        return false;
+    run_mod_command(*ctx, [def_id, x, y] {
+        if (auto* entry = find_instance_by_def_id(def_id))
+            move_instance(*entry, glm::vec2{x, y});
+    });
+    return true;
 }
 
 sol::object DemoApi::get_item_position(const std::string& def_id, sol::this_state state) const {
@@ -114,13 +155,80 @@ sol::object DemoApi::get_item_position(const std::string& def_id, sol::this_stat
     return sol::make_object(lua, sol::lua_nil);
 }
 
-bool spawn_instance(std::size_t def_index, const glm::vec2& pos) {
+const DemoItemPool::Entry* find_instance_by_handle(LuaHandle handle) {
+    return g_item_pool.find_entry(vid_from_lua_handle(handle));
+}
+
+// Stateless generic-for iterator: (state, previous handle) -> next live handle.
+// Walks the pool's dense active list; the previous handle's entry knows its
+// position there. Iteration ends early if that item was removed meanwhile.
+int next_item_handle(lua_State* L) {
+    LuaHandle prev = static_cast<LuaHandle>(lua_tointeger(L, 2));
+    std::size_t next = 0;
+    if (prev != 0) {
+        const auto* entry = find_instance_by_handle(prev);
+        next = entry ? entry->link + 1 : DemoItemPool::kNoSlot;
+    }
+    const auto& slots = g_item_pool.active_slots();
+    if (next < slots.size()) {
+        const auto& entry = g_item_pool.slot(slots[next]);
+        lua_pushinteger(L, static_cast<lua_Integer>(lua_handle_from_vid(entry.vid)));
+        return 1;
+    }
+    lua_pushnil(L);
+    return 1;
+}
+
+std::tuple<lua_CFunction, sol::lua_nil_t, LuaHandle> DemoApi::items() const {
+    return {&next_item_handle, sol::lua_nil, 0};
+}
+
+std::size_t DemoApi::item_count() const {
+    return g_item_pool.size();
+}
+
+LuaHandle DemoApi::find_item(const std::string& def_id) const {
+    if (auto* entry = find_instance_by_def_id(def_id))
+        return lua_handle_from_vid(entry->vid);
+    return 0;
+}
+
+sol::optional<std::string> DemoApi::item_def(LuaHandle handle) const {
+    if (auto* entry = find_instance_by_handle(handle)) {
+        if (const DemoItemDef* def = demo_item_def(entry->value))
+            return def->id;
+    }
+    return sol::nullopt;
+}
+
+bool DemoApi::item_position(LuaHandle handle, glm::vec2& out) const {
+    auto* entry = find_instance_by_handle(handle);
+    if (!entry)
+        return false;
+    out = entry->value.position;
+    return true;
+}
+
+bool DemoApi::move_item(LuaHandle handle, float x, float y) const {
+    if (!find_instance_by_handle(handle))
+        return false;
+    run_mod_command(*ctx, [handle, x, y] {
+        if (auto* entry = g_item_pool.find_entry(vid_from_lua_handle(handle)))
+            move_instance(*entry, glm::vec2{x, y});
+    });
+    return true;
+}
+
+bool spawn_instance(std::size_t def_index, const glm::vec2& pos, const glm::vec2& def_pos) {
     if (auto* entry = g_item_pool.acquire()) {
         entry->value.def_index = static_cast<int>(def_index);
         entry->value.position = pos;
+        entry->value.def_position = def_pos;
+        const DemoItemDef* def = demo_item_def(entry->value);
+        g_item_grid.insert(entry->vid, pos, def ? def->radius : 0.0f);
         return true;
     }
-    std::fprintf(stderr, "[demo_items] no free instance slots (max %zu)\n", kMaxDemoItemInstances);
+    std::fprintf(stderr, "[demo_items] instance pool exhausted (%zu live)\n", g_item_pool.size());
     return false;
 }
 
@@ -197,7 +305,7 @@ sol::table make_item_table(sol::state_view lua, const DemoItemDef& item,
 
 namespace demo_items_internal {
 
-void expose_runtime_api(sol::state& lua) {
+void expose_runtime_api(sol::state& lua, ModContext& ctx) {
     lua.new_usertype<DemoApi>("DemoAPI",
         "alert", &DemoApi::alert,
         "set_player_position", &DemoApi::set_player_position,
@@ -205,8 +313,14 @@ void expose_runtime_api(sol::state& lua) {
         "set_bonk_enabled", &DemoApi::set_bonk_enabled,
         "set_bonk_position", &DemoApi::set_bonk_position,
         "set_item_position", &DemoApi::set_item_position,
-        "get_item_position", &DemoApi::get_item_position);
-    lua["api"] = &g_api;
+        "get_item_position", &DemoApi::get_item_position,
+        "items", &DemoApi::items,
+        "item_count", &DemoApi::item_count,
+        "find_item", &DemoApi::find_item,
+        "item_def", &DemoApi::item_def,
+        "item_position", &DemoApi::item_position,
+        "move_item", &DemoApi::move_item);
+    lua["api"] = DemoApi{&ctx};
 }
 
 void register_item(const std::string& mod_id, const sol::table& t) {
@@ -269,32 +383,115 @@ void remove_mod_items(const std::string& mod_id) {
     g_lookup.clear();
     for (std::size_t i = 0; i < g_records.size(); ++i)
         g_lookup[g_records[i].def.id] = i;
+    // Instances index records: drop the removed mod's, renumber the rest.
+    // Backwards, since release swap-removes from the active list.
+    const auto& slots = g_item_pool.active_slots();
+    for (std::size_t i = slots.size(); i-- > 0;) {
+        auto& entry = g_item_pool.slot(slots[i]);
+        const DemoItemDef* def = demo_item_def(entry.value);
+        auto it = def ? g_lookup.find(def->id) : g_lookup.end();
+        if (it == g_lookup.end()) {
+            g_item_grid.remove(entry.vid);
+            g_item_pool.release(entry.vid);
+        } else
+            entry.value.def_index = static_cast<int>(it->second);
+    }
     rebuild_public_items();
     g_demo_items_active = !g_records.empty();
 }
 
 void finalize_items() {
+    // Pads keep their live positions through a reload unless their def was
+    // moved since they spawned; positions restored from a reloading mod's
+    // state come first.
+    std::unordered_map<std::string, KeptItem> kept = std::move(g_restored_items);
+    g_restored_items.clear();
+    for (const auto& entry : g_item_pool.active()) {
+        auto index = static_cast<std::size_t>(entry.value.def_index);
+        if (entry.value.def_index >= 0 && index < g_records.size())
+            kept.emplace(g_records[index].def.id, KeptItem{entry.value.position, entry.value.def_position});
+    }
+
     rebuild_public_items();
     clear_instances();
     for (std::size_t i = 0; i < g_public_defs.size(); ++i) {
         const auto& def = g_public_defs[i];
-        spawn_instance(i, def.position);
+        glm::vec2 pos = def.position;
+        auto it = kept.find(def.id);
+        if (it != kept.end() && it->second.def_position == def.position)
+            pos = it->second.position;
+        spawn_instance(i, pos, def.position);
     }
     g_demo_items_active = !g_public_defs.empty();
 }
 
+void save_mod_items(const std::string& mod_id, ModStateWriter& w) {
+    std::vector<const DemoItemPool::Entry*> owned;
+    for (const auto& entry : g_item_pool.active()) {
+        auto index = static_cast<std::size_t>(entry.value.def_index);
+        if (entry.value.def_index >= 0 && index < g_records.size() &&
+            g_records[index].owner_mod == mod_id)
+            owned.push_back(&entry);
+    }
+    if (owned.empty())
+        return;
+    w.put_u32(static_cast<std::uint32_t>(owned.size()));
+    for (const auto* entry : owned) {
+        w.put_str(g_records[static_cast<std::size_t>(entry->value.def_index)].def.id);
+        w.put_f32(entry->value.position.x);
+        w.put_f32(entry->value.position.y);
+        w.put_f32(entry->value.def_position.x);
+        w.put_f32(entry->value.def_position.y);
+    }
+}
+
+void load_mod_items(ModStateReader& r) {
+    std::uint32_t count = r.get_u32();
+    for (std::uint32_t i = 0; i < count && r.ok; ++i) {
+        std::string id = r.get_str();
+        KeptItem item;
+        item.position.x = r.get_f32();
+        item.position.y = r.get_f32();
+        item.def_position.x = r.get_f32();
+        item.def_position.y = r.get_f32();
+        if (r.ok)
+            g_restored_items[id] = item;
+    }
+}
+
 bool has_active_items() {
     return g_demo_items_active;
 }
 
+void run_item_use_events(const ModEventQueue& events) {
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        if (events.kind[i] != ModEventType::ItemUsed)
+            continue;
+        // The pad may have been removed since the event was pushed.
+        if (auto* entry = g_item_pool.find_entry(vid_from_lua_handle(events.subject[i])))
+            trigger_demo_item_use(entry->value);
+    }
+}
+
 } // namespace demo_items_internal
 
 const std::vector<DemoItemDef>& demo_item_defs() {
     return g_public_defs;
 }
 
-const std::vector<DemoItemPool::Entry>& demo_item_instance_slots() {
-    return g_item_pool.entries();
+const DemoItemPool& demo_item_instances() {
+    return g_item_pool;
+}
+
+const SpatialGrid& demo_item_grid() {
+    return g_item_grid;
+}
+
+void compact_demo_items() {
+    std::size_t before = g_item_pool.capacity();
+    g_item_pool.shrink_to_fit();
+    if (g_item_pool.capacity() != before)
+        std::printf("[demo_items] instance pool trimmed %zu -> %zu slots\n", before, g_item_pool.capacity());
 }
 
 const DemoItemDef* demo_item_def(const DemoItemInstance& inst) {
@@ -314,6 +511,9 @@ void trigger_demo_item_use(const DemoItemInstance& inst) {
     sol::state_view lua(rec.on_use.lua_state());
     sol::table info = make_item_table(lua, rec.def, &inst);
     sol::protected_function_result r;
+    std::optional<ModCallScope> scope;
+    if (ModContext* owner = find_active_mod(rec.owner_mod))
+        scope.emplace(*owner);
     try {
         r = rec.on_use(info);
     } catch (const sol::error& e) {
@@ -322,6 +522,7 @@ void trigger_demo_item_use(const DemoItemInstance& inst) {
         add_alert(std::string("Pad failed: ") + rec.def.label);
         return;
     }
+    scope.reset();
     if (!r.valid()) {
         sol::error e = r;
         std::fprintf(stderr, "[demo_items] on_use error (%s): %s\n",
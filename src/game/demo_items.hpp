@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 
+class SpatialGrid;
+
 // DemoItemDef: template metadata registered by Lua mods. Mods call register_item{}
 // to append more defs; gameplay consumes demo_item_defs(). See docs/demo_defs.md.
 struct DemoItemDef {
@@ -21,12 +23,17 @@ struct DemoItemDef {
 struct DemoItemInstance {
     int def_index{-1};
     glm::vec2 position{0.0f, 0.0f};
+    glm::vec2 def_position{0.0f, 0.0f}; // the def's position when this spawned
 };
 
 using DemoItemPool = VidPool<DemoItemInstance>;
 
 const std::vector<DemoItemDef>& demo_item_defs();
-const std::vector<DemoItemPool::Entry>& demo_item_instance_slots();
+const DemoItemPool& demo_item_instances();
+// Live instances keyed by VID, each with its def's radius.
+const SpatialGrid& demo_item_grid();
+// Returns unused instance chunks to the allocator; call between modes.
+void compact_demo_items();
 const DemoItemDef* demo_item_def(const DemoItemInstance& inst);
 void trigger_demo_item_use(const DemoItemInstance& inst);
 bool demo_items_active();
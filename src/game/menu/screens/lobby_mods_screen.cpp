@@ -10,8 +10,9 @@
 
 #include "engine/alerts.hpp"
 #include "engine/globals.hpp"
-#include "engine/mod_install.hpp"
+#include "engine/mod_catalog.hpp"
 #include "engine/mod_host.hpp"
+#include "engine/mod_jobs.hpp"
 #include "engine/mods.hpp"
 #include "engine/menu/menu_commands.hpp"
 #include "engine/menu/menu_manager.hpp"
@@ -31,7 +32,6 @@ constexpr WidgetId kPrevButtonId = 604;
 constexpr WidgetId kNextButtonId = 605;
 constexpr WidgetId kBackButtonId = 630;
 constexpr WidgetId kFirstCardWidgetId = 620;
-constexpr const char* kModServerUrl = "http://127.0.0.1:8787";
 
 MenuCommandId g_cmd_page_delta = kMenuIdInvalid;
 MenuCommandId g_cmd_toggle_mod = kMenuIdInvalid;
@@ -59,9 +59,12 @@ struct LobbyModsState {
     std::string search_query;
     std::string prev_search;
     bool catalog_loaded{false};
-    bool busy{false};
+    bool refresh_requested{false};
+    std::uint64_t catalog_revision{0};
+    std::uint64_t job_cursor{0};
     std::vector<ModCatalogEntry> catalog;
     std::vector<SessionModEntry> entries;
+    std::unordered_map<std::string, std::string> job_badges; // mod id -> install progress
 };
 
 MenuWidget make_label_widget(WidgetId id, UILayoutObjectId slot, const char* label) {
@@ -116,6 +119,8 @@ SDL_Color badge_color_for(const std::string& status) {
     std::string lower = status;
     std::transform(lower.begin(), lower.end(), lower.begin(),
                    [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (lower.find("installing") != std::string::npos || lower.find("queued") != std::string::npos)
+        return SDL_Color{120, 170, 255, 255};
     if (lower.find("incompatible") != std::string::npos || lower.find("needs game") != std::string::npos)
         return SDL_Color{240, 190, 120, 255};
     if (lower.find("core") != std::string::npos)
@@ -228,20 +233,24 @@ void ensure_lobby_entry(LobbySession& lobby, const SessionModEntry& entry) {
     lobby.mods.push_back(std::move(target));
 }
 
+// Reads the shared catalog snapshot; the refresh itself runs in the background.
 bool ensure_catalog_loaded(LobbyModsState& st) {
-    if (st.catalog_loaded || st.busy)
+    if (!st.refresh_requested) {
+        request_mod_catalog_refresh();
+        st.refresh_requested = true;
+        st.job_cursor = mod_job_events_head();
+    }
+    if (st.catalog_loaded && !mod_jobs_idle())
         return st.catalog_loaded;
-    st.busy = true;
-    std::string err;
-    if (!fetch_mod_catalog(kModServerUrl, st.catalog, err)) {
-        st.status_message = err.empty() ? "Failed to fetch catalog" : err;
-        st.busy = false;
-        return false;
+    if (poll_mod_catalog(st.catalog_revision, st.catalog)) {
+        st.status_message = "Catalog loaded";
+        st.catalog_loaded = true;
+    } else if (!st.catalog_loaded) {
+        ModCatalogStatus status = mod_catalog_status();
+        if (!status.refreshing && !status.error.empty())
+            st.status_message = status.error;
     }
-    st.status_message = "Catalog loaded";
-    st.catalog_loaded = true;
-    st.busy = false;
-    return true;
+    return st.catalog_loaded;
 }
 
 void rebuild_entries(LobbyModsState& st, LobbySession& lobby) {
@@ -263,7 +272,7 @@ void rebuild_entries(LobbyModsState& st, LobbySession& lobby) {
             entry.game_version = cat.game_version;
             entry.dependencies = cat.dependencies;
             entry.required = cat.required || cat.id == "base";
-            entry.installed = path_exists(cat);
+            entry.installed = path_exists(cat) && !mod_job_pending(cat.id);
             entry.enabled = entry.required || enabled_map[entry.id];
             st.entries.push_back(entry);
             seen.insert(entry.id);
@@ -348,14 +357,11 @@ bool enable_with_dependencies(LobbyModsState& st,
             visiting.erase(entry.id);
             return false;
         }
-        std::string install_err;
-        if (!install_mod_from_catalog(kModServerUrl, st.catalog[static_cast<std::size_t>(cat_idx)], install_err)) {
-            err = install_err.empty() ? "Install failed" : install_err;
-            visiting.erase(entry.id);
-            return false;
-        }
-        lobby_refresh_mods();
-        entry.installed = true;
+        // Enabled right away; the install lands in the background and a
+        // failure disables the mod again (see apply_job_events).
+        if (!mod_job_pending(entry.id))
+            queue_mod_install(kModServerUrl, st.catalog[static_cast<std::size_t>(cat_idx)]);
+        st.job_badges[entry.id] = "Queued";
     }
 
     ensure_lobby_entry(lobby, entry);
@@ -379,10 +385,44 @@ bool has_enabled_dependents(const LobbySession& lobby, const std::string& id, st
     return false;
 }
 
+// Tracks background installs started from this screen in the card badges.
+void apply_job_events(LobbyModsState& st, LobbySession& lobby) {
+    ModJobEvent ev;
+    while (next_mod_job_event(st.job_cursor, ev)) {
+        if (ev.kind != ModJobKind::Install)
+            continue;
+        switch (ev.stage) {
+        case ModJobStage::Queued:
+            st.job_badges[ev.mod_id] = "Queued";
+            break;
+        case ModJobStage::Downloading:
+            if (ev.bytes_total > 0)
+                st.job_badges[ev.mod_id] =
+                    "Installing " +
+                    std::to_string(std::min<std::uint64_t>(100, ev.bytes_done * 100 / ev.bytes_total)) + "%";
+            else
+                st.job_badges[ev.mod_id] = "Installing...";
+            break;
+        case ModJobStage::Committing:
+            st.job_badges[ev.mod_id] = "Installing...";
+            break;
+        case ModJobStage::Done:
+            st.job_badges.erase(ev.mod_id);
+            break;
+        case ModJobStage::Failed: {
+            st.job_badges.erase(ev.mod_id);
+            int lobby_idx = find_lobby_entry(lobby, ev.mod_id);
+            if (lobby_idx >= 0)
+                lobby.mods[static_cast<std::size_t>(lobby_idx)].enabled = false;
+            add_alert("Install failed: " + (ev.message.empty() ? ev.mod_id : ev.message));
+            break;
+        }
+        }
+    }
+}
+
 void command_toggle_mod(MenuContext& ctx, std::int32_t index) {
     auto& st = ctx.state<LobbyModsState>();
-    if (st.busy)
-        return;
     LobbySession& lobby = lobby_state();
     if (index < 0 || index >= static_cast<int>(st.entries.size()))
         return;
@@ -403,13 +443,11 @@ void command_toggle_mod(MenuContext& ctx, std::int32_t index) {
         return;
     }
 
-    st.busy = true;
     std::unordered_set<std::string> visiting;
     std::string err;
     if (!enable_with_dependencies(st, lobby, index, visiting, err)) {
         add_alert(err.empty() ? "Failed to enable mod" : err);
     }
-    st.busy = false;
 }
 
 void rebuild_filter(LobbyModsState& st, const std::vector<SessionModEntry>& mods) {
@@ -447,6 +485,7 @@ BuiltScreen build_lobby_mods(MenuContext& ctx) {
 
     auto& st = ctx.state<LobbyModsState>();
     ensure_catalog_loaded(st);
+    apply_job_events(st, lobby);
     rebuild_entries(st, lobby);
     if (st.search_query != st.prev_search) {
         st.prev_search = st.search_query;
@@ -560,6 +599,8 @@ BuiltScreen build_lobby_mods(MenuContext& ctx) {
                 }
             } else if (entry.required) {
                 card.badge = "Core";
+            } else if (auto job = st.job_badges.find(entry.id); job != st.job_badges.end()) {
+                card.badge = job->second.c_str();
             } else if (!entry.installed) {
                 card.badge = "Not installed";
             } else if (entry.enabled) {
@@ -11,6 +11,7 @@
 #include "engine/menu/menu_manager.hpp"
 #include "engine/menu/menu_screen.hpp"
 #include "engine/mod_host.hpp"
+#include "engine/mod_jobs.hpp"
 #include "engine/player.hpp"
 #include "game/menu/lobby_state.hpp"
 #include "game/menu/menu_ids.hpp"
@@ -104,6 +105,10 @@ void command_browse_servers(MenuContext& ctx, std::int32_t) {
 }
 
 void command_start_game(MenuContext& ctx, std::int32_t) {
+    if (!mod_jobs_idle()) {
+        add_alert("Mods are still installing");
+        return;
+    }
     lobby_refresh_mods();
     auto enabled = lobby_enabled_mod_ids();
     set_active_mods(enabled);
@@ -2,6 +2,7 @@
 
 #include "engine/mod_api_registry.hpp"
 #include "engine/mod_host.hpp"
+#include "engine/mod_state.hpp"
 #include "game/mod_api/demo_content_internal.hpp"
 
 #include <sol/sol.hpp>
@@ -11,13 +12,21 @@ void register_demo_content_api(ModApiRegistry& registry) {
     desc.name = "demo_content";
     desc.bind_lua = [](sol::state& lua, ModContext& ctx) {
         lua.set_function("register_demo_content", [&ctx](const sol::table& tbl) {
-            demo_content_internal::remove_override(ctx.id);
-            demo_content_internal::register_override(ctx.id, tbl);
+            run_mod_command(ctx, [&ctx, tbl] {
+                demo_content_internal::remove_override(ctx.id);
+                demo_content_internal::register_override(ctx.id, tbl);
+            });
         });
     };
     desc.on_mod_unloaded = [](ModContext& ctx) {
         demo_content_internal::remove_override(ctx.id);
     };
+    desc.save_mod_state = [](ModContext&, ModStateWriter& w) {
+        demo_content_internal::save_session(w);
+    };
+    desc.load_mod_state = [](ModContext&, ModStateReader& r) {
+        demo_content_internal::load_session(r);
+    };
     registry.register_api(std::move(desc));
 }
 
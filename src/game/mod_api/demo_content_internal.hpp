@@ -3,10 +3,15 @@
 #include <string>
 #include <sol/sol.hpp>
 
+struct ModStateReader;
+struct ModStateWriter;
+
 namespace demo_content_internal {
 
 void register_override(const std::string& mod_id, const sol::table& tbl);
 void remove_override(const std::string& mod_id);
 void apply_overrides();
+void save_session(ModStateWriter& w);
+void load_session(ModStateReader& r);
 
 } // namespace demo_content_internal
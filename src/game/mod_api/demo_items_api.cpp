@@ -1,7 +1,9 @@
 #include "game/mod_api/demo_items_api.hpp"
 
 #include "engine/mod_api_registry.hpp"
+#include "engine/mod_events.hpp"
 #include "engine/mod_host.hpp"
+#include "engine/mod_state.hpp"
 #include "game/mod_api/demo_items_internal.hpp"
 
 #include <sol/sol.hpp>
@@ -10,18 +12,25 @@ void register_demo_items_api(ModApiRegistry& registry) {
     ModApiDescriptor desc;
     desc.name = "demo_items";
     desc.bind_lua = [](sol::state& lua, ModContext& ctx) {
-        demo_items_internal::expose_runtime_api(lua);
+        demo_items_internal::expose_runtime_api(lua, ctx);
         lua.set_function("register_item", [&ctx](const sol::table& def) {
-            demo_items_internal::register_item(ctx.id, def);
+            run_mod_command(ctx, [&ctx, def] { demo_items_internal::register_item(ctx.id, def); });
         });
         lua.set_function("patch_item", [&ctx](const sol::table& patch) {
-            demo_items_internal::patch_item(ctx.id, patch);
+            run_mod_command(ctx, [&ctx, patch] { demo_items_internal::patch_item(ctx.id, patch); });
         });
     };
     desc.on_mod_unloaded = [](ModContext& ctx) {
         demo_items_internal::remove_mod_items(ctx.id);
     };
+    desc.save_mod_state = [](ModContext& ctx, ModStateWriter& w) {
+        demo_items_internal::save_mod_items(ctx.id, w);
+    };
+    desc.load_mod_state = [](ModContext&, ModStateReader& r) {
+        demo_items_internal::load_mod_items(r);
+    };
     registry.register_api(std::move(desc));
+    add_mod_event_sink(demo_items_internal::run_item_use_events);
 }
 
 void finalize_demo_items_from_mods() {
@@ -3,13 +3,21 @@
 #include <string>
 #include <sol/sol.hpp>
 
+struct ModContext;
+struct ModEventQueue;
+struct ModStateReader;
+struct ModStateWriter;
+
 namespace demo_items_internal {
 
-void expose_runtime_api(sol::state& lua);
+void expose_runtime_api(sol::state& lua, ModContext& ctx);
 void register_item(const std::string& mod_id, const sol::table& def);
 bool patch_item(const std::string& mod_id, const sol::table& patch);
 void remove_mod_items(const std::string& mod_id);
 void finalize_items();
 bool has_active_items();
+void run_item_use_events(const ModEventQueue& events);
+void save_mod_items(const std::string& mod_id, ModStateWriter& w);
+void load_mod_items(ModStateReader& r);
 
 } // namespace demo_items_internal
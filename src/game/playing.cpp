@@ -1,11 +1,15 @@
 #include "game/playing.hpp"
 
 #include "engine/audio.hpp"
+#include "engine/collision.hpp"
 #include "engine/globals.hpp"
 #include "engine/input_queries.hpp"
 #include "engine/input_binding_utils.hpp"
+#include "engine/lua_views.hpp"
+#include "engine/mod_events.hpp"
 #include "engine/render.hpp"
 #include "engine/graphics.hpp"
+#include "engine/spatial_grid.hpp"
 #include "engine/ui_layouts.hpp"
 #include "game/actions.hpp"
 #include "settings.hpp"
@@ -14,8 +18,10 @@
 #include "game/ui_layout_ids.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <string>
+#include <vector>
 #include <engine/alerts.hpp>
 #include <game/settings.hpp>
 #include <game/demo_items.hpp>
@@ -23,12 +29,39 @@
 #include <engine/render.hpp>
 
 
-bool overlaps(const glm::vec2& a_pos, const glm::vec2& a_half,
-              const glm::vec2& b_pos, const glm::vec2& b_half) {
-    glm::vec2 delta = glm::abs(a_pos - b_pos);
-    return delta.x <= (a_half.x + b_half.x) && delta.y <= (a_half.y + b_half.y);
+namespace {
+
+// Per player, the sorted handles of items touched last step, so a Collision
+// event fires once on contact rather than every step. Handles carry the slot
+// version, so a pad respawned into the same slot counts as a new contact.
+std::vector<std::vector<LuaHandle>> g_item_contacts;
+std::vector<LuaHandle> g_touching;
+// Items near player 0 this frame, for highlighting.
+std::vector<VID> g_nearby_items;
+
+void push_item_collisions(int player_index, const glm::vec2& pos, float radius) {
+    auto& previous = g_item_contacts[static_cast<std::size_t>(player_index)];
+    g_touching.clear();
+    demo_item_grid().query_radius(pos, radius, [&](VID vid, glm::vec2 item_pos, float) {
+        LuaHandle handle = lua_handle_from_vid(vid);
+        g_touching.push_back(handle);
+        if (!std::binary_search(previous.begin(), previous.end(), handle))
+            push_mod_event(ModEventType::Collision, player_index, handle, item_pos);
+    });
+    std::sort(g_touching.begin(), g_touching.end());
+    previous.swap(g_touching);
 }
 
+bool is_nearby(VID vid) {
+    for (const VID& near : g_nearby_items) {
+        if (near.id == vid.id && near.version == vid.version)
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
 
 
 void playing_step() {
@@ -60,6 +93,8 @@ void playing_step() {
         ss->reticle_pos_mouse = glm::vec2(0.0f);
     }
 
+    g_item_contacts.resize(ss->players.size());
+
     // Update each player
     for (std::size_t i = 0; i < ss->players.size(); ++i) {
         auto& player = ss->players[i];
@@ -86,40 +121,46 @@ void playing_step() {
 
         // Handle player-specific interactions
         if (target.enabled &&
-            overlaps(player.pos, player.half_size, target.pos, target.half_size) &&
+            aabb_overlaps(player.pos, player.half_size, target.pos, target.half_size) &&
             target.cooldown <= 0.0f) {
             target.cooldown = BONK_COOLDOWN_SECONDS;
             add_alert("bonk!");
             const std::string sound = target.sound_key.empty() ? "base:ui_confirm" : target.sound_key;
             play_sound(sound);
+            push_mod_event(ModEventType::Bonk, player_index, 0, target.pos);
         }
 
+        const float player_radius = glm::length(player.half_size);
+        push_item_collisions(player_index, player.pos, player_radius);
+
         const bool use_pressed = was_pressed(player_index, GameAction::USE);
         if (use_pressed) {
             std::printf("[playing] player %d pressed USE\n", player_index);
-            const float player_radius = glm::length(player.half_size);
-            bool triggered = false;
-            for (const auto& slot : demo_item_instance_slots()) {
-                if (!slot.active)
-                    continue;
-                const DemoItemInstance& inst = slot.value;
-                const DemoItemDef* def = demo_item_def(inst);
+            // Only pads in reach come back from the grid; the closest one is used.
+            const DemoItemPool::Entry* used = nullptr;
+            float used_dist = 0.0f;
+            demo_item_grid().query_radius(player.pos, player_radius, [&](VID vid, glm::vec2 item_pos, float item_radius) {
+                const auto* slot = demo_item_instances().find_entry(vid);
+                const DemoItemDef* def = slot ? demo_item_def(slot->value) : nullptr;
                 if (!def)
-                    continue;
-                float dist = glm::length(player.pos - inst.position);
+                    return;
+                float dist = glm::length(player.pos - item_pos);
                 std::printf("[playing]   candidate '%s' dist=%.2f radius=%.2f\n",
                             def->id.c_str(), static_cast<double>(dist),
-                            static_cast<double>(player_radius + def->radius));
-                if (dist <= (player_radius + def->radius)) {
-                    std::printf("[playing] player %d triggering '%s' (dist=%.2f)\n",
-                                player_index, def->id.c_str(),
-                                static_cast<double>(dist));
-                    trigger_demo_item_use(inst);
-                    triggered = true;
-                    break; // One player uses it, break for this player
+                            static_cast<double>(player_radius + item_radius));
+                if (!used || dist < used_dist) {
+                    used = slot;
+                    used_dist = dist;
                 }
-            }
-            if (!triggered) {
+            });
+            if (used) {
+                std::printf("[playing] player %d triggering '%s' (dist=%.2f)\n",
+                            player_index, demo_item_def(used->value)->id.c_str(),
+                            static_cast<double>(used_dist));
+                // on_use runs when the frame's events are dispatched.
+                push_mod_event(ModEventType::ItemUsed, player_index, lua_handle_from_vid(used->vid),
+                               used->value.position);
+            } else {
                 std::printf("[playing] player %d USE ignored (no pads in range)\n",
                             player_index);
             }
@@ -203,17 +244,17 @@ void playing_draw() {
     if (!ss->players.empty()) {
         const auto& player = ss->players[0];
         const float player_radius = glm::length(player.half_size);
-        for (const auto& slot : demo_item_instance_slots()) {
-            if (!slot.active)
-                continue;
+        g_nearby_items.clear();
+        demo_item_grid().query_radius(player.pos, player_radius + 0.1f,
+                                      [](VID vid, glm::vec2, float) { g_nearby_items.push_back(vid); });
+        for (const auto& slot : demo_item_instances().active()) {
             const DemoItemInstance& inst = slot.value;
             const DemoItemDef* item = demo_item_def(inst);
             if (!item)
                 continue;
             SDL_FRect item_rect = rect_for(inst.position,
                                            glm::vec2(item->radius, item->radius), space);
-            float dist = glm::length(player.pos - inst.position);
-            bool nearby = dist <= (player_radius + item->radius + 0.1f);
+            bool nearby = is_nearby(slot.vid);
             bool drew_sprite = false;
             if (item->sprite_id >= 0) {
                 if (SDL_Texture* tex = get_texture(item->sprite_id)) {
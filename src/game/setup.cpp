@@ -4,8 +4,10 @@
 #include "engine/mod_host.hpp"
 #include "engine/render.hpp"
 #include "engine/graphics.hpp"
-#include "engine/mod_install.hpp"
+#include "engine/mod_catalog.hpp"
+#include "engine/mod_jobs.hpp"
 #include "engine/mods.hpp"
+#include "game/demo_items.hpp"
 #include "game/modes.hpp"
 #include "game/mod_api/register_game_mod_apis.hpp"
 
@@ -16,7 +18,6 @@
 
 namespace {
 
-constexpr const char* kModServerUrl = "http://127.0.0.1:8787";
 const std::vector<std::string> kDemoModChain = {
     "base",
     "patch_core",
@@ -28,7 +29,8 @@ const std::vector<std::string> kDemoModChain = {
 
 enum class SetupState {
     Idle,
-    Running,
+    FetchingCatalog,
+    Installing,
     Failed,
     Ready
 };
@@ -36,6 +38,8 @@ enum class SetupState {
 SetupState g_state = SetupState::Idle;
 std::string g_status = "Preparing mods...";
 std::string g_error;
+std::uint64_t g_job_cursor = 0;
+std::vector<std::uint64_t> g_job_ids;
 
 std::filesystem::path mods_root_dir() {
     if (mm && !mm->root.empty())
@@ -55,12 +59,9 @@ bool clear_mod_cache(std::string& err) {
     return true;
 }
 
-bool ensure_demo_mods_installed(std::string& err) {
-    std::vector<ModCatalogEntry> catalog;
-    g_status = "Fetching mod catalog...";
-    if (!fetch_mod_catalog(kModServerUrl, catalog, err))
-        return false;
-
+// Queues installs for the missing part of the demo chain. The job worker runs
+// them in order, so dependencies land before the mods that need them.
+bool queue_demo_mod_installs(const std::vector<ModCatalogEntry>& catalog, std::string& err) {
     auto find_entry = [&](const std::string& id) -> const ModCatalogEntry* {
         for (const auto& entry : catalog) {
             if (entry.id == id)
@@ -82,24 +83,65 @@ bool ensure_demo_mods_installed(std::string& err) {
         if (installed)
             continue;
 
-        g_status = "Installing " + entry->title + "...";
-        if (!install_mod_from_catalog(kModServerUrl, *entry, err))
-            return false;
+        g_job_ids.push_back(queue_mod_install(kModServerUrl, *entry));
     }
     return true;
 }
 
-bool run_setup_once() {
+bool begin_setup() {
     std::string err;
     g_status = "Clearing local mod cache...";
     if (!clear_mod_cache(err)) {
         g_error = err;
         return false;
     }
-    if (!ensure_demo_mods_installed(err)) {
+    g_status = "Fetching mod catalog...";
+    request_mod_catalog_refresh();
+    return true;
+}
+
+// Installs need the live catalog, so a cached snapshot alone is not enough:
+// wait for the background refresh to reach the server.
+bool start_demo_installs() {
+    ModCatalogStatus status = mod_catalog_status();
+    if (!status.fresh) {
+        g_error = status.error.empty() ? "Failed to fetch catalog" : status.error;
+        return false;
+    }
+    std::vector<ModCatalogEntry> catalog;
+    std::uint64_t revision = 0;
+    poll_mod_catalog(revision, catalog);
+    g_job_cursor = mod_job_events_head();
+    g_job_ids.clear();
+    std::string err;
+    if (!queue_demo_mod_installs(catalog, err)) {
         g_error = err;
         return false;
     }
+    return true;
+}
+
+// Mirrors progress events into the status line. Failures come from each
+// job's outcome, since a lagging cursor can skip ring entries.
+bool watch_demo_installs() {
+    ModJobEvent ev;
+    while (next_mod_job_event(g_job_cursor, ev)) {
+        if (ev.stage != ModJobStage::Downloading)
+            continue;
+        g_status = "Installing " + ev.mod_id + "...";
+        if (ev.bytes_total > 0)
+            g_status += " " + std::to_string(std::min<std::uint64_t>(100, ev.bytes_done * 100 / ev.bytes_total)) + "%";
+    }
+    for (std::uint64_t id : g_job_ids) {
+        if (!mod_job_outcome(id, ev) || ev.stage != ModJobStage::Failed)
+            continue;
+        g_error = ev.message.empty() ? "Failed to install " + ev.mod_id : ev.message;
+        return false;
+    }
+    return true;
+}
+
+bool activate_demo_mods() {
     g_status = "Discovering mods...";
     if (!mm) {
         g_error = "Mod manager unavailable";
@@ -117,6 +159,7 @@ bool run_setup_once() {
 
 void finalize_and_enter_play() {
     finalize_game_mod_apis();
+    compact_demo_items();
     es->mode = modes::PLAYING;
 }
 
@@ -133,13 +176,22 @@ void setup_step() {
     case SetupState::Failed:
         return;
     case SetupState::Idle:
-        g_state = SetupState::Running;
-        if (run_setup_once())
-            g_state = SetupState::Ready;
-        else
+        g_state = begin_setup() ? SetupState::FetchingCatalog : SetupState::Failed;
+        return;
+    case SetupState::FetchingCatalog:
+        if (mod_catalog_status().refreshing)
+            return;
+        g_state = start_demo_installs() ? SetupState::Installing : SetupState::Failed;
+        return;
+    case SetupState::Installing:
+        if (!watch_demo_installs()) {
             g_state = SetupState::Failed;
+            return;
+        }
+        if (!mod_jobs_idle())
+            return;
+        g_state = activate_demo_mods() ? SetupState::Ready : SetupState::Failed;
         return;
-    case SetupState::Running:
     default:
         return;
     }
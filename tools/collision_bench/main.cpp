@@ -0,0 +1,192 @@
+#include "engine/collision.hpp"
+#include "engine/vid_soa_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <random>
+#include <string>
+#include <vector>
+
+// Micro-benchmark for the batch collision kernels. For each count it fills
+// VidSoAPool columns with random boxes and circles, then times every batch
+// kernel once per instruction set the CPU supports (scalar, SSE2, AVX2),
+// plus a loop of one-off aabb_overlaps calls as the per-pair baseline.
+//
+//   collision_bench [--seed=1] [--counts=1000,65536,1000000]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+using BoxColumns = VidSoAPool<float, float, float, float>; // x, y, half_x, half_y
+using CircleSoA = VidSoAPool<float, float, float>;          // x, y, radius
+
+constexpr float kWorld = 1000.0f;
+
+// Keeps results observable so loops are not optimized away.
+volatile std::size_t g_sink = 0;
+
+double mtests_per_s(Clock::duration d, std::size_t tests) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    if (ns <= 0)
+        return 0.0;
+    return static_cast<double>(tests) / static_cast<double>(ns) * 1000.0;
+}
+
+void fill_boxes(BoxColumns& pool, std::size_t count, std::mt19937_64& rng) {
+    std::uniform_real_distribution<float> pos(0.0f, kWorld);
+    std::uniform_real_distribution<float> half(0.25f, 4.0f);
+    pool.init(count);
+    for (std::size_t i = 0; i < count; ++i)
+        pool.acquire();
+    for (std::size_t i = 0; i < count; ++i) {
+        pool.column<0>()[i] = pos(rng);
+        pool.column<1>()[i] = pos(rng);
+        pool.column<2>()[i] = half(rng);
+        pool.column<3>()[i] = half(rng);
+    }
+}
+
+void fill_circles(CircleSoA& pool, std::size_t count, std::mt19937_64& rng) {
+    std::uniform_real_distribution<float> pos(0.0f, kWorld);
+    std::uniform_real_distribution<float> radius(0.25f, 4.0f);
+    pool.init(count);
+    for (std::size_t i = 0; i < count; ++i)
+        pool.acquire();
+    for (std::size_t i = 0; i < count; ++i) {
+        pool.column<0>()[i] = pos(rng);
+        pool.column<1>()[i] = pos(rng);
+        pool.column<2>()[i] = radius(rng);
+    }
+}
+
+// Runs `kernel(query)` over the query list until about `budget` tests are done.
+template <typename Kernel>
+double time_kernel(std::size_t count, const std::vector<glm::vec2>& queries, std::size_t budget,
+                   const Kernel& kernel) {
+    std::size_t runs = std::max<std::size_t>(1, budget / count);
+    std::size_t hits = 0;
+    auto t0 = Clock::now();
+    for (std::size_t r = 0; r < runs; ++r)
+        hits += kernel(queries[r % queries.size()]);
+    auto elapsed = Clock::now() - t0;
+    g_sink = hits;
+    return mtests_per_s(elapsed, runs * count);
+}
+
+void run_count(std::size_t count, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    BoxColumns box_pool;
+    CircleSoA circle_pool;
+    fill_boxes(box_pool, count, rng);
+    fill_circles(circle_pool, count, rng);
+
+    AabbColumns boxes;
+    boxes.x = box_pool.column<0>().data();
+    boxes.y = box_pool.column<1>().data();
+    boxes.half_x = box_pool.column<2>().data();
+    boxes.half_y = box_pool.column<3>().data();
+    boxes.count = count;
+    CircleColumns circles;
+    circles.x = circle_pool.column<0>().data();
+    circles.y = circle_pool.column<1>().data();
+    circles.radius = circle_pool.column<2>().data();
+    circles.count = count;
+
+    std::uniform_real_distribution<float> pos(0.0f, kWorld);
+    std::vector<glm::vec2> queries(64);
+    for (auto& q : queries)
+        q = glm::vec2(pos(rng), pos(rng));
+
+    std::vector<std::uint64_t> mask(collision_mask_words(count));
+    std::vector<float> toi(count);
+    const std::size_t budget = 50000000;
+    const glm::vec2 half(2.0f, 2.0f);
+    const glm::vec2 delta(12.0f, -7.0f);
+    const float radius = 2.0f;
+
+    std::printf("count %zu (Mtests/s)\n", count);
+    std::printf("  %-28s", "");
+    const CollisionIsa isas[] = {CollisionIsa::Scalar, CollisionIsa::Sse2, CollisionIsa::Avx2};
+    std::vector<CollisionIsa> supported;
+    for (CollisionIsa isa : isas) {
+        set_collision_isa_limit(isa);
+        if (collision_isa() == isa) {
+            supported.push_back(isa);
+            std::printf(" %10s", collision_isa_name(isa));
+        }
+    }
+    std::printf("\n");
+
+    auto row = [&](const char* name, const auto& kernel) {
+        std::printf("  %-28s", name);
+        for (CollisionIsa isa : supported) {
+            set_collision_isa_limit(isa);
+            std::printf(" %10.1f", time_kernel(count, queries, budget, kernel));
+        }
+        std::printf("\n");
+    };
+    row("aabb_vs_aabbs", [&](glm::vec2 q) { return aabb_vs_aabbs(q, half, boxes, mask.data()); });
+    row("circle_vs_circles", [&](glm::vec2 q) { return circle_vs_circles(q, radius, circles, mask.data()); });
+    row("circle_vs_aabbs", [&](glm::vec2 q) { return circle_vs_aabbs(q, radius, boxes, mask.data()); });
+    row("sweep_aabb_vs_aabbs",
+        [&](glm::vec2 q) { return sweep_aabb_vs_aabbs(q, half, delta, boxes, toi.data(), mask.data()); });
+    row("sweep_circle_vs_circles",
+        [&](glm::vec2 q) { return sweep_circle_vs_circles(q, radius, delta, circles, toi.data(), mask.data()); });
+    set_collision_isa_limit(CollisionIsa::Avx2);
+
+    double one_off = time_kernel(count, queries, budget, [&](glm::vec2 q) {
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            glm::vec2 p(boxes.x[i], boxes.y[i]);
+            glm::vec2 h(boxes.half_x[i], boxes.half_y[i]);
+            hits += aabb_overlaps(q, half, p, h) ? 1u : 0u;
+        }
+        return hits;
+    });
+    std::printf("  %-28s %10.1f\n", "one-off aabb_overlaps calls", one_off);
+}
+
+std::vector<std::size_t> parse_counts(const std::string& list) {
+    std::vector<std::size_t> counts;
+    std::size_t start = 0;
+    while (start <= list.size()) {
+        std::size_t comma = list.find(',', start);
+        std::string part = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        if (!part.empty())
+            counts.push_back(std::max<std::size_t>(1, std::stoull(part)));
+        if (comma == std::string::npos)
+            break;
+        start = comma + 1;
+    }
+    return counts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t seed = 1;
+    std::vector<std::size_t> counts = {1000, 65536, 1000000};
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg.rfind("--seed=", 0) == 0) {
+                seed = std::stoull(arg.substr(7));
+            } else if (arg.rfind("--counts=", 0) == 0) {
+                counts = parse_counts(arg.substr(9));
+            } else {
+                std::fprintf(stderr, "usage: collision_bench [--seed=1] [--counts=1000,65536,1000000]\n");
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::fprintf(stderr, "bad argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+    for (std::size_t count : counts)
+        run_count(count, seed);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// One mutex per key, created on first use and dropped once nobody holds or
+// waits on it. Cache builders lock the key of what they are producing, so
+// two requests never build the same file twice, while requests for
+// anything else (including cache hits) never wait behind a build.
+class BuildLocks {
+    struct Slot {
+        std::mutex mutex;
+        int users{0};
+    };
+
+  public:
+    // Holds the key's mutex for its lifetime.
+    class Guard {
+      public:
+        Guard(BuildLocks& owner, std::string key) : owner_(owner), key_(std::move(key)) {
+            slot_ = owner_.acquire(key_);
+            slot_->mutex.lock();
+        }
+        ~Guard() {
+            slot_->mutex.unlock();
+            owner_.release(key_);
+        }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+      private:
+        BuildLocks& owner_;
+        std::string key_;
+        Slot* slot_{nullptr};
+    };
+
+  private:
+    Slot* acquire(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& slot = slots_[key];
+        if (!slot)
+            slot = std::make_unique<Slot>();
+        slot->users += 1;
+        return slot.get();
+    }
+
+    void release(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = slots_.find(key);
+        if (it != slots_.end() && --it->second->users == 0)
+            slots_.erase(it);
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Slot>> slots_;
+};
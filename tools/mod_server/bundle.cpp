@@ -0,0 +1,172 @@
+#include "bundle.hpp"
+#include "build_locks.hpp"
+#include "metrics.hpp"
+
+#include "engine/content_hash.hpp"
+#include "engine/mod_bundle.hpp"
+
+#include <zlib.h>
+
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+constexpr std::size_t kChunkBytes = 64 * 1024;
+
+// Keyed by mod id: one build (and prune) per mod at a time.
+BuildLocks g_bundle_builds;
+
+// Feeds bytes through deflate and appends compressed output to a file.
+struct BundleWriter {
+    std::ofstream out;
+    z_stream zs{};
+    bool ready{false};
+    char buffer[kChunkBytes];
+
+    bool open(const fs::path& path) {
+        out.open(path, std::ios::binary | std::ios::trunc);
+        if (!out.good())
+            return false;
+        ready = deflateInit(&zs, Z_DEFAULT_COMPRESSION) == Z_OK;
+        return ready;
+    }
+
+    bool pump(const char* data, std::size_t len, int flush) {
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        zs.avail_in = static_cast<uInt>(len);
+        int rc = Z_OK;
+        do {
+            zs.next_out = reinterpret_cast<Bytef*>(buffer);
+            zs.avail_out = static_cast<uInt>(sizeof(buffer));
+            rc = deflate(&zs, flush);
+            if (rc == Z_STREAM_ERROR)
+                return false;
+            out.write(buffer, static_cast<std::streamsize>(sizeof(buffer) - zs.avail_out));
+        } while (zs.avail_out == 0 || (flush == Z_FINISH && rc != Z_STREAM_END));
+        return out.good();
+    }
+
+    bool write(const std::string& bytes) { return pump(bytes.data(), bytes.size(), Z_NO_FLUSH); }
+
+    ~BundleWriter() {
+        if (ready)
+            deflateEnd(&zs);
+    }
+};
+
+bool write_bundle(const RepoMod& mod, const fs::path& dest, std::string& err) {
+    fs::path tmp = dest;
+    tmp += ".tmp";
+    std::error_code ec;
+    fs::create_directories(dest.parent_path(), ec);
+
+    bool ok = [&] {
+        BundleWriter writer;
+        if (!writer.open(tmp)) {
+            err = "failed to open " + tmp.string();
+            return false;
+        }
+        std::string header(kModBundleMagic, sizeof(kModBundleMagic));
+        bundle_put_u32(header, kModBundleVersion);
+        if (!writer.write(header))
+            return false;
+
+        char chunk[kChunkBytes];
+        for (const auto& file : mod.files) {
+            std::string entry;
+            bundle_put_u32(entry, static_cast<std::uint32_t>(file.path.size()));
+            entry += file.path;
+            bundle_put_u64(entry, file.size_bytes);
+            bundle_put_u64(entry, std::stoull(file.hash, nullptr, 16));
+            if (!writer.write(entry))
+                return false;
+
+            std::ifstream in(mod.root / file.path, std::ios::binary);
+            if (!in.good()) {
+                err = "failed to read " + file.path;
+                return false;
+            }
+            ContentHasher hasher;
+            std::uint64_t total = 0;
+            while (in) {
+                in.read(chunk, sizeof(chunk));
+                std::streamsize got = in.gcount();
+                if (got <= 0)
+                    break;
+                hasher.update(chunk, static_cast<std::size_t>(got));
+                total += static_cast<std::uint64_t>(got);
+                if (!writer.pump(chunk, static_cast<std::size_t>(got), Z_NO_FLUSH))
+                    return false;
+            }
+            if (total != file.size_bytes || content_hash_hex(hasher.digest()) != file.hash) {
+                err = file.path + " changed on disk since the last scan";
+                return false;
+            }
+        }
+        std::string tail;
+        bundle_put_u32(tail, 0);
+        if (!writer.write(tail))
+            return false;
+        return writer.pump(nullptr, 0, Z_FINISH);
+    }();
+
+    if (!ok) {
+        if (err.empty())
+            err = "failed to write " + tmp.string();
+        fs::remove(tmp, ec);
+        return false;
+    }
+    fs::rename(tmp, dest, ec);
+    if (ec) {
+        err = "failed to move bundle into place";
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+void prune_stale_bundles(const RepoMod& mod, const fs::path& keep) {
+    std::error_code ec;
+    const std::string prefix = mod.id + "-";
+    const std::size_t expected_len = prefix.size() + 16 + 4; // <hash>.gbz
+    for (auto const& entry : fs::directory_iterator(keep.parent_path(), ec)) {
+        if (ec)
+            break;
+        std::string name = entry.path().filename().string();
+        if (entry.path() == keep || name.size() != expected_len || name.rfind(prefix, 0) != 0)
+            continue;
+        std::error_code rm_ec;
+        fs::remove(entry.path(), rm_ec);
+    }
+}
+
+} // namespace
+
+fs::path bundle_cache_path(const fs::path& cache_dir, const RepoMod& mod) {
+    return cache_dir / "bundles" / (mod.id + "-" + mod.content_hash + ".gbz");
+}
+
+bool ensure_bundle(const fs::path& cache_dir, const RepoMod& mod, fs::path& out, std::string& err) {
+    out = bundle_cache_path(cache_dir, mod);
+    std::error_code ec;
+    bool cached = fs::exists(out, ec);
+    if (cached) {
+        metrics_cache_lookup(MetricsCache::Bundle, true);
+        touch_cache_file(out);
+        return true;
+    }
+    BuildLocks::Guard build(g_bundle_builds, mod.id);
+    cached = fs::exists(out, ec); // built while this request waited
+    metrics_cache_lookup(MetricsCache::Bundle, cached);
+    if (cached) {
+        touch_cache_file(out);
+        return true;
+    }
+    if (!write_bundle(mod, out, err))
+        return false;
+    prune_stale_bundles(mod, out);
+    std::cout << "[mod_server] Built bundle " << out.filename().string() << " ("
+              << fs::file_size(out, ec) << " bytes)\n";
+    return true;
+}
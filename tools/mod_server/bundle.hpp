@@ -0,0 +1,13 @@
+#pragma once
+
+#include "repo.hpp"
+
+#include <string>
+
+// Cache location for a mod's bundle: `<cache_dir>/bundles/<id>-<content_hash>.gbz`.
+// A new content hash produces a new file, so cached bundles never go stale.
+fs::path bundle_cache_path(const fs::path& cache_dir, const RepoMod& mod);
+
+// Make sure the bundle for `mod` exists on disk, building it if needed and
+// pruning bundles for older content versions of the same mod.
+bool ensure_bundle(const fs::path& cache_dir, const RepoMod& mod, fs::path& out, std::string& err);
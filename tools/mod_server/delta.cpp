@@ -0,0 +1,348 @@
+#include "delta.hpp"
+#include "build_locks.hpp"
+#include "metrics.hpp"
+
+#include "engine/content_hash.hpp"
+#include "engine/mod_delta.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kBlockBytes = 2048;
+// Literal ops are cut at this size, which also bounds how much of the
+// target is buffered while encoding.
+constexpr std::size_t kMaxLiteralBytes = 1024 * 1024;
+constexpr std::size_t kReadBytes = 64 * 1024;
+// Patches larger than this fraction of the target are not worth serving;
+// the client falls back to a full download instead.
+constexpr std::uint64_t kMaxDeltaPercent = 60;
+
+// Keyed by delta file name: one build per (base, target) pair.
+BuildLocks g_delta_builds;
+
+// rsync's weak checksum: two 16-bit sums that can be rolled one byte at a time.
+struct RollingSum {
+    std::uint32_t a{0};
+    std::uint32_t b{0};
+    std::size_t len{0};
+
+    void reset(const char* data, std::size_t n) {
+        a = 0;
+        b = 0;
+        len = n;
+        for (std::size_t i = 0; i < n; ++i) {
+            std::uint32_t c = static_cast<unsigned char>(data[i]);
+            a += c;
+            b += static_cast<std::uint32_t>(n - i) * c;
+        }
+        a &= 0xFFFF;
+        b &= 0xFFFF;
+    }
+
+    void roll(char out, char in) {
+        std::uint32_t o = static_cast<unsigned char>(out);
+        std::uint32_t i = static_cast<unsigned char>(in);
+        a = (a - o + i) & 0xFFFF;
+        b = (b - static_cast<std::uint32_t>(len) * o + a) & 0xFFFF;
+    }
+
+    std::uint32_t value() const { return a | (b << 16); }
+};
+
+// Writes delta ops straight to the output file. Copy lengths and literal
+// lengths are u32 on the wire, so long runs are split rather than truncated.
+struct DeltaEncoder {
+    std::ofstream& out;
+    std::uint64_t written{0};
+    std::uint64_t copy_offset{0};
+    std::uint32_t copy_len{0};
+
+    explicit DeltaEncoder(std::ofstream& stream) : out(stream) {}
+
+    void put(const char* data, std::size_t len) {
+        out.write(data, static_cast<std::streamsize>(len));
+        written += len;
+    }
+
+    void flush_copy() {
+        if (copy_len == 0)
+            return;
+        std::string op(1, static_cast<char>(kModDeltaOpCopy));
+        bundle_put_u64(op, copy_offset);
+        bundle_put_u32(op, copy_len);
+        put(op.data(), op.size());
+        copy_len = 0;
+    }
+
+    void copy(std::uint64_t offset, std::uint32_t len) {
+        if (copy_len > 0 && copy_offset + copy_len == offset &&
+            len <= std::numeric_limits<std::uint32_t>::max() - copy_len) {
+            copy_len += len;
+            return;
+        }
+        flush_copy();
+        copy_offset = offset;
+        copy_len = len;
+    }
+
+    void literal(const char* data, std::size_t len) {
+        while (len > 0) {
+            std::size_t n = std::min(len, kMaxLiteralBytes);
+            flush_copy();
+            std::string op(1, static_cast<char>(kModDeltaOpLiteral));
+            bundle_put_u32(op, static_cast<std::uint32_t>(n));
+            put(op.data(), op.size());
+            put(data, n);
+            data += n;
+            len -= n;
+        }
+    }
+
+    void finish() {
+        flush_copy();
+        char end = static_cast<char>(kModDeltaOpEnd);
+        put(&end, 1);
+    }
+};
+
+// Reads the target front to back, buffering only what the encoder still
+// needs: the pending literal run plus the window being matched.
+struct TargetStream {
+    std::ifstream in;
+    std::vector<char> buf;
+    std::uint64_t start{0}; // file offset of buf[0]
+    std::uint64_t total{0};
+    ContentHasher hasher;
+
+    // True once bytes up to (not including) `end` are buffered.
+    bool fill(std::uint64_t end) {
+        while (start + buf.size() < end && in) {
+            std::size_t old = buf.size();
+            buf.resize(old + kReadBytes);
+            in.read(buf.data() + old, static_cast<std::streamsize>(kReadBytes));
+            auto got = static_cast<std::size_t>(std::max<std::streamsize>(in.gcount(), 0));
+            buf.resize(old + got);
+            hasher.update(buf.data() + old, got);
+            total += got;
+        }
+        return start + buf.size() >= end;
+    }
+
+    std::uint64_t buffered_end() const { return start + buf.size(); }
+    const char* at(std::uint64_t offset) const { return buf.data() + (offset - start); }
+
+    void drop_before(std::uint64_t offset) {
+        buf.erase(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(offset - start));
+        start = offset;
+    }
+};
+
+bool read_base_block(std::ifstream& base, std::uint64_t offset, char* out) {
+    base.clear();
+    base.seekg(static_cast<std::streamoff>(offset));
+    base.read(out, static_cast<std::streamsize>(kBlockBytes));
+    return base.gcount() == static_cast<std::streamsize>(kBlockBytes);
+}
+
+// Index the base file in fixed blocks, then slide a window over the target.
+// Windows whose weak sum matches a base block (and whose bytes really match)
+// become copies; everything in between is sent as literals. Stops early,
+// returning false, once the patch outgrows `max_body` bytes.
+bool encode_delta(std::ifstream& base, std::uint64_t base_size, TargetStream& target, DeltaEncoder& enc,
+                  std::uint64_t max_body) {
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> blocks;
+    std::uint64_t block_count = base_size / kBlockBytes;
+    if (block_count > std::numeric_limits<std::uint32_t>::max())
+        block_count = 0; // beyond the index width; send literals
+    blocks.reserve(static_cast<std::size_t>(block_count));
+    RollingSum sum;
+    std::vector<char> block(kBlockBytes);
+    for (std::uint64_t i = 0; i < block_count; ++i) {
+        if (!read_base_block(base, i * kBlockBytes, block.data()))
+            return false;
+        sum.reset(block.data(), kBlockBytes);
+        blocks[sum.value()].push_back(static_cast<std::uint32_t>(i));
+    }
+
+    std::uint64_t literal_start = 0;
+    std::uint64_t pos = 0;
+    auto flush_literal = [&](std::uint64_t end) {
+        enc.literal(target.at(literal_start), static_cast<std::size_t>(end - literal_start));
+        literal_start = end;
+        target.drop_before(literal_start);
+    };
+    bool primed = false;
+    while (block_count > 0 && target.fill(pos + kBlockBytes)) {
+        if (enc.written > max_body)
+            return false;
+        if (!primed) {
+            sum.reset(target.at(pos), kBlockBytes);
+            primed = true;
+        }
+        bool matched = false;
+        auto it = blocks.find(sum.value());
+        if (it != blocks.end()) {
+            for (std::uint32_t index : it->second) {
+                std::uint64_t offset = static_cast<std::uint64_t>(index) * kBlockBytes;
+                if (!read_base_block(base, offset, block.data()) ||
+                    std::memcmp(block.data(), target.at(pos), kBlockBytes) != 0)
+                    continue;
+                flush_literal(pos);
+                enc.copy(offset, static_cast<std::uint32_t>(kBlockBytes));
+                pos += kBlockBytes;
+                literal_start = pos;
+                target.drop_before(pos);
+                primed = false;
+                matched = true;
+                break;
+            }
+        }
+        if (matched)
+            continue;
+        if (pos - literal_start >= kMaxLiteralBytes)
+            flush_literal(pos);
+        if (target.fill(pos + kBlockBytes + 1))
+            sum.roll(*target.at(pos), *target.at(pos + kBlockBytes));
+        ++pos;
+    }
+    // Whatever is left of the target goes out as literals.
+    for (;;) {
+        target.fill(literal_start + kMaxLiteralBytes);
+        std::uint64_t end = std::min<std::uint64_t>(target.buffered_end(), literal_start + kMaxLiteralBytes);
+        if (end == literal_start)
+            break;
+        flush_literal(end);
+        if (enc.written > max_body)
+            return false;
+    }
+    enc.finish();
+    return enc.written <= max_body;
+}
+
+// Builds the patch into a temporary file and renames it to `dest` only if
+// it is useful. Returns false with an empty `err` when it is not.
+bool write_delta(const fs::path& base_path,
+                 const std::string& base_hash,
+                 const RepoFile& file,
+                 const fs::path& target_path,
+                 const fs::path& dest,
+                 std::string& err) {
+    std::error_code ec;
+    std::uint64_t base_size = fs::file_size(base_path, ec);
+    std::ifstream base(base_path, std::ios::binary);
+    TargetStream target;
+    target.in.open(target_path, std::ios::binary);
+    if (ec || !base.good() || !target.in.good()) {
+        err = "failed to read delta inputs";
+        return false;
+    }
+    std::string header(kModDeltaMagic, sizeof(kModDeltaMagic));
+    bundle_put_u32(header, kModDeltaVersion);
+    bundle_put_u64(header, base_size);
+    bundle_put_u64(header, std::stoull(base_hash, nullptr, 16));
+    bundle_put_u64(header, file.size_bytes);
+    bundle_put_u64(header, std::stoull(file.hash, nullptr, 16));
+    std::uint64_t max_bytes = file.size_bytes * kMaxDeltaPercent / 100;
+    if (max_bytes <= header.size())
+        return false;
+
+    fs::create_directories(dest.parent_path(), ec);
+    fs::path tmp = dest;
+    tmp += ".tmp";
+    bool useful = false;
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        DeltaEncoder enc(out);
+        useful = encode_delta(base, base_size, target, enc, max_bytes - header.size());
+        if (useful && target.in.bad()) {
+            err = "failed to read " + target_path.string();
+            useful = false;
+        }
+        // The target is the live file, which may have changed since the scan.
+        if (useful && (target.total != file.size_bytes || content_hash_hex(target.hasher.digest()) != file.hash)) {
+            err = file.path + " changed on disk since the last scan";
+            useful = false;
+        }
+        if (useful && !out.good()) {
+            err = "failed to write " + tmp.string();
+            useful = false;
+        }
+    }
+    if (!useful) {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    fs::rename(tmp, dest, ec);
+    if (ec) {
+        err = "failed to move " + tmp.string() + " into place";
+        fs::remove(tmp, ec);
+        return false;
+    }
+    std::cout << "[mod_server] Built delta " << dest.filename().string() << " (" << fs::file_size(dest, ec)
+              << " bytes for a " << file.size_bytes << " byte file)\n";
+    return true;
+}
+
+bool is_hex_hash(const std::string& hash) {
+    if (hash.size() != 16)
+        return false;
+    for (char c : hash) {
+        bool digit = c >= '0' && c <= '9';
+        bool lower = c >= 'a' && c <= 'f';
+        if (!digit && !lower)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+fs::path delta_cache_path(const fs::path& cache_dir, const std::string& base_hash, const std::string& target_hash) {
+    return cache_dir / "deltas" / (base_hash + "-" + target_hash + ".gbd");
+}
+
+bool ensure_delta(const fs::path& cache_dir,
+                  const std::string& base_hash,
+                  const fs::path& mod_root,
+                  const RepoFile& file,
+                  fs::path& out,
+                  bool& useful,
+                  std::string& err) {
+    useful = false;
+    if (!is_hex_hash(base_hash) || !is_hex_hash(file.hash) || base_hash == file.hash ||
+        file.size_bytes < kMinDeltaFileBytes)
+        return false;
+    fs::path base_path = object_path(cache_dir, base_hash);
+    std::error_code ec;
+    if (!fs::exists(base_path, ec))
+        return false;
+
+    // Only useful patches are ever cached, so a hit can be served as is.
+    out = delta_cache_path(cache_dir, base_hash, file.hash);
+    bool cached = fs::exists(out, ec);
+    if (cached) {
+        metrics_cache_lookup(MetricsCache::Delta, true);
+        touch_cache_file(out);
+        useful = true;
+        return true;
+    }
+    BuildLocks::Guard build(g_delta_builds, out.filename().string());
+    cached = fs::exists(out, ec); // built while this request waited
+    metrics_cache_lookup(MetricsCache::Delta, cached);
+    if (cached) {
+        touch_cache_file(out);
+        useful = true;
+        return true;
+    }
+    touch_cache_file(base_path);
+    useful = write_delta(base_path, base_hash, file, mod_root / file.path, out, err);
+    return useful;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "repo.hpp"
+
+#include <string>
+
+// Cache location for a patch: `<cache_dir>/deltas/<base_hash>-<target_hash>.gbd`.
+fs::path delta_cache_path(const fs::path& cache_dir, const std::string& base_hash, const std::string& target_hash);
+
+// Make sure a delta turning the archived `base_hash` object into `file` (read
+// from `mod_root`) exists on disk. Returns false with `useful` = false when
+// there is no base object, the file is under kMinDeltaFileBytes, or the patch
+// would not be meaningfully smaller than the file; such patches are never
+// written to the cache. Cache hits never wait; builds are serialized per
+// (base, target) pair and stream both files instead of loading them.
+bool ensure_delta(const fs::path& cache_dir,
+                  const std::string& base_hash,
+                  const fs::path& mod_root,
+                  const RepoFile& file,
+                  fs::path& out,
+                  bool& useful,
+                  std::string& err);
@@ -7,268 +7,330 @@
 #pragma GCC diagnostic pop
 #endif
 
-#include <nlohmann/json.hpp>
+#include "bundle.hpp"
+#include "delta.hpp"
+#include "metrics.hpp"
+#include "repo.hpp"
+#include "transfer_limits.hpp"
 
-#include <filesystem>
+#include "engine/content_hash.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
-namespace fs = std::filesystem;
+namespace {
 
-struct RepoFile {
-    std::string path;
-    std::uint64_t size_bytes{0};
-};
+constexpr std::size_t kServeChunkBytes = 64 * 1024;
+constexpr std::uint32_t kDefaultCatalogLimit = 50;
+constexpr std::uint32_t kMaxCatalogLimit = 500;
+constexpr const char* kBusyRetryAfterSeconds = "2";
 
-struct RepoMod {
-    std::string id;
-    std::string title;
-    std::string author;
-    std::string version;
-    std::string description;
-    std::vector<std::string> dependencies;
-    std::string game_version;
-    std::vector<std::string> apis;
-    bool required{false};
-    fs::path root;
-    std::vector<RepoFile> files;
-    std::uint64_t total_bytes{0};
+struct ServerOptions {
+    fs::path root{"mod_repo"};
+    fs::path cache_dir; // empty = <temp>/gubsy_mod_server
+    std::uint64_t cache_max_mb{2048}; // 0 = unlimited
+    int port{8787};
+    std::size_t threads{CPPHTTPLIB_THREAD_POOL_COUNT};
+    std::size_t max_connections{0}; // open + queued, 0 = unlimited
+    std::size_t keep_alive_max{CPPHTTPLIB_KEEPALIVE_MAX_COUNT};
+    time_t keep_alive_timeout_s{CPPHTTPLIB_KEEPALIVE_TIMEOUT_SECOND};
+    time_t read_timeout_s{CPPHTTPLIB_READ_TIMEOUT_SECOND};
+    time_t write_timeout_s{CPPHTTPLIB_WRITE_TIMEOUT_SECOND};
+    int max_transfers{-1};            // -1 = three quarters of the workers
+    std::uint64_t client_rate_kbps{0}; // KiB/s per remote address, 0 = unlimited
+    int drain_timeout_s{30};
 };
 
-struct RepoState {
-    std::vector<RepoMod> mods;
-    fs::path root;
-    std::uint64_t version{0};
-    std::uint64_t snapshot_hash{0};
+std::atomic<bool> g_stop_requested{false};
 
-    const RepoMod* find(const std::string& id) const {
-        for (const auto& mod : mods) {
-            if (mod.id == id)
-                return &mod;
-        }
-        return nullptr;
-    }
-};
+void request_stop(int) {
+    g_stop_requested.store(true);
+}
 
-bool load_manifest(const fs::path& manifest_path, RepoMod& mod) {
-    std::ifstream f(manifest_path);
-    if (!f.good())
+// Stream a file from disk in fixed-size chunks instead of loading it whole.
+// httplib answers `Range` requests with 206 for sized content providers; the
+// ETag carries the content hash so resuming clients can tell whether their
+// partial download still matches what we serve.
+//
+// The body holds a transfer slot until httplib releases the provider; with
+// every slot taken the response is a 503 with Retry-After instead (which
+// still counts as served).
+bool serve_file(const httplib::Request& req,
+                httplib::Response& res,
+                const fs::path& path,
+                const char* content_type,
+                const std::string& etag) {
+    std::error_code ec;
+    std::uintmax_t size = fs::file_size(path, ec);
+    if (ec)
         return false;
-    try {
-        nlohmann::json j;
-        f >> j;
-        if (!j.is_object())
-            return false;
-        auto fetch_string = [&](const char* key, std::string& dst) {
-            auto it = j.find(key);
-            if (it != j.end() && it->is_string())
-                dst = it->get<std::string>();
-        };
-        fetch_string("id", mod.id);
-        fetch_string("title", mod.title);
-        fetch_string("author", mod.author);
-        fetch_string("version", mod.version);
-        fetch_string("description", mod.description);
-        if (auto it = j.find("dependencies"); it != j.end() && it->is_array()) {
-            mod.dependencies.clear();
-            for (auto& dep : *it) {
-                if (dep.is_string())
-                    mod.dependencies.push_back(dep.get<std::string>());
-            }
-        }
-        if (auto it = j.find("apis"); it != j.end() && it->is_array()) {
-            mod.apis.clear();
-            for (auto& api : *it) {
-                if (api.is_string())
-                    mod.apis.push_back(api.get<std::string>());
-            }
-        }
-        fetch_string("game_version", mod.game_version);
-        if (auto it = j.find("required"); it != j.end() && it->is_boolean())
-            mod.required = it->get<bool>();
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "[mod_server] Failed to parse " << manifest_path << ": " << e.what() << "\n";
+    auto stream = std::make_shared<std::ifstream>(path, std::ios::binary);
+    if (!stream->good())
         return false;
+    if (!try_begin_transfer()) {
+        res.status = 503;
+        res.set_header("Retry-After", kBusyRetryAfterSeconds);
+        res.set_content("busy, retry later", "text/plain");
+        return true;
     }
+    res.set_header("Accept-Ranges", "bytes");
+    if (!etag.empty())
+        res.set_header("ETag", "\"" + etag + "\"");
+    res.set_content_provider(
+        static_cast<std::size_t>(size), content_type,
+        [stream, client = req.remote_addr](std::size_t offset, std::size_t length, httplib::DataSink& sink) {
+            char buf[kServeChunkBytes];
+            stream->clear();
+            stream->seekg(static_cast<std::streamoff>(offset));
+            std::size_t want = std::min(length, sizeof(buf));
+            stream->read(buf, static_cast<std::streamsize>(want));
+            std::streamsize got = stream->gcount();
+            if (got <= 0)
+                return false;
+            pace_client_transfer(client, static_cast<std::size_t>(got));
+            return sink.write(buf, static_cast<std::size_t>(got));
+        },
+        [](bool) { end_transfer(); });
+    return true;
 }
 
-std::uint64_t hash_repo_tree(const fs::path& root) {
-    fs::path mods_dir = root / "mods";
-    std::error_code ec;
-    if (!fs::exists(mods_dir, ec) || !fs::is_directory(mods_dir, ec))
-        return 0;
-    std::uint64_t hash = 1469598103934665603ULL; // FNV offset
-    auto mix = [&](std::uint64_t value) {
-        hash ^= value;
-        hash *= 1099511628211ULL;
-    };
-    for (auto const& entry : fs::directory_iterator(mods_dir, ec)) {
-        if (ec) {
-            ec.clear();
-            continue;
-        }
-        mix(std::hash<std::string>{}(entry.path().filename().string()));
-        fs::path manifest = entry.path() / "manifest.json";
-        if (fs::exists(manifest, ec)) {
-            auto ts = fs::last_write_time(manifest, ec);
-            if (!ec)
-                mix(static_cast<std::uint64_t>(ts.time_since_epoch().count()));
-            else
-                ec.clear();
-        }
+std::uint32_t param_u32(const httplib::Request& req, const char* key, std::uint32_t fallback) {
+    if (!req.has_param(key))
+        return fallback;
+    try {
+        unsigned long value = std::stoul(req.get_param_value(key));
+        return static_cast<std::uint32_t>(std::min<unsigned long>(value, 0xFFFFFFFFul));
+    } catch (...) {
+        return fallback;
     }
-    return hash;
 }
 
-RepoState build_repo(const fs::path& root, std::uint64_t version_hint = 0) {
-    RepoState state;
-    state.root = root;
-    state.version = version_hint;
-    state.snapshot_hash = hash_repo_tree(root);
-    fs::path mods_dir = root / "mods";
-    std::error_code ec;
-    if (!fs::exists(mods_dir, ec) || !fs::is_directory(mods_dir, ec)) {
-        std::cerr << "[mod_server] Mods directory missing: " << mods_dir << "\n";
-        return state;
-    }
-    for (auto const& entry : fs::directory_iterator(mods_dir, ec)) {
-        if (ec) {
-            ec.clear();
-            continue;
+// Reads `q`, `api`, `game_version`, `sort`, `page` and `limit`. Returns
+// false for an unknown sort; `filtered` is false when no parameter was given.
+bool parse_catalog_query(const httplib::Request& req, CatalogQuery& query, bool& filtered) {
+    filtered = !req.params.empty();
+    query.text = req.get_param_value("q");
+    query.api = req.get_param_value("api");
+    query.game_version = req.get_param_value("game_version");
+    if (!parse_catalog_sort(req.get_param_value("sort"), query.sort))
+        return false;
+    bool paged = req.has_param("page") || req.has_param("limit");
+    query.page = std::max<std::uint32_t>(param_u32(req, "page", 1), 1);
+    query.limit = paged ? std::clamp<std::uint32_t>(param_u32(req, "limit", kDefaultCatalogLimit), 1, kMaxCatalogLimit)
+                        : 0;
+    return true;
+}
+
+// httplib's thread pool with an open-connection gauge around each task; one
+// task serves one keep-alive connection from accept to close. Connections
+// past `max_connections` (being served plus waiting for a worker) are
+// refused, and httplib closes the socket.
+struct CountingTaskQueue : httplib::TaskQueue {
+    httplib::ThreadPool pool;
+    std::size_t max_connections;
+    std::atomic<std::size_t> open{0};
+
+    CountingTaskQueue(std::size_t threads, std::size_t max_conns) : pool(threads), max_connections(max_conns) {}
+
+    bool enqueue(std::function<void()> fn) override {
+        if (max_connections > 0 && open.load(std::memory_order_relaxed) >= max_connections) {
+            metrics_connection_rejected();
+            return false;
         }
-        if (!entry.is_directory())
-            continue;
-        RepoMod mod{};
-        mod.root = entry.path();
-        fs::path manifest = mod.root / "manifest.json";
-        if (!load_manifest(manifest, mod)) {
-            std::cerr << "[mod_server] Skipping " << entry.path() << " (missing manifest)\n";
-            continue;
+        open.fetch_add(1, std::memory_order_relaxed);
+        metrics_connection_opened();
+        bool queued = pool.enqueue([this, fn = std::move(fn)] {
+            fn();
+            metrics_connection_closed();
+            open.fetch_sub(1, std::memory_order_relaxed);
+        });
+        if (!queued) {
+            metrics_connection_closed();
+            open.fetch_sub(1, std::memory_order_relaxed);
         }
-        if (mod.id.empty())
-            mod.id = entry.path().filename().string();
-        mod.files.clear();
-        mod.total_bytes = 0;
-        for (auto const& f : fs::recursive_directory_iterator(entry.path(), ec)) {
-            if (ec) {
-                ec.clear();
-                continue;
-            }
-            if (!f.is_regular_file())
-                continue;
-            fs::path rel = fs::relative(f.path(), mod.root, ec);
-            if (ec) {
-                ec.clear();
-                continue;
-            }
-            RepoFile rf;
-            rf.path = rel.generic_string();
-            rf.size_bytes = fs::file_size(f.path(), ec);
-            if (ec) {
-                ec.clear();
-                continue;
-            }
-            mod.total_bytes += rf.size_bytes;
-            mod.files.push_back(std::move(rf));
-        }
-        state.mods.push_back(std::move(mod));
+        return queued;
     }
-    return state;
-}
 
-nlohmann::json build_catalog_json(const RepoState& state) {
-    nlohmann::json catalog;
-    catalog["mods"] = nlohmann::json::array();
-    for (auto const& mod : state.mods) {
-        nlohmann::json entry;
-        entry["id"] = mod.id;
-        entry["title"] = mod.title;
-        entry["author"] = mod.author;
-        entry["version"] = mod.version;
-        entry["description"] = mod.description;
-        entry["dependencies"] = mod.dependencies;
-        entry["required"] = mod.required;
-        entry["game_version"] = mod.game_version;
-        entry["apis"] = mod.apis;
-        entry["folder"] = mod.root.filename().string();
-        entry["size_bytes"] = mod.total_bytes;
-        nlohmann::json files = nlohmann::json::array();
-        for (auto const& file : mod.files) {
-            files.push_back({
-                {"path", file.path},
-                {"size_bytes", file.size_bytes},
-            });
-        }
-        entry["files"] = std::move(files);
-        catalog["mods"].push_back(std::move(entry));
+    void shutdown() override { pool.shutdown(); }
+    void on_idle() override { pool.on_idle(); }
+};
+
+std::uint64_t response_bytes(const httplib::Response& res) {
+    if (!res.body.empty())
+        return res.body.size();
+    try {
+        return std::stoull(res.get_header_value("Content-Length"));
+    } catch (...) {
+        return 0;
     }
-    return catalog;
 }
 
-bool is_subpath(const fs::path& base, const fs::path& target) {
-    auto norm_base = fs::weakly_canonical(base);
-    auto norm_target = fs::weakly_canonical(target);
-    auto it_base = norm_base.begin();
-    auto it_target = norm_target.begin();
-    for (; it_base != norm_base.end() && it_target != norm_target.end(); ++it_base, ++it_target) {
-        if (*it_base != *it_target)
-            return false;
+// Reads `--name=<n>` into `out`, leaving it unchanged when the value does
+// not parse.
+template <typename T>
+bool read_number_flag(const std::string& arg, const char* name, T& out) {
+    std::string prefix = std::string(name) + "=";
+    if (arg.rfind(prefix, 0) != 0)
+        return false;
+    try {
+        long long value = std::stoll(arg.substr(prefix.size()));
+        if (value >= 0)
+            out = static_cast<T>(value);
+    } catch (...) {
     }
-    return it_base == norm_base.end();
+    return true;
 }
 
-void rebuild_if_needed(RepoState& state, nlohmann::json& cached_catalog) {
-    std::uint64_t current_hash = hash_repo_tree(state.root);
-    if (current_hash == state.snapshot_hash && !state.mods.empty())
-        return;
-    state.version += 1;
-    state = build_repo(state.root, state.version);
-    cached_catalog = build_catalog_json(state);
-    std::cout << "[mod_server] Catalog rebuilt (version " << state.version << ", "
-              << state.mods.size() << " mods)\n";
+void print_usage() {
+    std::cout << "Usage: mod_server [--root <path>] [--cache-dir <path>] [--cache-max-mb=<n>] [--port=<port>]\n"
+                 "                  [--threads=<n>] [--max-connections=<n>]\n"
+                 "                  [--keep-alive-max=<n>] [--keep-alive-timeout=<s>]\n"
+                 "                  [--read-timeout=<s>] [--write-timeout=<s>]\n"
+                 "                  [--max-transfers=<n>] [--client-rate-kbps=<n>] [--drain-timeout=<s>]\n";
 }
 
+} // namespace
+
 int main(int argc, char** argv) {
-    fs::path root = "mod_repo";
-    int port = 8787;
+    ServerOptions opts;
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "--root" && i + 1 < argc) {
-            root = argv[++i];
-        } else if (arg.rfind("--port=", 0) == 0) {
-            try {
-                port = std::stoi(arg.substr(7));
-            } catch (...) {
-                port = 8787;
-            }
+            opts.root = argv[++i];
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            opts.cache_dir = argv[++i];
         } else if (arg == "--help") {
-            std::cout << "Usage: mod_server [--root <path>] [--port=<port>]\n";
+            print_usage();
             return 0;
+        } else if (!read_number_flag(arg, "--port", opts.port) &&
+                   !read_number_flag(arg, "--cache-max-mb", opts.cache_max_mb) &&
+                   !read_number_flag(arg, "--threads", opts.threads) &&
+                   !read_number_flag(arg, "--max-connections", opts.max_connections) &&
+                   !read_number_flag(arg, "--keep-alive-max", opts.keep_alive_max) &&
+                   !read_number_flag(arg, "--keep-alive-timeout", opts.keep_alive_timeout_s) &&
+                   !read_number_flag(arg, "--read-timeout", opts.read_timeout_s) &&
+                   !read_number_flag(arg, "--write-timeout", opts.write_timeout_s) &&
+                   !read_number_flag(arg, "--max-transfers", opts.max_transfers) &&
+                   !read_number_flag(arg, "--client-rate-kbps", opts.client_rate_kbps) &&
+                   !read_number_flag(arg, "--drain-timeout", opts.drain_timeout_s)) {
+            std::cerr << "[mod_server] Ignoring unknown argument " << arg << "\n";
         }
     }
+    opts.threads = std::max<std::size_t>(opts.threads, 1);
+    opts.keep_alive_max = std::max<std::size_t>(opts.keep_alive_max, 1);
+    if (opts.max_transfers < 0)
+        opts.max_transfers = std::max(1, static_cast<int>(opts.threads) * 3 / 4);
+    TransferLimits limits;
+    limits.max_transfers = opts.max_transfers;
+    limits.client_rate_bytes = opts.client_rate_kbps * 1024;
+    set_transfer_limits(limits);
+    const fs::path& root = opts.root;
+    if (opts.cache_dir.empty()) {
+        std::error_code ec;
+        opts.cache_dir = fs::temp_directory_path(ec) / "gubsy_mod_server";
+    }
+    // Generated files never go inside the served tree: scans would pick
+    // them up and they would end up next to the published mods.
+    if (is_subpath(root, opts.cache_dir)) {
+        std::cerr << "[mod_server] --cache-dir " << opts.cache_dir << " must be outside " << root << "\n";
+        return 1;
+    }
+    std::cout << "[mod_server] Caching generated files under " << opts.cache_dir << "\n";
 
-    RepoState state = build_repo(root, 1);
-    if (state.mods.empty()) {
+    const std::uint64_t cache_max_bytes = std::min<std::uint64_t>(opts.cache_max_mb, UINT64_MAX >> 20) << 20;
+    LiveRepo live_repo(root, opts.cache_dir, cache_max_bytes);
+    if (std::size_t count = live_repo.snapshot()->mods.size(); count == 0) {
         std::cerr << "[mod_server] No mods found under " << root << "/mods\n";
     } else {
-        std::cout << "[mod_server] Loaded " << state.mods.size() << " mods from " << root << "\n";
+        std::cout << "[mod_server] Loaded " << count << " mods from " << root << "\n";
     }
-    nlohmann::json catalog_json = build_catalog_json(state);
+    // Serialized catalog and its ETag, regenerated only when the repo version
+    // moves, so unchanged catalogs cost clients a 304 and no re-dump here.
+    std::mutex catalog_mutex;
+    std::string catalog_body;
+    std::string catalog_etag;
+    std::uint64_t catalog_body_version = 0;
 
     httplib::Server server;
-    server.Get("/mods/catalog", [&state, &catalog_json](const httplib::Request&, httplib::Response& res) {
-        rebuild_if_needed(state, catalog_json);
-        res.set_content(catalog_json.dump(2), "application/json");
+    server.new_task_queue = [&opts] { return new CountingTaskQueue(opts.threads, opts.max_connections); };
+    server.set_keep_alive_max_count(opts.keep_alive_max);
+    server.set_keep_alive_timeout(opts.keep_alive_timeout_s);
+    server.set_read_timeout(opts.read_timeout_s);
+    server.set_write_timeout(opts.write_timeout_s);
+    server.set_pre_routing_handler([](const httplib::Request& req, httplib::Response&) {
+        metrics_request_begin(classify_metrics_route(req.path));
+        return httplib::Server::HandlerResponse::Unhandled;
+    });
+    server.set_logger([](const httplib::Request&, const httplib::Response& res) {
+        metrics_request_end(res.status, response_bytes(res));
+    });
+    server.Get("/mods/catalog", [&](const httplib::Request& req, httplib::Response& res) {
+        CatalogQuery query;
+        bool filtered = false;
+        if (!parse_catalog_query(req, query, filtered)) {
+            res.status = 400;
+            res.set_content("unknown sort", "text/plain");
+            return;
+        }
+        std::shared_ptr<const RepoState> repo = live_repo.snapshot();
+        if (filtered) {
+            CatalogPage page = run_catalog_query(repo->index, query);
+            res.set_content(build_catalog_page_json(*repo, query, page).dump(), "application/json");
+            return;
+        }
+        std::string body;
+        std::string etag;
+        {
+            std::lock_guard<std::mutex> lock(catalog_mutex);
+            bool body_cached = !catalog_body.empty() && catalog_body_version == repo->version;
+            metrics_cache_lookup(MetricsCache::CatalogBody, body_cached);
+            if (!body_cached) {
+                catalog_body = repo->catalog.dump(2);
+                ContentHasher hasher;
+                hasher.update(catalog_body.data(), catalog_body.size());
+                catalog_etag = "\"" + content_hash_hex(hasher.digest()) + "\"";
+                catalog_body_version = repo->version;
+            }
+            body = catalog_body;
+            etag = catalog_etag;
+        }
+        res.set_header("ETag", etag);
+        if (req.get_header_value("If-None-Match") == etag) {
+            res.status = 304;
+            return;
+        }
+        res.set_content(std::move(body), "application/json");
+    });
+    server.Get(R"(/mods/listing/([^/]+))", [&](const httplib::Request& req, httplib::Response& res) {
+        std::string mod_id = req.matches[1];
+        std::shared_ptr<const RepoState> repo = live_repo.snapshot();
+        const RepoMod* mod = repo->find(mod_id);
+        if (!mod) {
+            res.status = 404;
+            res.set_content("mod not found", "text/plain");
+            return;
+        }
+        res.set_header("ETag", "\"" + mod->content_hash + "\"");
+        res.set_content(build_file_listing_json(*mod).dump(), "application/json");
     });
     server.Get("/ping", [](const httplib::Request&, httplib::Response& res) {
         res.set_content("ok", "text/plain");
     });
+    server.Get("/metrics", [](const httplib::Request&, httplib::Response& res) {
+        res.set_content(render_metrics(), "text/plain; version=0.0.4");
+    });
     server.Get(R"(/mods/files/([^/]+)/(.+))",
-               [&state, &catalog_json](const httplib::Request& req, httplib::Response& res) {
-                   rebuild_if_needed(state, catalog_json);
+               [&](const httplib::Request& req, httplib::Response& res) {
                    if (req.matches.size() < 3) {
                        res.status = 400;
                        res.set_content("bad request", "text/plain");
@@ -276,29 +338,114 @@ int main(int argc, char** argv) {
                    }
                    std::string mod_id = req.matches[1];
                    std::string rel_path = req.matches[2];
-                   const RepoMod* mod = state.find(mod_id);
-                   if (!mod) {
+                   fs::path mod_root;
+                   std::string etag;
+                   std::shared_ptr<const RepoState> repo = live_repo.snapshot();
+                   if (const RepoMod* mod = repo->find(mod_id)) {
+                       mod_root = mod->root;
+                       if (const RepoFile* file = find_file(*mod, rel_path))
+                           etag = file->hash;
+                   }
+                   if (mod_root.empty()) {
                        res.status = 404;
                        res.set_content("mod not found", "text/plain");
                        return;
                    }
-                   fs::path target = mod->root / fs::path(rel_path);
-                   if (!is_subpath(mod->root, target) || !fs::exists(target) || !fs::is_regular_file(target)) {
+                   fs::path target = mod_root / fs::path(rel_path);
+                   if (!is_subpath(mod_root, target) || !fs::exists(target) || !fs::is_regular_file(target)) {
                        res.status = 404;
                        res.set_content("file not found", "text/plain");
                        return;
                    }
-                   std::ifstream f(target, std::ios::binary);
-                   if (!f.good()) {
+                   if (!serve_file(req, res, target, "application/octet-stream", etag)) {
                        res.status = 500;
                        res.set_content("failed to read file", "text/plain");
+                   }
+               });
+    server.Get(R"(/mods/bundle/([^/]+))",
+               [&](const httplib::Request& req, httplib::Response& res) {
+                   std::string mod_id = req.matches[1];
+                   std::shared_ptr<const RepoState> repo = live_repo.snapshot();
+                   const RepoMod* mod = repo->find(mod_id);
+                   if (!mod) {
+                       res.status = 404;
+                       res.set_content("mod not found", "text/plain");
                        return;
                    }
-                   std::string buf((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
-                   res.set_content(std::move(buf), "application/octet-stream");
+                   fs::path bundle;
+                   std::string err;
+                   if (!ensure_bundle(opts.cache_dir, *mod, bundle, err) ||
+                       !serve_file(req, res, bundle, "application/x-gubsy-bundle", mod->content_hash)) {
+                       std::cerr << "[mod_server] Bundle for " << mod_id << " failed: " << err << "\n";
+                       res.status = 500;
+                       res.set_content("failed to build bundle", "text/plain");
+                   }
+               });
+    server.Get(R"(/mods/delta/([^/]+)/([0-9a-f]+)/(.+))",
+               [&](const httplib::Request& req, httplib::Response& res) {
+                   std::string mod_id = req.matches[1];
+                   std::string base_hash = req.matches[2];
+                   std::string rel_path = req.matches[3];
+                   RepoFile file;
+                   fs::path mod_root;
+                   std::shared_ptr<const RepoState> repo = live_repo.snapshot();
+                   if (const RepoMod* mod = repo->find(mod_id)) {
+                       if (const RepoFile* found = find_file(*mod, rel_path)) {
+                           file = *found;
+                           mod_root = mod->root;
+                       }
+                   }
+                   fs::path delta;
+                   bool useful = false;
+                   std::string err;
+                   if (file.path.empty() ||
+                       !ensure_delta(opts.cache_dir, base_hash, mod_root, file, delta, useful, err)) {
+                       if (!err.empty())
+                           std::cerr << "[mod_server] Delta for " << mod_id << "/" << rel_path
+                                     << " failed: " << err << "\n";
+                       res.status = 404;
+                       res.set_content("no delta", "text/plain");
+                       return;
+                   }
+                   if (!serve_file(req, res, delta, "application/x-gubsy-delta", base_hash + "-" + file.hash)) {
+                       res.status = 500;
+                       res.set_content("failed to read delta", "text/plain");
+                   }
                });
 
-    std::cout << "[mod_server] Listening on http://127.0.0.1:" << port << "\n";
-    server.listen("0.0.0.0", port);
+    // Graceful drain: SIGINT/SIGTERM closes the listening socket, requests
+    // already being served run to completion, idle keep-alive connections
+    // close, and `listen` returns once the worker pool has joined. Transfers
+    // still running after `--drain-timeout` are cut off.
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+    std::atomic<bool> drained{false};
+    std::thread drain_watch([&] {
+        while (!g_stop_requested.load() && !drained.load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (drained.load())
+            return;
+        std::cout << "[mod_server] Draining (up to " << opts.drain_timeout_s << "s)\n";
+        server.stop();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(opts.drain_timeout_s);
+        while (!drained.load()) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                std::cerr << "[mod_server] Drain timed out, exiting\n";
+                std::_Exit(1);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    });
+
+    std::cout << "[mod_server] Listening on http://127.0.0.1:" << opts.port << " with " << opts.threads
+              << " workers, " << opts.max_transfers << " transfer slots\n";
+    bool listened = server.listen("0.0.0.0", opts.port);
+    drained.store(true);
+    drain_watch.join();
+    if (!listened && !g_stop_requested.load()) {
+        std::cerr << "[mod_server] Failed to listen on port " << opts.port << "\n";
+        return 1;
+    }
+    std::cout << "[mod_server] Stopped\n";
     return 0;
 }
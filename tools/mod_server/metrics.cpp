@@ -0,0 +1,247 @@
+#include "metrics.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Counter = std::atomic<std::uint64_t>;
+
+constexpr int kStatusClassCount = 5; // 1xx .. 5xx
+constexpr int kBucketCount = static_cast<int>(kLatencyBucketsSeconds.size()) + 1; // + overflow
+
+constexpr std::array<const char*, kMetricsRouteCount> kRouteNames = {
+    "catalog", "listing", "files", "bundle", "delta", "ping", "metrics", "other"};
+constexpr std::array<const char*, kMetricsCacheCount> kCacheNames = {"catalog_body", "bundle", "delta"};
+
+// Only the owning thread writes a shard, so `bump` is a plain load/store
+// pair rather than a locked read-modify-write. Shards are cache-line aligned
+// so neighbouring threads never share a line.
+struct alignas(64) MetricsShard {
+    std::array<std::array<Counter, kStatusClassCount>, kMetricsRouteCount> requests{};
+    std::array<Counter, kMetricsRouteCount> bytes{};
+    std::array<std::array<Counter, kBucketCount>, kMetricsRouteCount> latency{}; // per bucket, not cumulative
+    std::array<Counter, kMetricsRouteCount> latency_sum_ns{};
+    std::array<std::array<Counter, 2>, kMetricsCacheCount> cache{};             // [miss, hit]
+};
+
+struct MetricsRegistry {
+    std::mutex mutex; // guards `shards` growth only
+    std::vector<std::unique_ptr<MetricsShard>> shards;
+    Counter open_connections{0};
+    Counter connections_total{0};
+    Counter connections_rejected{0};
+    Counter catalog_rebuilds{0};
+    Counter catalog_rebuild_ns_total{0};
+    Counter catalog_rebuild_ns_last{0};
+    Counter catalog_mods{0};
+};
+
+MetricsRegistry g_metrics;
+
+struct InFlight {
+    MetricsRoute route{MetricsRoute::Other};
+    Clock::time_point start{};
+    bool active{false};
+};
+
+thread_local MetricsShard* t_shard = nullptr;
+thread_local InFlight t_request;
+
+void bump(Counter& c, std::uint64_t n = 1) {
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+MetricsShard& local_shard() {
+    if (!t_shard) {
+        auto shard = std::make_unique<MetricsShard>();
+        t_shard = shard.get();
+        std::lock_guard<std::mutex> lock(g_metrics.mutex);
+        g_metrics.shards.push_back(std::move(shard));
+    }
+    return *t_shard;
+}
+
+bool starts_with(const std::string& s, const char* prefix) {
+    return s.rfind(prefix, 0) == 0;
+}
+
+double ns_to_seconds(std::uint64_t ns) {
+    return static_cast<double>(ns) / 1e9;
+}
+
+} // namespace
+
+MetricsRoute classify_metrics_route(const std::string& path) {
+    if (path == "/mods/catalog")
+        return MetricsRoute::Catalog;
+    if (starts_with(path, "/mods/listing/"))
+        return MetricsRoute::Listing;
+    if (starts_with(path, "/mods/files/"))
+        return MetricsRoute::Files;
+    if (starts_with(path, "/mods/bundle/"))
+        return MetricsRoute::Bundle;
+    if (starts_with(path, "/mods/delta/"))
+        return MetricsRoute::Delta;
+    if (path == "/ping")
+        return MetricsRoute::Ping;
+    if (path == "/metrics")
+        return MetricsRoute::Metrics;
+    return MetricsRoute::Other;
+}
+
+void metrics_request_begin(MetricsRoute route) {
+    t_request.route = route;
+    t_request.start = Clock::now();
+    t_request.active = true;
+}
+
+void metrics_request_end(int status, std::uint64_t bytes) {
+    MetricsShard& shard = local_shard();
+    // Requests httplib rejects before routing never pass through begin.
+    MetricsRoute route = t_request.active ? t_request.route : MetricsRoute::Other;
+    int r = static_cast<int>(route);
+    int status_class = status >= 100 && status < 600 ? status / 100 - 1 : kStatusClassCount - 1;
+    bump(shard.requests[static_cast<std::size_t>(r)][static_cast<std::size_t>(status_class)]);
+    bump(shard.bytes[static_cast<std::size_t>(r)], bytes);
+    if (t_request.active) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t_request.start).count();
+        std::uint64_t elapsed = static_cast<std::uint64_t>(ns > 0 ? ns : 0);
+        double seconds = ns_to_seconds(elapsed);
+        std::size_t bucket = 0;
+        while (bucket < kLatencyBucketsSeconds.size() && seconds > kLatencyBucketsSeconds[bucket])
+            ++bucket;
+        bump(shard.latency[static_cast<std::size_t>(r)][bucket]);
+        bump(shard.latency_sum_ns[static_cast<std::size_t>(r)], elapsed);
+    }
+    t_request.active = false;
+}
+
+void metrics_cache_lookup(MetricsCache cache, bool hit) {
+    bump(local_shard().cache[static_cast<std::size_t>(cache)][hit ? 1 : 0]);
+}
+
+void metrics_catalog_rebuild(std::uint64_t duration_ns, std::size_t mod_count) {
+    g_metrics.catalog_rebuilds.fetch_add(1, std::memory_order_relaxed);
+    g_metrics.catalog_rebuild_ns_total.fetch_add(duration_ns, std::memory_order_relaxed);
+    g_metrics.catalog_rebuild_ns_last.store(duration_ns, std::memory_order_relaxed);
+    g_metrics.catalog_mods.store(mod_count, std::memory_order_relaxed);
+}
+
+void metrics_connection_opened() {
+    g_metrics.open_connections.fetch_add(1, std::memory_order_relaxed);
+    g_metrics.connections_total.fetch_add(1, std::memory_order_relaxed);
+}
+
+void metrics_connection_closed() {
+    g_metrics.open_connections.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void metrics_connection_rejected() {
+    g_metrics.connections_rejected.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string render_metrics() {
+    // Merge every shard into plain totals first; only the registry lock is
+    // taken, never a lock a request thread could be waiting on.
+    std::array<std::array<std::uint64_t, kStatusClassCount>, kMetricsRouteCount> requests{};
+    std::array<std::uint64_t, kMetricsRouteCount> bytes{};
+    std::array<std::array<std::uint64_t, kBucketCount>, kMetricsRouteCount> latency{};
+    std::array<std::uint64_t, kMetricsRouteCount> latency_sum_ns{};
+    std::array<std::array<std::uint64_t, 2>, kMetricsCacheCount> cache{};
+    {
+        std::lock_guard<std::mutex> lock(g_metrics.mutex);
+        for (const auto& shard : g_metrics.shards) {
+            for (std::size_t r = 0; r < kMetricsRouteCount; ++r) {
+                for (std::size_t s = 0; s < kStatusClassCount; ++s)
+                    requests[r][s] += shard->requests[r][s].load(std::memory_order_relaxed);
+                bytes[r] += shard->bytes[r].load(std::memory_order_relaxed);
+                for (std::size_t b = 0; b < kBucketCount; ++b)
+                    latency[r][b] += shard->latency[r][b].load(std::memory_order_relaxed);
+                latency_sum_ns[r] += shard->latency_sum_ns[r].load(std::memory_order_relaxed);
+            }
+            for (std::size_t c = 0; c < kMetricsCacheCount; ++c) {
+                cache[c][0] += shard->cache[c][0].load(std::memory_order_relaxed);
+                cache[c][1] += shard->cache[c][1].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::ostringstream out;
+    out << "# HELP mod_server_requests_total Requests served, by route and status class.\n"
+        << "# TYPE mod_server_requests_total counter\n";
+    for (std::size_t r = 0; r < kMetricsRouteCount; ++r) {
+        for (std::size_t s = 0; s < kStatusClassCount; ++s) {
+            if (requests[r][s] == 0)
+                continue;
+            out << "mod_server_requests_total{route=\"" << kRouteNames[r] << "\",code=\"" << (s + 1)
+                << "xx\"} " << requests[r][s] << "\n";
+        }
+    }
+
+    out << "# HELP mod_server_response_bytes_total Response body bytes sent, by route.\n"
+        << "# TYPE mod_server_response_bytes_total counter\n";
+    for (std::size_t r = 0; r < kMetricsRouteCount; ++r)
+        out << "mod_server_response_bytes_total{route=\"" << kRouteNames[r] << "\"} " << bytes[r] << "\n";
+
+    out << "# HELP mod_server_request_duration_seconds Time from routing to the last body byte.\n"
+        << "# TYPE mod_server_request_duration_seconds histogram\n";
+    for (std::size_t r = 0; r < kMetricsRouteCount; ++r) {
+        std::uint64_t cumulative = 0;
+        for (std::size_t b = 0; b < kLatencyBucketsSeconds.size(); ++b) {
+            cumulative += latency[r][b];
+            out << "mod_server_request_duration_seconds_bucket{route=\"" << kRouteNames[r] << "\",le=\""
+                << kLatencyBucketsSeconds[b] << "\"} " << cumulative << "\n";
+        }
+        cumulative += latency[r][kBucketCount - 1];
+        out << "mod_server_request_duration_seconds_bucket{route=\"" << kRouteNames[r] << "\",le=\"+Inf\"} "
+            << cumulative << "\n";
+        out << "mod_server_request_duration_seconds_sum{route=\"" << kRouteNames[r] << "\"} "
+            << ns_to_seconds(latency_sum_ns[r]) << "\n";
+        out << "mod_server_request_duration_seconds_count{route=\"" << kRouteNames[r] << "\"} " << cumulative
+            << "\n";
+    }
+
+    out << "# HELP mod_server_cache_lookups_total Cache lookups, by cache and result.\n"
+        << "# TYPE mod_server_cache_lookups_total counter\n";
+    for (std::size_t c = 0; c < kMetricsCacheCount; ++c) {
+        out << "mod_server_cache_lookups_total{cache=\"" << kCacheNames[c] << "\",result=\"hit\"} " << cache[c][1]
+            << "\n";
+        out << "mod_server_cache_lookups_total{cache=\"" << kCacheNames[c] << "\",result=\"miss\"} "
+            << cache[c][0] << "\n";
+    }
+
+    out << "# HELP mod_server_open_connections Client connections currently being served.\n"
+        << "# TYPE mod_server_open_connections gauge\n"
+        << "mod_server_open_connections " << g_metrics.open_connections.load(std::memory_order_relaxed) << "\n"
+        << "# HELP mod_server_connections_total Client connections accepted.\n"
+        << "# TYPE mod_server_connections_total counter\n"
+        << "mod_server_connections_total " << g_metrics.connections_total.load(std::memory_order_relaxed)
+        << "\n"
+        << "# HELP mod_server_connections_rejected_total Connections refused at the --max-connections limit.\n"
+        << "# TYPE mod_server_connections_rejected_total counter\n"
+        << "mod_server_connections_rejected_total "
+        << g_metrics.connections_rejected.load(std::memory_order_relaxed) << "\n";
+
+    out << "# HELP mod_server_catalog_rebuilds_total Repository scans that rebuilt the catalog.\n"
+        << "# TYPE mod_server_catalog_rebuilds_total counter\n"
+        << "mod_server_catalog_rebuilds_total " << g_metrics.catalog_rebuilds.load(std::memory_order_relaxed)
+        << "\n"
+        << "# HELP mod_server_catalog_rebuild_seconds_total Time spent rebuilding the catalog.\n"
+        << "# TYPE mod_server_catalog_rebuild_seconds_total counter\n"
+        << "mod_server_catalog_rebuild_seconds_total "
+        << ns_to_seconds(g_metrics.catalog_rebuild_ns_total.load(std::memory_order_relaxed)) << "\n"
+        << "# HELP mod_server_catalog_last_rebuild_seconds Duration of the latest catalog rebuild.\n"
+        << "# TYPE mod_server_catalog_last_rebuild_seconds gauge\n"
+        << "mod_server_catalog_last_rebuild_seconds "
+        << ns_to_seconds(g_metrics.catalog_rebuild_ns_last.load(std::memory_order_relaxed)) << "\n"
+        << "# HELP mod_server_catalog_mods Mods in the current catalog.\n"
+        << "# TYPE mod_server_catalog_mods gauge\n"
+        << "mod_server_catalog_mods " << g_metrics.catalog_mods.load(std::memory_order_relaxed) << "\n";
+    return out.str();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Request and cache counters for `/metrics` (Prometheus text format).
+//
+// Every server thread writes to its own shard, so the hot path is a handful
+// of uncontended relaxed stores with no lock; a scrape walks all shards and
+// sums them. Counts from a request still in flight may be missing from a
+// scrape taken at the same moment, which Prometheus tolerates.
+
+enum class MetricsRoute : int {
+    Catalog,
+    Listing,
+    Files,
+    Bundle,
+    Delta,
+    Ping,
+    Metrics,
+    Other,
+    Count
+};
+
+enum class MetricsCache : int {
+    CatalogBody, // serialized unfiltered catalog reused
+    Bundle,      // bundle already built on disk
+    Delta,       // delta already built on disk
+    Count
+};
+
+inline constexpr int kMetricsRouteCount = static_cast<int>(MetricsRoute::Count);
+inline constexpr int kMetricsCacheCount = static_cast<int>(MetricsCache::Count);
+inline constexpr std::array<double, 12> kLatencyBucketsSeconds = {
+    0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 5.0};
+
+MetricsRoute classify_metrics_route(const std::string& path);
+
+// Called on the thread serving the request: begin from the pre-routing
+// handler, end from the logger once the body has been written.
+void metrics_request_begin(MetricsRoute route);
+void metrics_request_end(int status, std::uint64_t bytes);
+
+void metrics_cache_lookup(MetricsCache cache, bool hit);
+void metrics_catalog_rebuild(std::uint64_t duration_ns, std::size_t mod_count);
+void metrics_connection_opened();
+void metrics_connection_closed();
+void metrics_connection_rejected();
+
+std::string render_metrics();
@@ -0,0 +1,400 @@
+#include "repo.hpp"
+#include "metrics.hpp"
+
+#include "engine/content_hash.hpp"
+#include "engine/sha256.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+constexpr std::chrono::minutes kCacheMinAge{1};
+
+// One read pass feeds both digests: FNV for change detection and caches,
+// SHA-256 for clients that share content across mods.
+bool hash_repo_file(const fs::path& path, RepoFile& file) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f.good())
+        return false;
+    ContentHasher fnv;
+    Sha256Hasher sha;
+    char buf[64 * 1024];
+    while (f) {
+        f.read(buf, sizeof(buf));
+        std::streamsize got = f.gcount();
+        if (got > 0) {
+            fnv.update(buf, static_cast<std::size_t>(got));
+            sha.update(buf, static_cast<std::size_t>(got));
+        }
+    }
+    if (f.bad())
+        return false;
+    file.hash = content_hash_hex(fnv.digest());
+    file.sha256 = sha256_hex(sha.digest());
+    return true;
+}
+
+bool load_manifest(const fs::path& manifest_path, RepoMod& mod) {
+    std::ifstream f(manifest_path);
+    if (!f.good())
+        return false;
+    try {
+        nlohmann::json j;
+        f >> j;
+        if (!j.is_object())
+            return false;
+        auto fetch_string = [&](const char* key, std::string& dst) {
+            auto it = j.find(key);
+            if (it != j.end() && it->is_string())
+                dst = it->get<std::string>();
+        };
+        fetch_string("id", mod.id);
+        fetch_string("title", mod.title);
+        fetch_string("author", mod.author);
+        fetch_string("version", mod.version);
+        fetch_string("description", mod.description);
+        if (auto it = j.find("dependencies"); it != j.end() && it->is_array()) {
+            mod.dependencies.clear();
+            for (auto& dep : *it) {
+                if (dep.is_string())
+                    mod.dependencies.push_back(dep.get<std::string>());
+            }
+        }
+        if (auto it = j.find("apis"); it != j.end() && it->is_array()) {
+            mod.apis.clear();
+            for (auto& api : *it) {
+                if (api.is_string())
+                    mod.apis.push_back(api.get<std::string>());
+            }
+        }
+        fetch_string("game_version", mod.game_version);
+        if (auto it = j.find("required"); it != j.end() && it->is_boolean())
+            mod.required = it->get<bool>();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "[mod_server] Failed to parse " << manifest_path << ": " << e.what() << "\n";
+        return false;
+    }
+}
+
+std::uint64_t hash_repo_tree(const fs::path& root) {
+    fs::path mods_dir = root / "mods";
+    std::error_code ec;
+    if (!fs::exists(mods_dir, ec) || !fs::is_directory(mods_dir, ec))
+        return 0;
+    std::uint64_t hash = 1469598103934665603ULL; // FNV offset
+    auto mix = [&](std::uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    for (auto const& entry : fs::directory_iterator(mods_dir, ec)) {
+        if (ec) {
+            ec.clear();
+            continue;
+        }
+        mix(std::hash<std::string>{}(entry.path().filename().string()));
+        // Stat every file, not just the manifest, so asset edits that leave
+        // manifest.json untouched still publish new hashes.
+        for (auto const& f : fs::recursive_directory_iterator(entry.path(), ec)) {
+            if (ec) {
+                ec.clear();
+                continue;
+            }
+            if (!f.is_regular_file(ec))
+                continue;
+            mix(std::hash<std::string>{}(f.path().generic_string()));
+            mix(static_cast<std::uint64_t>(f.file_size(ec)));
+            auto ts = f.last_write_time(ec);
+            if (!ec)
+                mix(static_cast<std::uint64_t>(ts.time_since_epoch().count()));
+            else
+                ec.clear();
+        }
+    }
+    return hash;
+}
+
+// Keep a copy of each published file version under `objects/<hash>` so later
+// versions can be served as deltas against it. Versions still published are
+// touched on every scan, so trimming drops retired versions first.
+void archive_object(const fs::path& cache_dir, const fs::path& source, const std::string& hash) {
+    fs::path dest = object_path(cache_dir, hash);
+    std::error_code ec;
+    if (fs::exists(dest, ec)) {
+        touch_cache_file(dest);
+        return;
+    }
+    fs::create_directories(dest.parent_path(), ec);
+    fs::path tmp = dest;
+    tmp += ".tmp";
+    if (!fs::copy_file(source, tmp, fs::copy_options::overwrite_existing, ec)) {
+        std::cerr << "[mod_server] Failed to archive " << source << ": " << ec.message() << "\n";
+        return;
+    }
+    fs::rename(tmp, dest, ec);
+    if (ec)
+        fs::remove(tmp, ec);
+}
+
+// Delete least recently used cache files until the cache fits in
+// `max_bytes`. Files used within kCacheMinAge are kept even past the cap,
+// since a request may be about to serve them.
+void trim_cache(const fs::path& cache_dir, std::uint64_t max_bytes) {
+    if (max_bytes == 0)
+        return;
+    struct CacheFile {
+        fs::path path;
+        std::uint64_t size;
+        fs::file_time_type used;
+    };
+    std::vector<CacheFile> files;
+    std::uint64_t total = 0;
+    for (const char* sub : {"objects", "deltas", "bundles"}) {
+        std::error_code ec;
+        for (auto const& entry : fs::directory_iterator(cache_dir / sub, ec)) {
+            if (!entry.is_regular_file(ec) || entry.path().extension() == ".tmp")
+                continue;
+            CacheFile file{entry.path(), entry.file_size(ec), entry.last_write_time(ec)};
+            if (ec) {
+                ec.clear();
+                continue;
+            }
+            total += file.size;
+            files.push_back(std::move(file));
+        }
+    }
+    if (total <= max_bytes)
+        return;
+    std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) { return a.used < b.used; });
+    const auto cutoff = fs::file_time_type::clock::now() - kCacheMinAge;
+    std::size_t removed = 0;
+    for (const auto& file : files) {
+        if (total <= max_bytes || file.used > cutoff)
+            break;
+        std::error_code ec;
+        if (fs::remove(file.path, ec)) {
+            total -= file.size;
+            removed += 1;
+        }
+    }
+    std::cout << "[mod_server] Trimmed " << removed << " cache files; " << total << " bytes left under "
+              << cache_dir << "\n";
+}
+
+} // namespace
+
+fs::path object_path(const fs::path& cache_dir, const std::string& hash) {
+    return cache_dir / "objects" / hash;
+}
+
+void touch_cache_file(const fs::path& path) {
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+}
+
+RepoState build_repo(const fs::path& root,
+                     const fs::path& cache_dir,
+                     std::uint64_t cache_max_bytes,
+                     std::uint64_t version,
+                     FileHashCache& hashes) {
+    RepoState state;
+    state.root = root;
+    state.cache_dir = cache_dir;
+    state.cache_max_bytes = cache_max_bytes;
+    state.version = version;
+    state.snapshot_hash = hash_repo_tree(root);
+    FileHashCache seen;
+    fs::path mods_dir = root / "mods";
+    std::error_code ec;
+    if (!fs::exists(mods_dir, ec) || !fs::is_directory(mods_dir, ec)) {
+        std::cerr << "[mod_server] Mods directory missing: " << mods_dir << "\n";
+        return state;
+    }
+    for (auto const& entry : fs::directory_iterator(mods_dir, ec)) {
+        if (ec) {
+            ec.clear();
+            continue;
+        }
+        if (!entry.is_directory())
+            continue;
+        RepoMod mod{};
+        mod.root = entry.path();
+        fs::path manifest = mod.root / "manifest.json";
+        if (!load_manifest(manifest, mod)) {
+            std::cerr << "[mod_server] Skipping " << entry.path() << " (missing manifest)\n";
+            continue;
+        }
+        if (mod.id.empty())
+            mod.id = entry.path().filename().string();
+        mod.files.clear();
+        mod.total_bytes = 0;
+        for (auto const& f : fs::recursive_directory_iterator(entry.path(), ec)) {
+            if (ec) {
+                ec.clear();
+                continue;
+            }
+            if (!f.is_regular_file())
+                continue;
+            fs::path rel = fs::relative(f.path(), mod.root, ec);
+            if (ec) {
+                ec.clear();
+                continue;
+            }
+            RepoFile rf;
+            rf.path = rel.generic_string();
+            rf.size_bytes = fs::file_size(f.path(), ec);
+            if (ec) {
+                ec.clear();
+                continue;
+            }
+            std::string key = f.path().string();
+            fs::file_time_type mtime = f.last_write_time(ec);
+            bool stamped = !ec;
+            ec.clear();
+            auto known = hashes.find(key);
+            if (stamped && known != hashes.end() && known->second.size_bytes == rf.size_bytes &&
+                known->second.mtime == mtime) {
+                rf.hash = known->second.hash;
+                rf.sha256 = known->second.sha256;
+            } else if (!hash_repo_file(f.path(), rf)) {
+                std::cerr << "[mod_server] Failed to hash " << f.path() << "\n";
+                continue;
+            }
+            if (stamped)
+                seen.emplace(std::move(key), FileHashEntry{rf.size_bytes, mtime, rf.hash, rf.sha256});
+            if (rf.size_bytes >= kMinDeltaFileBytes)
+                archive_object(cache_dir, f.path(), rf.hash);
+            mod.total_bytes += rf.size_bytes;
+            mod.files.push_back(std::move(rf));
+        }
+        std::sort(mod.files.begin(), mod.files.end(),
+                  [](const RepoFile& a, const RepoFile& b) { return a.path < b.path; });
+        ContentHasher content;
+        for (const auto& file : mod.files) {
+            content.update(file.path.data(), file.path.size() + 1);
+            content.update(file.hash.data(), file.hash.size());
+        }
+        mod.content_hash = content_hash_hex(content.digest());
+        state.mods.push_back(std::move(mod));
+    }
+    state.index = build_repo_index(state.mods);
+    state.catalog = build_catalog_json(state);
+    hashes = std::move(seen);
+    trim_cache(cache_dir, cache_max_bytes);
+    return state;
+}
+
+nlohmann::json build_catalog_page_json(const RepoState& state, const CatalogQuery& query, const CatalogPage& page) {
+    nlohmann::json catalog;
+    catalog["version"] = state.version;
+    catalog["total"] = page.total;
+    if (query.limit > 0) {
+        catalog["page"] = std::max<std::uint32_t>(query.page, 1);
+        catalog["limit"] = query.limit;
+    }
+    catalog["mods"] = nlohmann::json::array();
+    for (std::uint32_t idx : page.mods) {
+        const RepoMod& mod = state.mods[idx];
+        nlohmann::json entry;
+        entry["id"] = mod.id;
+        entry["title"] = mod.title;
+        entry["author"] = mod.author;
+        entry["version"] = mod.version;
+        entry["description"] = mod.description;
+        entry["dependencies"] = mod.dependencies;
+        entry["required"] = mod.required;
+        entry["game_version"] = mod.game_version;
+        entry["apis"] = mod.apis;
+        entry["folder"] = mod.root.filename().string();
+        entry["size_bytes"] = mod.total_bytes;
+        entry["file_count"] = mod.files.size();
+        entry["content_hash"] = mod.content_hash;
+        catalog["mods"].push_back(std::move(entry));
+    }
+    return catalog;
+}
+
+nlohmann::json build_catalog_json(const RepoState& state) {
+    CatalogQuery query;
+    return build_catalog_page_json(state, query, run_catalog_query(state.index, query));
+}
+
+nlohmann::json build_file_listing_json(const RepoMod& mod) {
+    nlohmann::json listing;
+    listing["id"] = mod.id;
+    listing["content_hash"] = mod.content_hash;
+    listing["size_bytes"] = mod.total_bytes;
+    nlohmann::json files = nlohmann::json::array();
+    for (auto const& file : mod.files) {
+        files.push_back({
+            {"path", file.path},
+            {"size_bytes", file.size_bytes},
+            {"hash", file.hash},
+            {"sha256", file.sha256},
+        });
+    }
+    listing["files"] = std::move(files);
+    return listing;
+}
+
+const RepoFile* find_file(const RepoMod& mod, const std::string& path) {
+    for (const auto& file : mod.files) {
+        if (file.path == path)
+            return &file;
+    }
+    return nullptr;
+}
+
+bool is_subpath(const fs::path& base, const fs::path& target) {
+    auto norm_base = fs::weakly_canonical(base);
+    auto norm_target = fs::weakly_canonical(target);
+    auto it_base = norm_base.begin();
+    auto it_target = norm_target.begin();
+    for (; it_base != norm_base.end() && it_target != norm_target.end(); ++it_base, ++it_target) {
+        if (*it_base != *it_target)
+            return false;
+    }
+    return it_base == norm_base.end();
+}
+
+LiveRepo::LiveRepo(const fs::path& root, const fs::path& cache_dir, std::uint64_t cache_max_bytes)
+    : root_(root), cache_dir_(cache_dir), cache_max_bytes_(cache_max_bytes) {
+    auto scan_start = std::chrono::steady_clock::now();
+    state_ = std::make_shared<const RepoState>(build_repo(root_, cache_dir_, cache_max_bytes_, 1, hashes_));
+    last_scan_ = std::chrono::steady_clock::now();
+    auto scan_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(last_scan_ - scan_start);
+    metrics_catalog_rebuild(static_cast<std::uint64_t>(scan_ns.count()), state_->mods.size());
+}
+
+std::shared_ptr<const RepoState> LiveRepo::snapshot() {
+    std::unique_lock<std::mutex> scan(scan_mutex_, std::try_to_lock);
+    if (scan.owns_lock())
+        rescan_if_due();
+    return published();
+}
+
+std::shared_ptr<const RepoState> LiveRepo::published() {
+    std::lock_guard<std::mutex> lock(publish_mutex_);
+    return state_;
+}
+
+void LiveRepo::rescan_if_due() {
+    auto now = std::chrono::steady_clock::now();
+    std::shared_ptr<const RepoState> current = published();
+    if (!current->mods.empty() && now - last_scan_ < kRepoScanInterval)
+        return;
+    last_scan_ = now;
+    if (hash_repo_tree(root_) == current->snapshot_hash && !current->mods.empty())
+        return;
+    auto next = std::make_shared<const RepoState>(
+        build_repo(root_, cache_dir_, cache_max_bytes_, current->version + 1, hashes_));
+    auto rebuild_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - now);
+    metrics_catalog_rebuild(static_cast<std::uint64_t>(rebuild_ns.count()), next->mods.size());
+    std::cout << "[mod_server] Catalog rebuilt (version " << next->version << ", " << next->mods.size()
+              << " mods)\n";
+    std::lock_guard<std::mutex> lock(publish_mutex_);
+    state_ = std::move(next);
+}
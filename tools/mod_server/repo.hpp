@@ -0,0 +1,139 @@
+#pragma once
+
+#include "search.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+inline constexpr std::chrono::milliseconds kRepoScanInterval{2000};
+// Files smaller than this are always sent whole, so they are not archived
+// as delta bases.
+inline constexpr std::uint64_t kMinDeltaFileBytes = 16 * 1024;
+
+struct RepoFile {
+    std::string path;
+    std::uint64_t size_bytes{0};
+    std::string hash;
+    std::string sha256; // lets clients share blobs across mods without trusting FNV
+};
+
+struct RepoMod {
+    std::string id;
+    std::string title;
+    std::string author;
+    std::string version;
+    std::string description;
+    std::vector<std::string> dependencies;
+    std::string game_version;
+    std::vector<std::string> apis;
+    bool required{false};
+    fs::path root;
+    std::vector<RepoFile> files;
+    std::uint64_t total_bytes{0};
+    std::string content_hash; // digest over (path, hash) of every file; keys bundle caches
+};
+
+// Digests of one file from an earlier scan, reused while its size and
+// modification time are unchanged.
+struct FileHashEntry {
+    std::uint64_t size_bytes{0};
+    fs::file_time_type mtime{};
+    std::string hash;
+    std::string sha256;
+};
+
+// Keyed by the file's full path.
+using FileHashCache = std::unordered_map<std::string, FileHashEntry>;
+
+// One published snapshot of the repository. Never modified once built, so
+// requests read it without locking.
+struct RepoState {
+    std::vector<RepoMod> mods;
+    fs::path root;
+    fs::path cache_dir; // archived objects, deltas and bundles; kept outside `root`
+    std::uint64_t cache_max_bytes{0}; // 0 = unlimited
+    std::uint64_t version{0};
+    std::uint64_t snapshot_hash{0};
+    RepoIndex index;
+    nlohmann::json catalog; // build_catalog_json() of this snapshot
+
+    const RepoMod* find(const std::string& id) const {
+        for (const auto& mod : mods) {
+            if (mod.id == id)
+                return &mod;
+        }
+        return nullptr;
+    }
+};
+
+
+// Scan `<root>/mods/*/manifest.json`, hash every file of every mod, archive
+// each version large enough for deltas into the object store, then trim the
+// cache to `cache_max_bytes`. Files whose size and mtime match `hashes` keep
+// their digests instead of being re-read; on return `hashes` holds exactly
+// the files seen by this scan.
+RepoState build_repo(const fs::path& root,
+                     const fs::path& cache_dir,
+                     std::uint64_t cache_max_bytes,
+                     std::uint64_t version,
+                     FileHashCache& hashes);
+
+// Full catalog (no per-file listings), as served for an unfiltered request.
+nlohmann::json build_catalog_json(const RepoState& state);
+
+// One page of query results plus paging metadata.
+nlohmann::json build_catalog_page_json(const RepoState& state, const CatalogQuery& query, const CatalogPage& page);
+
+// Per-mod file listing served by `/mods/listing/<id>`.
+nlohmann::json build_file_listing_json(const RepoMod& mod);
+
+// The repository as currently published. Requests take a snapshot and keep
+// it for as long as they need it; a rescan builds the next RepoState on the
+// side and swaps it in, so no request ever waits on hashing.
+class LiveRepo {
+  public:
+    // Runs the first scan before returning.
+    LiveRepo(const fs::path& root, const fs::path& cache_dir, std::uint64_t cache_max_bytes);
+
+    // The current snapshot. At most once per kRepoScanInterval one caller
+    // stats the tree and, if it changed, rebuilds before returning; callers
+    // arriving meanwhile get the previous snapshot.
+    std::shared_ptr<const RepoState> snapshot();
+
+  private:
+    std::shared_ptr<const RepoState> published();
+    void rescan_if_due();
+
+    fs::path root_;
+    fs::path cache_dir_;
+    std::uint64_t cache_max_bytes_{0};
+    std::mutex publish_mutex_; // guards state_
+    std::shared_ptr<const RepoState> state_;
+    std::mutex scan_mutex_; // one rescan at a time; guards the members below
+    FileHashCache hashes_;
+    std::chrono::steady_clock::time_point last_scan_{};
+};
+
+bool is_subpath(const fs::path& base, const fs::path& target);
+
+// Archived copy of a published file version: `<cache_dir>/objects/<hash>`.
+// build_repo() adds every file of at least kMinDeltaFileBytes, so older
+// versions stay available as delta bases after the repository moves on.
+fs::path object_path(const fs::path& cache_dir, const std::string& hash);
+
+// Marks a cache file as just used. The cache is trimmed least recently
+// used first, by modification time.
+void touch_cache_file(const fs::path& path);
+
+// Find a file of `mod` by its relative path; nullptr if absent.
+const RepoFile* find_file(const RepoMod& mod, const std::string& path);
@@ -0,0 +1,214 @@
+#include "search.hpp"
+
+#include "repo.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+
+namespace {
+
+// Split into lowercase alphanumeric runs; everything else separates terms.
+void tokenize(const std::string& text, std::vector<std::string>& out) {
+    std::string term;
+    for (char raw : text) {
+        unsigned char c = static_cast<unsigned char>(raw);
+        if (std::isalnum(c)) {
+            term.push_back(static_cast<char>(std::tolower(c)));
+        } else if (!term.empty()) {
+            out.push_back(std::move(term));
+            term.clear();
+        }
+    }
+    if (!term.empty())
+        out.push_back(std::move(term));
+}
+
+std::string lowercase(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+std::vector<std::uint32_t> ranks_of(const std::vector<std::uint32_t>& order) {
+    std::vector<std::uint32_t> rank(order.size());
+    for (std::size_t pos = 0; pos < order.size(); ++pos)
+        rank[order[pos]] = static_cast<std::uint32_t>(pos);
+    return rank;
+}
+
+// Keeps the ids in `ids` that also appear in `list`; both are sorted.
+// Searching on from the previous match costs O(|ids| log |list|), so the
+// caller should start from its shortest list.
+void intersect(std::vector<std::uint32_t>& ids, const std::vector<std::uint32_t>& list) {
+    auto from = list.begin();
+    std::size_t kept = 0;
+    for (std::uint32_t id : ids) {
+        from = std::lower_bound(from, list.end(), id);
+        if (from == list.end())
+            break;
+        if (*from == id)
+            ids[kept++] = id;
+    }
+    ids.resize(kept);
+}
+
+} // namespace
+
+RepoIndex build_repo_index(const std::vector<RepoMod>& mods) {
+    RepoIndex index;
+    std::map<std::string, std::vector<std::uint32_t>> terms;
+    std::vector<std::string> tokens;
+    for (std::size_t i = 0; i < mods.size(); ++i) {
+        const RepoMod& mod = mods[i];
+        auto idx = static_cast<std::uint32_t>(i);
+        tokens.clear();
+        tokenize(mod.id, tokens);
+        tokenize(mod.title, tokens);
+        tokenize(mod.author, tokens);
+        tokenize(mod.description, tokens);
+        for (const auto& token : tokens) {
+            auto& list = terms[token];
+            if (list.empty() || list.back() != idx)
+                list.push_back(idx);
+        }
+        for (const auto& api : mod.apis) {
+            auto& list = index.by_api[lowercase(api)];
+            if (list.empty() || list.back() != idx)
+                list.push_back(idx);
+        }
+        if (!mod.game_version.empty())
+            index.by_game_version[mod.game_version].push_back(idx);
+    }
+    index.terms.reserve(terms.size());
+    index.postings.reserve(terms.size());
+    for (auto& [term, list] : terms) {
+        index.terms.push_back(term);
+        index.postings.push_back(std::move(list));
+    }
+
+    std::vector<std::uint32_t> all(mods.size());
+    for (std::size_t i = 0; i < all.size(); ++i)
+        all[i] = static_cast<std::uint32_t>(i);
+    auto sorted_by = [&](auto less) {
+        std::vector<std::uint32_t> order = all;
+        std::stable_sort(order.begin(), order.end(),
+                         [&](std::uint32_t a, std::uint32_t b) { return less(mods[a], mods[b]); });
+        return order;
+    };
+    index.order_id = sorted_by([](const RepoMod& a, const RepoMod& b) { return a.id < b.id; });
+    index.order_title = sorted_by([](const RepoMod& a, const RepoMod& b) {
+        return lowercase(a.title) < lowercase(b.title);
+    });
+    index.order_author = sorted_by([](const RepoMod& a, const RepoMod& b) {
+        return lowercase(a.author) < lowercase(b.author);
+    });
+    index.order_size = sorted_by([](const RepoMod& a, const RepoMod& b) {
+        return a.total_bytes > b.total_bytes;
+    });
+    index.rank_id = ranks_of(index.order_id);
+    index.rank_title = ranks_of(index.order_title);
+    index.rank_author = ranks_of(index.order_author);
+    index.rank_size = ranks_of(index.order_size);
+    return index;
+}
+
+// Each query term and filter contributes one sorted posting list (a prefix
+// matching several terms contributes their union). The lists are intersected
+// shortest first, and only the surviving mods are put in sort order.
+CatalogPage run_catalog_query(const RepoIndex& index, const CatalogQuery& query) {
+    const std::vector<std::uint32_t>* order = &index.order_id;
+    const std::vector<std::uint32_t>* rank = &index.rank_id;
+    switch (query.sort) {
+    case CatalogSort::Title:
+        order = &index.order_title;
+        rank = &index.rank_title;
+        break;
+    case CatalogSort::Author:
+        order = &index.order_author;
+        rank = &index.rank_author;
+        break;
+    case CatalogSort::Size:
+        order = &index.order_size;
+        rank = &index.rank_size;
+        break;
+    case CatalogSort::Id:
+        break;
+    }
+
+    static const std::vector<std::uint32_t> kNoMatches;
+    std::vector<const std::vector<std::uint32_t>*> lists;
+    std::vector<std::vector<std::uint32_t>> unions; // merged prefix lists; reserved so `lists` stays valid
+
+    std::vector<std::string> tokens;
+    tokenize(query.text, tokens);
+    unions.reserve(tokens.size());
+    for (const auto& token : tokens) {
+        // Every term starting with `token` sits in one contiguous range.
+        auto first = std::lower_bound(index.terms.begin(), index.terms.end(), token);
+        auto last = first;
+        while (last != index.terms.end() && last->compare(0, token.size(), token) == 0)
+            ++last;
+        auto posting = [&](auto it) { return &index.postings[static_cast<std::size_t>(it - index.terms.begin())]; };
+        if (last - first == 0) {
+            lists.push_back(&kNoMatches);
+        } else if (last - first == 1) {
+            lists.push_back(posting(first));
+        } else {
+            std::vector<std::uint32_t> merged;
+            for (auto it = first; it != last; ++it)
+                merged.insert(merged.end(), posting(it)->begin(), posting(it)->end());
+            std::sort(merged.begin(), merged.end());
+            merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+            unions.push_back(std::move(merged));
+            lists.push_back(&unions.back());
+        }
+    }
+    if (!query.api.empty()) {
+        auto it = index.by_api.find(lowercase(query.api));
+        lists.push_back(it == index.by_api.end() ? &kNoMatches : &it->second);
+    }
+    if (!query.game_version.empty()) {
+        auto it = index.by_game_version.find(query.game_version);
+        lists.push_back(it == index.by_game_version.end() ? &kNoMatches : &it->second);
+    }
+
+    CatalogPage page;
+    const std::uint64_t skip =
+        query.limit == 0 ? 0 : static_cast<std::uint64_t>(std::max<std::uint32_t>(query.page, 1) - 1) * query.limit;
+    auto take_page = [&](const std::vector<std::uint32_t>& sorted) {
+        page.total = static_cast<std::uint32_t>(sorted.size());
+        if (skip >= sorted.size())
+            return;
+        std::size_t end = query.limit == 0 ? sorted.size()
+                                           : static_cast<std::size_t>(std::min<std::uint64_t>(sorted.size(), skip + query.limit));
+        page.mods.assign(sorted.begin() + static_cast<std::ptrdiff_t>(skip),
+                         sorted.begin() + static_cast<std::ptrdiff_t>(end));
+    };
+
+    if (lists.empty()) {
+        take_page(*order);
+        return page;
+    }
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+    std::vector<std::uint32_t> ids = *lists.front();
+    for (std::size_t i = 1; i < lists.size() && !ids.empty(); ++i)
+        intersect(ids, *lists[i]);
+    std::sort(ids.begin(), ids.end(), [&](std::uint32_t a, std::uint32_t b) { return (*rank)[a] < (*rank)[b]; });
+    take_page(ids);
+    return page;
+}
+
+bool parse_catalog_sort(const std::string& name, CatalogSort& out) {
+    if (name.empty() || name == "id")
+        out = CatalogSort::Id;
+    else if (name == "title")
+        out = CatalogSort::Title;
+    else if (name == "author")
+        out = CatalogSort::Author;
+    else if (name == "size")
+        out = CatalogSort::Size;
+    else
+        return false;
+    return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct RepoMod;
+
+enum class CatalogSort { Id, Title, Author, Size };
+
+// Built once per repository scan. Mods are referred to by their index into
+// RepoState::mods; every posting list is sorted ascending.
+struct RepoIndex {
+    std::vector<std::string> terms;                  // sorted, unique, lowercase
+    std::vector<std::vector<std::uint32_t>> postings; // parallel to `terms`
+    std::unordered_map<std::string, std::vector<std::uint32_t>> by_api;
+    std::unordered_map<std::string, std::vector<std::uint32_t>> by_game_version;
+    std::vector<std::uint32_t> order_id;
+    std::vector<std::uint32_t> order_title;
+    std::vector<std::uint32_t> order_author;
+    std::vector<std::uint32_t> order_size; // largest first
+    // Position of each mod in the order above, for sorting a filtered subset.
+    std::vector<std::uint32_t> rank_id;
+    std::vector<std::uint32_t> rank_title;
+    std::vector<std::uint32_t> rank_author;
+    std::vector<std::uint32_t> rank_size;
+};
+
+struct CatalogQuery {
+    std::string text;         // whitespace-separated terms; each matches as a prefix
+    std::string api;
+    std::string game_version;
+    CatalogSort sort{CatalogSort::Id};
+    std::uint32_t page{1};    // 1-based
+    std::uint32_t limit{0};   // 0 = no paging
+};
+
+struct CatalogPage {
+    std::vector<std::uint32_t> mods; // indices into RepoState::mods, in sort order
+    std::uint32_t total{0};          // matches before paging
+};
+
+RepoIndex build_repo_index(const std::vector<RepoMod>& mods);
+
+CatalogPage run_catalog_query(const RepoIndex& index, const CatalogQuery& query);
+
+// Parse a sort name ("id", "title", "author", "size"); false if unknown.
+bool parse_catalog_sort(const std::string& name, CatalogSort& out);
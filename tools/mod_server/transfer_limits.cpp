@@ -0,0 +1,72 @@
+#include "transfer_limits.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kPaceBurst = std::chrono::milliseconds(250);
+constexpr std::size_t kPacePruneAt = 4096; // remote addresses tracked before idle ones are dropped
+
+TransferLimits g_limits;
+std::atomic<int> g_active_transfers{0};
+
+// When each client's budget is next free. A client that went quiet has a
+// `next` in the past and gets up to one burst of credit back.
+std::mutex g_pace_mutex;
+std::unordered_map<std::string, Clock::time_point> g_pace_next;
+
+} // namespace
+
+void set_transfer_limits(const TransferLimits& limits) {
+    g_limits = limits;
+}
+
+bool try_begin_transfer() {
+    if (g_limits.max_transfers <= 0) {
+        g_active_transfers.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    int active = g_active_transfers.load(std::memory_order_relaxed);
+    while (active < g_limits.max_transfers) {
+        if (g_active_transfers.compare_exchange_weak(active, active + 1, std::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+void end_transfer() {
+    g_active_transfers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void pace_client_transfer(const std::string& client, std::size_t bytes) {
+    if (g_limits.client_rate_bytes == 0)
+        return;
+    auto cost = std::chrono::nanoseconds(static_cast<std::int64_t>(
+        static_cast<double>(bytes) * 1e9 / static_cast<double>(g_limits.client_rate_bytes)));
+    Clock::time_point now = Clock::now();
+    Clock::time_point send_at;
+    {
+        std::lock_guard<std::mutex> lock(g_pace_mutex);
+        if (g_pace_next.size() >= kPacePruneAt) {
+            for (auto it = g_pace_next.begin(); it != g_pace_next.end();) {
+                if (it->second < now - kPaceBurst)
+                    it = g_pace_next.erase(it);
+                else
+                    ++it;
+            }
+        }
+        auto [it, inserted] = g_pace_next.try_emplace(client, now - kPaceBurst);
+        if (it->second < now - kPaceBurst)
+            it->second = now - kPaceBurst;
+        send_at = it->second;
+        it->second += cost;
+    }
+    if (send_at > now)
+        std::this_thread::sleep_until(send_at);
+}
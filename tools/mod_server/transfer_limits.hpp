@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Backpressure for large bodies (files, bundles, deltas).
+//
+// Every connection holds a worker thread for as long as it is open, so a
+// storm of downloads can occupy the whole pool and leave catalog polls
+// queued behind them. Capping concurrent transfers below the worker count
+// keeps some workers free for small requests; clients over the cap get a 503
+// with Retry-After. The per-client rate limit paces each remote address so
+// one client cannot take the host's whole uplink.
+
+struct TransferLimits {
+    int max_transfers{0};              // concurrent transfer bodies, 0 = unlimited
+    std::uint64_t client_rate_bytes{0}; // per remote address, bytes/second, 0 = unlimited
+};
+
+void set_transfer_limits(const TransferLimits& limits);
+
+// Take a transfer slot; false when all slots are busy. Every successful call
+// must be matched by `end_transfer`.
+bool try_begin_transfer();
+void end_transfer();
+
+// Sleep as long as needed to keep `client` under its rate before it is sent
+// `bytes` more. Short bursts (a few hundred ms of budget) go out unpaced.
+void pace_client_transfer(const std::string& client, std::size_t bytes);
@@ -0,0 +1,501 @@
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#endif
+#include "httplib/httplib.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#include "synth_repo.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Load generator for mod_server. Each client thread keeps one keep-alive
+// connection and loops over a weighted mix of what real game clients do:
+// poll the catalog, install a whole mod, or pull a partial update. Results
+// print as a table and are written as JSON so runs before and after a server
+// change can be diffed.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum class BenchOp : int { Catalog, Install, Update, Count };
+constexpr int kBenchOpCount = static_cast<int>(BenchOp::Count);
+constexpr std::array<const char*, kBenchOpCount> kOpNames = {"catalog", "install", "update"};
+constexpr std::size_t kLatencyReserve = 1 << 16;
+
+struct BenchConfig {
+    std::string host{"127.0.0.1"};
+    int port{8787};
+    int clients{8};
+    double duration_s{10.0};
+    double warmup_s{1.0};
+    std::array<int, kBenchOpCount> mix{70, 20, 10};
+    fs::path repo;     // optional: generated repo, for its bench_updates.json
+    fs::path out_path; // optional JSON summary
+    std::uint64_t seed{1};
+};
+
+struct UpdateTarget {
+    std::string mod;
+    std::string path;
+    std::string base_hash;
+};
+
+// Written by one client thread only; merged after every thread has joined.
+struct OpStats {
+    std::uint64_t ops{0};
+    std::uint64_t errors{0};
+    std::uint64_t requests{0};
+    std::uint64_t bytes{0};
+    std::vector<std::uint32_t> latency_us;
+};
+
+struct ClientStats {
+    std::array<OpStats, kBenchOpCount> ops;
+    std::uint64_t delta_fallbacks{0};
+};
+
+struct Shared {
+    const BenchConfig* config{nullptr};
+    std::vector<std::string> mod_ids;
+    std::vector<UpdateTarget> updates;
+    std::atomic<bool> measuring{false};
+    std::atomic<bool> stop{false};
+};
+
+bool parse_mix(const std::string& spec, std::array<int, kBenchOpCount>& mix, std::string& err) {
+    std::array<int, kBenchOpCount> parsed{};
+    std::size_t at = 0;
+    while (at < spec.size()) {
+        std::size_t comma = spec.find(',', at);
+        std::string item = spec.substr(at, comma == std::string::npos ? std::string::npos : comma - at);
+        at = comma == std::string::npos ? spec.size() : comma + 1;
+        std::size_t colon = item.find(':');
+        if (colon == std::string::npos) {
+            err = "mix entries look like catalog:70";
+            return false;
+        }
+        std::string name = item.substr(0, colon);
+        auto found = std::find_if(kOpNames.begin(), kOpNames.end(), [&](const char* n) { return name == n; });
+        if (found == kOpNames.end()) {
+            err = "unknown op '" + name + "' in mix";
+            return false;
+        }
+        try {
+            parsed[static_cast<std::size_t>(found - kOpNames.begin())] = std::max(0, std::stoi(item.substr(colon + 1)));
+        } catch (...) {
+            err = "bad weight in mix entry '" + item + "'";
+            return false;
+        }
+    }
+    if (parsed[0] + parsed[1] + parsed[2] <= 0) {
+        err = "mix needs at least one positive weight";
+        return false;
+    }
+    mix = parsed;
+    return true;
+}
+
+bool parse_server(const std::string& url, BenchConfig& config) {
+    std::string rest = url;
+    if (rest.rfind("http://", 0) == 0)
+        rest = rest.substr(7);
+    while (!rest.empty() && rest.back() == '/')
+        rest.pop_back();
+    std::size_t colon = rest.rfind(':');
+    if (colon == std::string::npos) {
+        config.host = rest;
+        return !rest.empty();
+    }
+    config.host = rest.substr(0, colon);
+    try {
+        config.port = std::stoi(rest.substr(colon + 1));
+    } catch (...) {
+        return false;
+    }
+    return !config.host.empty();
+}
+
+void load_updates(const fs::path& repo, std::vector<UpdateTarget>& out) {
+    std::ifstream in(repo / "bench_updates.json");
+    if (!in)
+        return;
+    try {
+        nlohmann::json data = nlohmann::json::parse(in);
+        out.reserve(data.size());
+        for (const auto& entry : data)
+            out.push_back({entry.value("mod", ""), entry.value("path", ""), entry.value("base_hash", "")});
+    } catch (...) {
+        out.clear();
+    }
+}
+
+// Streams the body and throws it away; returns false on transport errors and
+// non-2xx/304 statuses.
+bool fetch(httplib::Client& cli, const std::string& path, const httplib::Headers& headers, OpStats& stats,
+           int* status_out = nullptr, std::string* body_out = nullptr, std::string* etag_out = nullptr) {
+    stats.requests += 1;
+    std::uint64_t received = 0;
+    auto res = cli.Get(path, headers, [&](const char* data, std::size_t len) {
+        received += len;
+        if (body_out)
+            body_out->append(data, len);
+        return true;
+    });
+    stats.bytes += received;
+    if (!res)
+        return false;
+    if (status_out)
+        *status_out = res->status;
+    if (etag_out)
+        *etag_out = res->get_header_value("ETag");
+    return (res->status >= 200 && res->status < 300) || res->status == 304;
+}
+
+bool run_catalog(httplib::Client& cli, std::string& etag, OpStats& stats) {
+    httplib::Headers headers;
+    if (!etag.empty())
+        headers.emplace("If-None-Match", etag);
+    std::string fresh;
+    if (!fetch(cli, "/mods/catalog", headers, stats, nullptr, nullptr, &fresh))
+        return false;
+    if (!fresh.empty())
+        etag = fresh;
+    return true;
+}
+
+bool fetch_listing(httplib::Client& cli, const std::string& mod_id, OpStats& stats, nlohmann::json& listing) {
+    std::string body;
+    if (!fetch(cli, "/mods/listing/" + mod_id, {}, stats, nullptr, &body))
+        return false;
+    try {
+        listing = nlohmann::json::parse(body);
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+bool run_install(httplib::Client& cli, const std::string& mod_id, OpStats& stats) {
+    nlohmann::json listing;
+    if (!fetch_listing(cli, mod_id, stats, listing))
+        return false;
+    return fetch(cli, "/mods/bundle/" + mod_id, {}, stats);
+}
+
+// A delta against the planted base when the generated repo has one,
+// otherwise (or when the server has no delta) the whole file.
+bool run_update(httplib::Client& cli, const Shared& shared, std::mt19937_64& rng, OpStats& stats,
+                std::uint64_t& delta_fallbacks) {
+    if (!shared.updates.empty()) {
+        const UpdateTarget& target = shared.updates[static_cast<std::size_t>(rng() % shared.updates.size())];
+        nlohmann::json listing;
+        if (!fetch_listing(cli, target.mod, stats, listing))
+            return false;
+        int status = 0;
+        std::string delta_path = "/mods/delta/" + target.mod + "/" + target.base_hash + "/" + target.path;
+        if (fetch(cli, delta_path, {}, stats, &status))
+            return true;
+        if (status != 404)
+            return false;
+        delta_fallbacks += 1;
+        return fetch(cli, "/mods/files/" + target.mod + "/" + target.path, {}, stats);
+    }
+    const std::string& mod_id = shared.mod_ids[static_cast<std::size_t>(rng() % shared.mod_ids.size())];
+    nlohmann::json listing;
+    if (!fetch_listing(cli, mod_id, stats, listing))
+        return false;
+    const auto& files = listing["files"];
+    if (!files.is_array() || files.empty())
+        return true;
+    // Roughly a tenth of the mod changed, at least one file.
+    std::size_t count = std::max<std::size_t>(1, files.size() / 10);
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& file = files[static_cast<std::size_t>(rng() % files.size())];
+        if (!fetch(cli, "/mods/files/" + mod_id + "/" + file.value("path", ""), {}, stats))
+            return false;
+    }
+    return true;
+}
+
+void client_loop(Shared& shared, int index, ClientStats& out) {
+    const BenchConfig& config = *shared.config;
+    httplib::Client cli(config.host, config.port);
+    cli.set_keep_alive(true);
+    cli.set_connection_timeout(5, 0);
+    cli.set_read_timeout(30, 0);
+    std::mt19937_64 rng(config.seed * 7919 + static_cast<std::uint64_t>(index));
+    int weight_total = config.mix[0] + config.mix[1] + config.mix[2];
+    std::string catalog_etag;
+    for (auto& op : out.ops)
+        op.latency_us.reserve(kLatencyReserve);
+    OpStats scratch;
+
+    while (!shared.stop.load(std::memory_order_relaxed)) {
+        int pick = static_cast<int>(rng() % static_cast<std::uint64_t>(weight_total));
+        int op = 0;
+        while (pick >= config.mix[static_cast<std::size_t>(op)]) {
+            pick -= config.mix[static_cast<std::size_t>(op)];
+            ++op;
+        }
+        bool measuring = shared.measuring.load(std::memory_order_relaxed);
+        OpStats& stats = measuring ? out.ops[static_cast<std::size_t>(op)] : scratch;
+        auto start = Clock::now();
+        bool ok = false;
+        switch (static_cast<BenchOp>(op)) {
+        case BenchOp::Catalog:
+            ok = run_catalog(cli, catalog_etag, stats);
+            break;
+        case BenchOp::Install:
+            ok = run_install(cli, shared.mod_ids[static_cast<std::size_t>(rng() % shared.mod_ids.size())], stats);
+            break;
+        case BenchOp::Update:
+            ok = run_update(cli, shared, rng, stats, out.delta_fallbacks);
+            break;
+        default:
+            break;
+        }
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        if (!measuring)
+            continue;
+        stats.ops += 1;
+        if (!ok)
+            stats.errors += 1;
+        stats.latency_us.push_back(static_cast<std::uint32_t>(std::clamp<long long>(us, 0, UINT32_MAX)));
+    }
+}
+
+double percentile_ms(std::vector<std::uint32_t>& samples, double p) {
+    if (samples.empty())
+        return 0.0;
+    std::size_t rank = static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(rank), samples.end());
+    return static_cast<double>(samples[rank]) / 1000.0;
+}
+
+bool fetch_mod_ids(const BenchConfig& config, std::vector<std::string>& out, std::string& err) {
+    httplib::Client cli(config.host, config.port);
+    cli.set_connection_timeout(5, 0);
+    auto res = cli.Get("/mods/catalog");
+    if (!res || res->status != 200) {
+        err = "catalog request to " + config.host + ":" + std::to_string(config.port) + " failed";
+        return false;
+    }
+    try {
+        nlohmann::json catalog = nlohmann::json::parse(res->body);
+        for (const auto& mod : catalog["mods"])
+            out.push_back(mod.value("id", ""));
+    } catch (...) {
+        err = "catalog is not valid JSON";
+        return false;
+    }
+    if (out.empty()) {
+        err = "server catalog is empty";
+        return false;
+    }
+    return true;
+}
+
+void print_usage() {
+    std::cout << "Usage:\n"
+                 "  mod_server_bench [--server=http://127.0.0.1:8787] [--clients=8] [--duration=10]\n"
+                 "                   [--warmup=1] [--mix=catalog:70,install:20,update:10]\n"
+                 "                   [--repo <generated repo>] [--out=<summary.json>] [--seed=1]\n"
+                 "  mod_server_bench --gen-repo <dir> [--cache-dir <server cache dir>] [--mods=100] [--files=4:32]\n"
+                 "                   [--size-dist=lognormal:16384:1.5|uniform:<min>:<max>]\n"
+                 "                   [--size-cap=16777216] [--changed=0.1] [--seed=1]\n";
+}
+
+bool parse_files_range(const std::string& spec, SynthRepoConfig& gen) {
+    try {
+        std::size_t colon = spec.find(':');
+        gen.files_min = static_cast<std::uint32_t>(std::stoul(spec.substr(0, colon)));
+        gen.files_max = colon == std::string::npos ? gen.files_min
+                                                   : static_cast<std::uint32_t>(std::stoul(spec.substr(colon + 1)));
+    } catch (...) {
+        return false;
+    }
+    return gen.files_max >= gen.files_min;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    SynthRepoConfig gen;
+    bool generate = false;
+    std::string err;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* prefix) { return arg.substr(std::string(prefix).size()); };
+        bool ok = true;
+        try {
+            if (arg.rfind("--server=", 0) == 0) {
+                ok = parse_server(value("--server="), config);
+            } else if (arg.rfind("--clients=", 0) == 0) {
+                config.clients = std::max(1, std::stoi(value("--clients=")));
+            } else if (arg.rfind("--duration=", 0) == 0) {
+                config.duration_s = std::max(0.1, std::stod(value("--duration=")));
+            } else if (arg.rfind("--warmup=", 0) == 0) {
+                config.warmup_s = std::max(0.0, std::stod(value("--warmup=")));
+            } else if (arg.rfind("--mix=", 0) == 0) {
+                ok = parse_mix(value("--mix="), config.mix, err);
+            } else if (arg == "--repo" && i + 1 < argc) {
+                config.repo = argv[++i];
+            } else if (arg.rfind("--out=", 0) == 0) {
+                config.out_path = value("--out=");
+            } else if (arg.rfind("--seed=", 0) == 0) {
+                config.seed = std::stoull(value("--seed="));
+                gen.seed = config.seed;
+            } else if (arg == "--gen-repo" && i + 1 < argc) {
+                generate = true;
+                gen.root = argv[++i];
+            } else if (arg == "--cache-dir" && i + 1 < argc) {
+                gen.cache_dir = argv[++i];
+            } else if (arg.rfind("--mods=", 0) == 0) {
+                gen.mods = static_cast<std::uint32_t>(std::stoul(value("--mods=")));
+            } else if (arg.rfind("--files=", 0) == 0) {
+                ok = parse_files_range(value("--files="), gen);
+            } else if (arg.rfind("--size-dist=", 0) == 0) {
+                ok = parse_size_distribution(value("--size-dist="), gen, err);
+            } else if (arg.rfind("--size-cap=", 0) == 0) {
+                gen.size_cap = std::max<std::uint64_t>(1, std::stoull(value("--size-cap=")));
+            } else if (arg.rfind("--changed=", 0) == 0) {
+                gen.changed_fraction = std::clamp(std::stod(value("--changed=")), 0.0, 1.0);
+            } else if (arg == "--help") {
+                print_usage();
+                return 0;
+            } else {
+                err = "unknown argument";
+                ok = false;
+            }
+        } catch (...) {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "[mod_server_bench] Bad argument " << arg << (err.empty() ? "" : ": " + err) << "\n";
+            print_usage();
+            return 1;
+        }
+    }
+
+    if (generate) {
+        if (!generate_synth_repo(gen, err)) {
+            std::cerr << "[mod_server_bench] " << err << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    Shared shared;
+    shared.config = &config;
+    if (!fetch_mod_ids(config, shared.mod_ids, err)) {
+        std::cerr << "[mod_server_bench] " << err << "\n";
+        return 1;
+    }
+    if (!config.repo.empty())
+        load_updates(config.repo, shared.updates);
+    std::cout << "[mod_server_bench] " << config.clients << " clients against " << config.host << ":" << config.port
+              << ", " << shared.mod_ids.size() << " mods, " << shared.updates.size() << " delta targets\n";
+
+    std::vector<ClientStats> per_client(static_cast<std::size_t>(config.clients));
+    std::vector<std::thread> threads;
+    threads.reserve(per_client.size());
+    for (int c = 0; c < config.clients; ++c)
+        threads.emplace_back(client_loop, std::ref(shared), c, std::ref(per_client[static_cast<std::size_t>(c)]));
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(config.warmup_s));
+    shared.measuring.store(true);
+    auto measure_start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(config.duration_s));
+    shared.measuring.store(false);
+    double elapsed = std::chrono::duration<double>(Clock::now() - measure_start).count();
+    shared.stop.store(true);
+    for (auto& t : threads)
+        t.join();
+
+    std::array<OpStats, kBenchOpCount> merged;
+    std::uint64_t delta_fallbacks = 0;
+    for (auto& client : per_client) {
+        for (std::size_t op = 0; op < merged.size(); ++op) {
+            OpStats& from = client.ops[op];
+            merged[op].ops += from.ops;
+            merged[op].errors += from.errors;
+            merged[op].requests += from.requests;
+            merged[op].bytes += from.bytes;
+            merged[op].latency_us.insert(merged[op].latency_us.end(), from.latency_us.begin(),
+                                         from.latency_us.end());
+        }
+        delta_fallbacks += client.delta_fallbacks;
+    }
+
+    nlohmann::json summary;
+    summary["server"] = config.host + ":" + std::to_string(config.port);
+    summary["clients"] = config.clients;
+    summary["duration_s"] = elapsed;
+    summary["mods"] = shared.mod_ids.size();
+    summary["mix"] = {{"catalog", config.mix[0]}, {"install", config.mix[1]}, {"update", config.mix[2]}};
+    std::uint64_t total_requests = 0;
+    std::uint64_t total_bytes = 0;
+    std::uint64_t total_errors = 0;
+    std::printf("%-8s %10s %8s %10s %10s %10s %10s\n", "op", "ops", "errors", "ops/s", "p50 ms", "p99 ms", "MB/s");
+    for (std::size_t op = 0; op < merged.size(); ++op) {
+        OpStats& stats = merged[op];
+        double p50 = percentile_ms(stats.latency_us, 0.50);
+        double p99 = percentile_ms(stats.latency_us, 0.99);
+        double mb_s = static_cast<double>(stats.bytes) / (1024.0 * 1024.0) / elapsed;
+        std::printf("%-8s %10llu %8llu %10.1f %10.2f %10.2f %10.2f\n", kOpNames[op],
+                    static_cast<unsigned long long>(stats.ops), static_cast<unsigned long long>(stats.errors),
+                    static_cast<double>(stats.ops) / elapsed, p50, p99, mb_s);
+        summary["ops"][kOpNames[op]] = {
+            {"ops", stats.ops},
+            {"errors", stats.errors},
+            {"requests", stats.requests},
+            {"bytes", stats.bytes},
+            {"ops_per_s", static_cast<double>(stats.ops) / elapsed},
+            {"p50_ms", p50},
+            {"p99_ms", p99},
+            {"mb_per_s", mb_s},
+        };
+        total_requests += stats.requests;
+        total_bytes += stats.bytes;
+        total_errors += stats.errors;
+    }
+    double requests_per_s = static_cast<double>(total_requests) / elapsed;
+    double total_mb_s = static_cast<double>(total_bytes) / (1024.0 * 1024.0) / elapsed;
+    std::printf("http requests/s %.1f, throughput %.2f MB/s, errors %llu, delta fallbacks %llu\n", requests_per_s,
+                total_mb_s, static_cast<unsigned long long>(total_errors),
+                static_cast<unsigned long long>(delta_fallbacks));
+    summary["requests"] = total_requests;
+    summary["requests_per_s"] = requests_per_s;
+    summary["bytes"] = total_bytes;
+    summary["mb_per_s"] = total_mb_s;
+    summary["errors"] = total_errors;
+    summary["delta_fallbacks"] = delta_fallbacks;
+
+    if (!config.out_path.empty()) {
+        std::ofstream out(config.out_path);
+        out << summary.dump(2) << "\n";
+        if (!out) {
+            std::cerr << "[mod_server_bench] Failed to write " << config.out_path << "\n";
+            return 1;
+        }
+        std::cout << "[mod_server_bench] Wrote " << config.out_path << "\n";
+    }
+    return total_errors == 0 ? 0 : 2;
+}
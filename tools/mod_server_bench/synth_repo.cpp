@@ -0,0 +1,160 @@
+#include "synth_repo.hpp"
+
+#include "engine/content_hash.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+// mod_server sends smaller files whole and never archives them (see
+// kMinDeltaFileBytes in tools/mod_server/repo.hpp).
+constexpr std::size_t kMinDeltaFileBytes = 16 * 1024;
+
+// Mostly-repeating bytes with some noise, so bundles compress a little like
+// real assets do instead of being incompressible random data.
+void fill_content(std::mt19937_64& rng, std::vector<char>& out, std::uint64_t size) {
+    out.resize(static_cast<std::size_t>(size));
+    std::uint64_t word = rng();
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        if ((i & 63) == 0 && (rng() & 3) == 0)
+            word = rng();
+        out[i] = static_cast<char>((word >> ((i & 7) * 8)) & 0xFF);
+    }
+}
+
+// An "older version": the same bytes with a few spans rewritten.
+void mutate_content(std::mt19937_64& rng, std::vector<char>& bytes) {
+    if (bytes.empty())
+        return;
+    int edits = 1 + static_cast<int>(rng() % 4);
+    for (int e = 0; e < edits; ++e) {
+        std::size_t at = static_cast<std::size_t>(rng() % bytes.size());
+        std::size_t len = std::min<std::size_t>(bytes.size() - at, 64 + rng() % 512);
+        for (std::size_t i = 0; i < len; ++i)
+            bytes[at + i] = static_cast<char>(rng() & 0xFF);
+    }
+}
+
+std::uint64_t sample_size(std::mt19937_64& rng, const SynthRepoConfig& config) {
+    double size = 0.0;
+    if (config.size_dist == SizeDistribution::Uniform) {
+        std::uniform_real_distribution<double> dist(config.size_a, std::max(config.size_a, config.size_b));
+        size = dist(rng);
+    } else {
+        std::lognormal_distribution<double> dist(std::log(std::max(config.size_a, 1.0)), config.size_b);
+        size = dist(rng);
+    }
+    return std::clamp<std::uint64_t>(static_cast<std::uint64_t>(size), 1, config.size_cap);
+}
+
+std::string content_hash_bytes(const std::vector<char>& bytes) {
+    ContentHasher hasher;
+    hasher.update(bytes.data(), bytes.size());
+    return content_hash_hex(hasher.digest());
+}
+
+bool write_bytes(const fs::path& path, const std::vector<char>& bytes) {
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    return out.good();
+}
+
+} // namespace
+
+bool parse_size_distribution(const std::string& spec, SynthRepoConfig& config, std::string& err) {
+    std::size_t first = spec.find(':');
+    std::size_t second = first == std::string::npos ? first : spec.find(':', first + 1);
+    if (second == std::string::npos) {
+        err = "size distribution must look like uniform:<min>:<max> or lognormal:<median>:<sigma>";
+        return false;
+    }
+    std::string kind = spec.substr(0, first);
+    try {
+        config.size_a = std::stod(spec.substr(first + 1, second - first - 1));
+        config.size_b = std::stod(spec.substr(second + 1));
+    } catch (...) {
+        err = "bad number in size distribution '" + spec + "'";
+        return false;
+    }
+    if (kind == "uniform")
+        config.size_dist = SizeDistribution::Uniform;
+    else if (kind == "lognormal")
+        config.size_dist = SizeDistribution::LogNormal;
+    else {
+        err = "unknown size distribution '" + kind + "'";
+        return false;
+    }
+    return true;
+}
+
+bool generate_synth_repo(const SynthRepoConfig& config, std::string& err) {
+    std::mt19937_64 rng(config.seed);
+    std::error_code ec;
+    fs::path cache_dir = config.cache_dir;
+    if (cache_dir.empty())
+        cache_dir = fs::temp_directory_path(ec) / "gubsy_mod_server";
+    fs::create_directories(config.root / "mods", ec);
+    if (ec) {
+        err = "failed to create " + (config.root / "mods").string();
+        return false;
+    }
+    nlohmann::json updates = nlohmann::json::array();
+    std::vector<char> bytes;
+    std::uint64_t total_bytes = 0;
+    std::uint64_t total_files = 0;
+    std::uint32_t files_span = std::max(config.files_max, config.files_min) - config.files_min + 1;
+    for (std::uint32_t m = 0; m < config.mods; ++m) {
+        char id_buf[32];
+        std::snprintf(id_buf, sizeof(id_buf), "bench_%05u", m);
+        std::string id = id_buf;
+        fs::path mod_root = config.root / "mods" / id;
+
+        nlohmann::json manifest;
+        manifest["id"] = id;
+        manifest["title"] = "Bench Mod " + std::to_string(m);
+        manifest["author"] = "mod_server_bench";
+        manifest["version"] = "1.0.0";
+        manifest["description"] = "Synthetic mod for load testing.";
+        manifest["game_version"] = "0.1.0";
+        manifest["dependencies"] = nlohmann::json::array();
+        manifest["apis"] = nlohmann::json::array();
+        fs::create_directories(mod_root, ec);
+        std::ofstream(mod_root / "manifest.json") << manifest.dump(2) << "\n";
+
+        std::uint32_t files = config.files_min + static_cast<std::uint32_t>(rng() % files_span);
+        for (std::uint32_t f = 0; f < files; ++f) {
+            std::string rel = "data/file_" + std::to_string(f) + ".bin";
+            fill_content(rng, bytes, sample_size(rng, config));
+            if (!write_bytes(mod_root / rel, bytes)) {
+                err = "failed to write " + (mod_root / rel).string();
+                return false;
+            }
+            total_bytes += bytes.size();
+            total_files += 1;
+            bool changed = std::generate_canonical<double, 32>(rng) < config.changed_fraction;
+            if (!changed || bytes.size() < kMinDeltaFileBytes)
+                continue;
+            mutate_content(rng, bytes);
+            std::string base_hash = content_hash_bytes(bytes);
+            if (!write_bytes(cache_dir / "objects" / base_hash, bytes)) {
+                err = "failed to write delta base for " + rel;
+                return false;
+            }
+            updates.push_back({{"mod", id}, {"path", rel}, {"base_hash", base_hash}});
+        }
+    }
+    std::ofstream(config.root / "bench_updates.json") << updates.dump() << "\n";
+    std::cout << "[mod_server_bench] Generated " << config.mods << " mods, " << total_files << " files, "
+              << total_bytes << " bytes, " << updates.size() << " delta bases under " << config.root << "\n";
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+
+enum class SizeDistribution {
+    Uniform,   // a = min bytes, b = max bytes
+    LogNormal, // a = median bytes, b = sigma
+};
+
+struct SynthRepoConfig {
+    fs::path root;
+    fs::path cache_dir; // mod_server's --cache-dir; empty = <temp>/gubsy_mod_server
+    std::uint32_t mods{100};
+    std::uint32_t files_min{4};
+    std::uint32_t files_max{32};
+    SizeDistribution size_dist{SizeDistribution::LogNormal};
+    double size_a{16 * 1024};
+    double size_b{1.5};
+    std::uint64_t size_cap{16ull * 1024 * 1024};
+    double changed_fraction{0.1}; // files that get an older version for delta updates
+    std::uint64_t seed{1};
+};
+
+// Parses "uniform:<min>:<max>" or "lognormal:<median>:<sigma>".
+bool parse_size_distribution(const std::string& spec, SynthRepoConfig& config, std::string& err);
+
+// Writes `<root>/mods/bench_NNNNN/{manifest.json,data/...}`. For a share of
+// the files large enough for deltas it also plants an older version in
+// `<cache_dir>/objects/`, where mod_server looks for delta bases, and lists
+// those files in `<root>/bench_updates.json` for the bench's partial-update
+// clients.
+bool generate_synth_repo(const SynthRepoConfig& config, std::string& err);
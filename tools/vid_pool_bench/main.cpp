@@ -0,0 +1,272 @@
+#include "engine/vid_pool.hpp"
+#include "engine/vid_soa_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <random>
+#include <string>
+#include <vector>
+
+// Micro-benchmark for VidPool. For each capacity it times filling the pool
+// (pre-allocated and growing chunk by chunk), release/acquire churn at half
+// occupancy, walking the active entries at 10% and 50% occupancy, and handle
+// lookups. A copy of the old linear-scan
+// pool runs the same churn and a full-capacity walk for comparison, and a
+// VidSoAPool with the same fields shows what a one-column walk costs.
+//
+//   vid_pool_bench [--seed=1] [--caps=1000,100000,1000000]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Payload {
+    float x{0.0f};
+    float y{0.0f};
+    std::uint32_t hp{0};
+};
+
+// The pool before the free list: acquire scans from slot 0, walks visit every slot.
+template <typename T>
+class ScanPool {
+  public:
+    struct Entry {
+        VID vid{};
+        bool active{false};
+        T value{};
+    };
+
+    explicit ScanPool(std::size_t capacity) : entries_(capacity) {
+        for (std::size_t i = 0; i < capacity; ++i)
+            entries_[i].vid.id = i;
+    }
+
+    Entry* acquire() {
+        for (auto& entry : entries_) {
+            if (!entry.active)
+                return take(entry);
+        }
+        return nullptr;
+    }
+
+    // Setup only: filling through acquire() would be quadratic.
+    Entry* acquire_slot(std::size_t slot) { return take(entries_[slot]); }
+
+    void release(VID vid) {
+        Entry& e = entries_[vid.id];
+        if (e.active && e.vid.version == vid.version) {
+            e.active = false;
+            e.vid.version += 1;
+        }
+    }
+
+    std::vector<Entry>& entries() { return entries_; }
+
+  private:
+    Entry* take(Entry& entry) {
+        entry.active = true;
+        entry.vid.version += 1;
+        entry.value = T{};
+        return &entry;
+    }
+
+    std::vector<Entry> entries_;
+};
+
+// Every pool here has room for what the bench asks of it, so running dry
+// is a bench bug, not something to time around.
+template <typename Pool>
+VID acquire_vid(Pool& pool) {
+    auto* entry = pool.acquire();
+    if (!entry) {
+        std::fprintf(stderr, "vid_pool_bench: pool ran out of slots\n");
+        std::abort();
+    }
+    return entry->vid;
+}
+
+VID take_next(VidPool<Payload>& pool, std::size_t) {
+    return acquire_vid(pool);
+}
+
+VID take_next(ScanPool<Payload>& pool, std::size_t slot) {
+    return pool.acquire_slot(slot)->vid;
+}
+
+double ns_per(Clock::duration d, std::size_t ops) {
+    if (ops == 0)
+        return 0.0;
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()) /
+           static_cast<double>(ops);
+}
+
+// Keeps results observable so loops are not optimized away.
+volatile float g_sink = 0.0f;
+
+// Fills to `live` entries, releasing random ones from a full pool.
+template <typename Pool>
+std::vector<VID> fill_to(Pool& pool, std::size_t capacity, std::size_t live, std::mt19937_64& rng) {
+    std::vector<VID> vids;
+    vids.reserve(capacity);
+    for (std::size_t i = 0; i < capacity; ++i)
+        vids.push_back(take_next(pool, i));
+    std::shuffle(vids.begin(), vids.end(), rng);
+    while (vids.size() > live) {
+        pool.release(vids.back());
+        vids.pop_back();
+    }
+    return vids;
+}
+
+template <typename Pool>
+double bench_churn(Pool& pool, std::vector<VID>& vids, std::size_t ops, std::mt19937_64& rng) {
+    std::uniform_int_distribution<std::size_t> pick(0, vids.size() - 1);
+    auto t0 = Clock::now();
+    for (std::size_t i = 0; i < ops; ++i) {
+        std::size_t k = pick(rng);
+        pool.release(vids[k]);
+        vids[k] = acquire_vid(pool);
+    }
+    return ns_per(Clock::now() - t0, ops);
+}
+
+double bench_walk(VidPool<Payload>& pool, int reps) {
+    auto t0 = Clock::now();
+    float sum = 0.0f;
+    for (int r = 0; r < reps; ++r) {
+        for (const auto& entry : pool.active())
+            sum += entry.value.x;
+    }
+    g_sink = sum;
+    return ns_per(Clock::now() - t0, static_cast<std::size_t>(reps));
+}
+
+using PayloadColumns = VidSoAPool<float, float, std::uint32_t>; // x, y, hp
+
+double bench_column_walk(PayloadColumns& pool, int reps) {
+    auto t0 = Clock::now();
+    float sum = 0.0f;
+    for (int r = 0; r < reps; ++r) {
+        for (float x : pool.column<0>())
+            sum += x;
+    }
+    g_sink = sum;
+    return ns_per(Clock::now() - t0, static_cast<std::size_t>(reps));
+}
+
+double bench_scan_walk(ScanPool<Payload>& pool, int reps) {
+    auto t0 = Clock::now();
+    float sum = 0.0f;
+    for (int r = 0; r < reps; ++r) {
+        for (const auto& entry : pool.entries()) {
+            if (entry.active)
+                sum += entry.value.x;
+        }
+    }
+    g_sink = sum;
+    return ns_per(Clock::now() - t0, static_cast<std::size_t>(reps));
+}
+
+void run_capacity(std::size_t capacity, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    const std::size_t ops = std::max<std::size_t>(capacity, 100000);
+    const int reps = static_cast<int>(std::max<std::size_t>(10, 20000000 / capacity));
+    std::printf("capacity %zu\n", capacity);
+
+    {
+        VidPool<Payload> pool(capacity);
+        auto t0 = Clock::now();
+        for (std::size_t i = 0; i < capacity; ++i)
+            pool.acquire();
+        std::printf("  %-28s %10.2f ns/op\n", "fill", ns_per(Clock::now() - t0, capacity));
+    }
+    {
+        VidPool<Payload> pool;
+        auto t0 = Clock::now();
+        for (std::size_t i = 0; i < capacity; ++i)
+            pool.acquire();
+        std::printf("  %-28s %10.2f ns/op\n", "fill, growing from empty", ns_per(Clock::now() - t0, capacity));
+    }
+
+    VidPool<Payload> pool(capacity);
+    std::vector<VID> vids = fill_to(pool, capacity, capacity / 2, rng);
+    std::printf("  %-28s %10.2f ns/op\n", "churn @50%", bench_churn(pool, vids, ops, rng));
+
+    std::uniform_int_distribution<std::size_t> pick(0, vids.size() - 1);
+    std::vector<VID> probes(ops);
+    for (auto& vid : probes)
+        vid = vids[pick(rng)];
+    auto t0 = Clock::now();
+    std::size_t found = 0;
+    for (const auto& vid : probes)
+        found += pool.find_entry(vid) ? 1u : 0u;
+    g_sink = static_cast<float>(found);
+    std::printf("  %-28s %10.2f ns/op\n", "find_entry", ns_per(Clock::now() - t0, ops));
+
+    std::printf("  %-28s %10.1f us\n", "walk active @50%", bench_walk(pool, reps) / 1000.0);
+    VidPool<Payload> sparse(capacity);
+    fill_to(sparse, capacity, capacity / 10, rng);
+    std::printf("  %-28s %10.1f us\n", "walk active @10%", bench_walk(sparse, reps) / 1000.0);
+
+    PayloadColumns columns(capacity);
+    std::vector<VID> column_vids;
+    column_vids.reserve(capacity);
+    for (std::size_t i = 0; i < capacity; ++i)
+        column_vids.push_back(columns.acquire());
+    std::shuffle(column_vids.begin(), column_vids.end(), rng);
+    for (std::size_t i = capacity / 2; i < capacity; ++i)
+        columns.release(column_vids[i]);
+    std::printf("  %-28s %10.1f us\n", "soa column walk @50%", bench_column_walk(columns, reps) / 1000.0);
+
+    // Old pool. Every acquire rescans from slot 0, so cap the op count.
+    ScanPool<Payload> scan(capacity);
+    std::vector<VID> scan_vids = fill_to(scan, capacity, capacity / 2, rng);
+    std::size_t scan_ops = std::min<std::size_t>(ops, 20000000 / capacity + 100);
+    std::printf("  %-28s %10.2f ns/op\n", "scan pool churn @50%", bench_churn(scan, scan_vids, scan_ops, rng));
+    std::printf("  %-28s %10.1f us\n", "scan pool walk @50%", bench_scan_walk(scan, reps) / 1000.0);
+}
+
+std::vector<std::size_t> parse_caps(const std::string& list) {
+    std::vector<std::size_t> caps;
+    std::size_t start = 0;
+    while (start <= list.size()) {
+        std::size_t comma = list.find(',', start);
+        std::string part = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        if (!part.empty())
+            caps.push_back(std::max<std::size_t>(2, std::stoull(part)));
+        if (comma == std::string::npos)
+            break;
+        start = comma + 1;
+    }
+    return caps;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t seed = 1;
+    std::vector<std::size_t> caps = {1000, 100000, 1000000};
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg.rfind("--seed=", 0) == 0) {
+                seed = std::stoull(arg.substr(7));
+            } else if (arg.rfind("--caps=", 0) == 0) {
+                caps = parse_caps(arg.substr(7));
+            } else {
+                std::fprintf(stderr, "usage: vid_pool_bench [--seed=1] [--caps=1000,100000,1000000]\n");
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::fprintf(stderr, "bad argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+    for (std::size_t capacity : caps)
+        run_capacity(capacity, seed);
+    return 0;
+}